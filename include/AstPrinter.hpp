@@ -7,15 +7,23 @@
 
 #include "Expr.hpp"
 
-class AstPrinter : public ExprVisitor {
+class AstPrinter : public ExprVisitor<std::string> {
    public:
-    std::any visitBinaryExpr(std::shared_ptr<Binary> expr) override;
-    std::any visitGroupingExpr(std::shared_ptr<Grouping> expr) override;
-    std::any visitLiteralExpr(std::shared_ptr<Literal> expr) override;
-    std::any visitUnaryExpr(std::shared_ptr<Unary> expr) override;
+    std::string visitAssignExpr(std::shared_ptr<Assign> expr);
+    std::string visitBinaryExpr(std::shared_ptr<Binary> expr);
+    std::string visitCallExpr(std::shared_ptr<Call> expr);
+    std::string visitGetExpr(std::shared_ptr<Get> expr);
+    std::string visitGroupingExpr(std::shared_ptr<Grouping> expr);
+    std::string visitLiteralExpr(std::shared_ptr<Literal> expr);
+    std::string visitLogicalExpr(std::shared_ptr<Logical> expr);
+    std::string visitSetExpr(std::shared_ptr<Set> expr);
+    std::string visitSuperExpr(std::shared_ptr<Super> expr);
+    std::string visitThisExpr(std::shared_ptr<This> expr);
+    std::string visitUnaryExpr(std::shared_ptr<Unary> expr);
+    std::string visitVariableExpr(std::shared_ptr<Variable> expr);
 
     std::string print(std::shared_ptr<Expr> expr) {
-        return std::any_cast<std::string>(expr->accept(*this));
+        return expr->accept(*this);
     }
 
    private:
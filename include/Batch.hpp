@@ -0,0 +1,39 @@
+#ifndef CPPLOX_INCLUDE_BATCH_HPP
+#define CPPLOX_INCLUDE_BATCH_HPP
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Outcome of running one script of a batch.
+ */
+struct BatchResult {
+    std::string path;
+    // Everything the script printed and every error it reported
+    std::string output;
+    std::string errors;
+    // 0 on success, 65 for syntax errors, 66 if the file couldn't be read and 70 for runtime and internal errors
+    int exitCode = 0;
+    std::chrono::duration<double, std::milli> elapsed{};
+};
+
+/**
+ * @brief Lists the scripts to run for a --batch argument.
+ *
+ * A directory yields every .lox file beneath it, sorted by path. Any other file is read as a list of script paths,
+ * one per line. Returns std::nullopt if the argument can't be read.
+ */
+std::optional<std::vector<std::string>> collectBatchScripts(const std::string&);
+
+/**
+ * @brief Runs each script in its own isolate on a work-stealing thread pool.
+ *
+ * Each script's output and errors are captured rather than printed, so the results, returned in the order of the
+ * given paths, can be shown without interleaving.
+ */
+std::vector<BatchResult> runBatch(const std::vector<std::string>&, size_t = std::thread::hardware_concurrency());
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef CPPLOX_INCLUDE_CPPLOX_HPP
+#define CPPLOX_INCLUDE_CPPLOX_HPP
+
+/*
+ * Public API of the cpplox embedding library.
+ *
+ *     Isolate isolate;
+ *     int calls = 0;
+ *     isolate.defineNative("twice", {ValueType::NUMBER}, [&calls](Interpreter&, std::span<const std::any> args) {
+ *         ++calls;
+ *         return std::any(2 * std::any_cast<double>(args[0]));
+ *     });
+ *
+ *     auto program = isolate.compile("fun area(w, h) { return twice(w * h) / 2; }");
+ *     if (program) {
+ *         isolate.run(program);
+ *         std::any area = isolate.call("area", {3.0, 4.0});
+ *     }
+ *
+ * Values cross the boundary as std::any holding double, std::string, bool, nullptr, or a std::shared_ptr to a
+ * LoxCallable, LoxInstance or NativeObject. Errors are reported to the isolate's error stream and flags.
+ */
+
+#include "Isolate.hpp"
+#include "LoxCallable.hpp"
+#include "NativeFunctions.hpp"
+#include "NativeObject.hpp"
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef CPPLOX_INCLUDE_CLOSUREANALYSIS_HPP
+#define CPPLOX_INCLUDE_CLOSUREANALYSIS_HPP
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Expr.hpp"
+#include "Program.hpp"
+#include "Stmt.hpp"
+
+/**
+ * @brief Finds the declaration of every local variable reference, mirroring the scopes of the Resolver, and which
+ * variables each function needs to capture from enclosing functions.
+ */
+class ClosureAnalysis : public ExprVisitor<void>, public StmtVisitor<void> {
+   public:
+    /// @brief A local variable, including the implicit "this" of each method and "super" of each subclass.
+    struct Slot {
+        std::string name;
+        size_t id;
+        // Function declaring the variable, or the owner of the top-level code
+        const void* owner;
+        // Whether a nested function refers to the variable
+        bool captured = false;
+        // Whether this is a method's "this"
+        bool receiver = false;
+    };
+
+    /// @brief Where each local variable is declared and which variables each function captures.
+    struct Closures {
+        std::deque<Slot> slots;
+        // Variables declared by Var, Function and Class statements and by parameters, keyed by node or token
+        std::map<const void*, Slot*> declarations;
+        std::map<const Class*, Slot*> supers;
+        std::map<const Function*, Slot*> receivers;
+        // Variable each local Variable, Assign, This and Super expression refers to; "this" of Super in thisOfSuper
+        std::map<const Expr*, Slot*> references;
+        std::map<const Super*, Slot*> thisOfSuper;
+        // Variables each function refers to from enclosing functions, in order of first use
+        std::map<const void*, std::vector<Slot*>> captures;
+    };
+
+    ClosureAnalysis(const ResolvedLocals& locals, Closures& closures) : locals(locals), closures(closures) {}
+
+    /// @brief Analyzes the given top-level statements, whose block-scoped variables belong to the given owner.
+    void analyze(const void*, const std::vector<std::shared_ptr<Stmt>>&);
+
+    void visitAssignExpr(std::shared_ptr<Assign>);
+    void visitBinaryExpr(std::shared_ptr<Binary>);
+    void visitCallExpr(std::shared_ptr<Call>);
+    void visitGetExpr(std::shared_ptr<Get>);
+    void visitGroupingExpr(std::shared_ptr<Grouping>);
+    void visitLiteralExpr(std::shared_ptr<Literal>);
+    void visitLogicalExpr(std::shared_ptr<Logical>);
+    void visitSetExpr(std::shared_ptr<Set>);
+    void visitSuperExpr(std::shared_ptr<Super>);
+    void visitThisExpr(std::shared_ptr<This>);
+    void visitUnaryExpr(std::shared_ptr<Unary>);
+    void visitVariableExpr(std::shared_ptr<Variable>);
+
+    void visitBlockStmt(std::shared_ptr<Block>);
+    void visitClassStmt(std::shared_ptr<Class>);
+    void visitExpressionStmt(std::shared_ptr<Expression>);
+    void visitForStmt(std::shared_ptr<For>);
+    void visitFunctionStmt(std::shared_ptr<Function>);
+    void visitIfStmt(std::shared_ptr<If>);
+    void visitImportStmt(std::shared_ptr<Import>);
+    void visitPrintStmt(std::shared_ptr<Print>);
+    void visitReturnStmt(std::shared_ptr<Return>);
+    void visitVarStmt(std::shared_ptr<Var>);
+    void visitWhileStmt(std::shared_ptr<While>);
+
+   private:
+    const ResolvedLocals& locals;
+    Closures& closures;
+    std::vector<std::map<std::string, Slot*>> scopes;
+    // Functions being analyzed, innermost last, starting with the owner of the top-level code
+    std::vector<const void*> functions;
+
+    void resolve(const std::vector<std::shared_ptr<Stmt>>&);
+    void resolve(const std::shared_ptr<Stmt>&);
+    void resolve(const std::shared_ptr<Expr>&);
+    void resolveFunction(const std::shared_ptr<Function>&);
+
+    /// @brief Declares a variable in the innermost scope. Returns nullptr for globals, which aren't tracked.
+    Slot* declare(const void*, const std::string&, const void*);
+    Slot* lookUp(size_t, const std::string&);
+    /// @brief Records the variable the given expression refers to, unless the Resolver left it global.
+    void reference(const std::shared_ptr<Expr>&, const std::string&);
+    /// @brief Captures the given variable in every function between the one using it and the one declaring it.
+    void use(Slot*);
+};
+
+#endif
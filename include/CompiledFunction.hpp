@@ -0,0 +1,47 @@
+#ifndef CPPLOX_INCLUDE_COMPILEDFUNCTION_HPP
+#define CPPLOX_INCLUDE_COMPILEDFUNCTION_HPP
+
+#include <any>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LoxFunction.hpp"
+
+/// @brief Storage of a local variable that outlives its scope because a closure captured it.
+struct Cell {
+    std::any value;
+};
+
+/**
+ * @brief A Lox function whose body was translated to C++ ahead of time by CppEmitter.
+ *
+ * The body is a plain C++ function receiving the called CompiledFunction, through which it reaches the cells of
+ * the variables it captured and, for methods, the instance the function is bound to.
+ */
+class CompiledFunction : public LoxFunction {
+   public:
+    using Body = std::any (*)(Interpreter&, CompiledFunction&, const std::vector<std::any>&);
+
+    CompiledFunction(const char* name, size_t arity, Body body, std::vector<std::shared_ptr<Cell>>&& captures, bool isInit)
+        : LoxFunction(isInit), captures(std::move(captures)), name(name), parameters(arity), body(body), isInitializer(isInit) {}
+
+    size_t arity() override { return parameters; }
+    std::any call(Interpreter&, const std::vector<std::any>&) override;
+    std::string toString() const override { return "<fn " + std::string(name) + ">"; }
+
+    std::shared_ptr<LoxFunction> bind(std::shared_ptr<LoxInstance>) override;
+
+    // Cells of the captured variables, in the order the body was emitted to expect them
+    const std::vector<std::shared_ptr<Cell>> captures;
+    // The instance a method is bound to, or an empty std::any
+    std::any receiver;
+
+   private:
+    const char* const name;
+    const size_t parameters;
+    const Body body;
+    const bool isInitializer;
+};
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef CPPLOX_INCLUDE_COMPILEDRUNTIME_HPP
+#define CPPLOX_INCLUDE_COMPILEDRUNTIME_HPP
+
+#include <any>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CompiledFunction.hpp"
+#include "Error.hpp"
+#include "Interpreter.hpp"
+#include "LoxCallable.hpp"
+#include "LoxClass.hpp"
+#include "LoxInstance.hpp"
+#include "NativeObject.hpp"
+#include "Token.hpp"
+#include "Util.hpp"
+
+/**
+ * @brief Operations used by C++ emitted by CppEmitter and by the RegisterVm.
+ *
+ * Each one performs what the matching Interpreter visitor does once its operands have been evaluated, with the
+ * same checks and error messages, so compiled programs behave exactly like interpreted ones.
+ */
+namespace compiled {
+
+inline bool truthy(const std::any& value) {
+    return Interpreter::isTruthy(value);
+}
+
+inline void checkNumberOperand(const Token& op, const std::any& operand) {
+    if (operand.type() != typeid(double)) {
+        throw RuntimeError(op, "Operand must be a number.");
+    }
+}
+inline void checkNumberOperands(const Token& op, const std::any& left, const std::any& right) {
+    checkNumberOperand(op, left);
+    checkNumberOperand(op, right);
+}
+
+inline std::any greater(const Token& op, const std::any& left, const std::any& right) {
+    checkNumberOperand(op, left);
+    return std::any_cast<double>(left) > std::any_cast<double>(right);
+}
+inline std::any greaterEqual(const std::any& left, const std::any& right) {
+    return std::any_cast<double>(left) >= std::any_cast<double>(right);
+}
+inline std::any less(const std::any& left, const std::any& right) {
+    return std::any_cast<double>(left) < std::any_cast<double>(right);
+}
+inline std::any lessEqual(const std::any& left, const std::any& right) {
+    return std::any_cast<double>(left) <= std::any_cast<double>(right);
+}
+inline std::any equal(const std::any& left, const std::any& right) {
+    return Interpreter::isEqual(left, right);
+}
+inline std::any notEqual(const std::any& left, const std::any& right) {
+    return !Interpreter::isEqual(left, right);
+}
+
+inline std::any add(Interpreter& interpreter, const Token& op, const std::any& left, const std::any& right) {
+    if (left.type() == typeid(double) && right.type() == typeid(double)) {
+        return std::any_cast<double>(left) + std::any_cast<double>(right);
+    }
+    else if (left.type() == typeid(std::string) && right.type() == typeid(std::string)) {
+        return std::any_cast<const std::string&>(left) + std::any_cast<const std::string&>(right);
+    }
+    else if (left.type() == typeid(std::string)) {
+        return std::any_cast<const std::string&>(left) + interpreter.stringify(right);
+    }
+    else if (right.type() == typeid(std::string)) {
+        return interpreter.stringify(left) + std::any_cast<const std::string&>(right);
+    }
+    throw RuntimeError(op, "Operands must be two numbers or strings. Got: " + std::string(left.type().name()) + " and " +
+                               std::string(right.type().name()));
+}
+inline std::any subtract(const Token& op, const std::any& left, const std::any& right) {
+    checkNumberOperands(op, left, right);
+    return std::any_cast<double>(left) - std::any_cast<double>(right);
+}
+inline std::any multiply(const Token& op, const std::any& left, const std::any& right) {
+    checkNumberOperands(op, left, right);
+    return std::any_cast<double>(left) * std::any_cast<double>(right);
+}
+inline std::any divide(const Token& op, const std::any& left, const std::any& right) {
+    checkNumberOperands(op, left, right);
+    if (std::any_cast<double>(right) == 0) {
+        throw RuntimeError(op, "Cannot divide by zero.");
+    }
+    return std::any_cast<double>(left) / std::any_cast<double>(right);
+}
+
+inline std::any negate(const Token& op, const std::any& right) {
+    checkNumberOperand(op, right);
+    return -std::any_cast<double>(right);
+}
+inline std::any logicalNot(const std::any& right) {
+    return !Interpreter::isTruthy(right);
+}
+
+inline std::any call(Interpreter& interpreter, const Token& paren, const std::any& callee, const std::vector<std::any>& arguments) {
+    std::shared_ptr<LoxCallable> function = ptrAnyCast<LoxCallable>(callee);
+    if (!function) {
+        throw RuntimeError(paren, "Can only call functions and classes.");
+    }
+
+    if (arguments.size() != function->arity()) {
+        throw RuntimeError(paren, "Expected " + std::to_string(function->arity()) + " arguments but got " +
+                                      std::to_string(arguments.size()) + ".");
+    }
+
+    try {
+        return function->call(interpreter, arguments);
+    }
+    catch (NativeError& error) {
+        throw RuntimeError(paren, error.what());
+    }
+}
+
+inline std::any get(const Token& name, const std::any& object) {
+    if (auto instance = ptrAnyCast<LoxInstance>(object)) {
+        return instance->get(name);
+    }
+    else if (auto native = ptrAnyCast<NativeObject>(object)) {
+        return native->get(name);
+    }
+    throw RuntimeError(name, "Only instances have properties.");
+}
+/// @brief Returns the instance a field is about to be set on. Checked before the assigned value is evaluated.
+inline std::shared_ptr<LoxInstance> fieldTarget(const Token& name, const std::any& object) {
+    auto instance = ptrAnyCast<LoxInstance>(object);
+    if (!instance) {
+        throw RuntimeError(name, "Only instances have fields.");
+    }
+    return instance;
+}
+inline std::any superMethod(const Token& method, const std::any& superclassValue, const std::any& object) {
+    auto superclass = callableAnyCast<LoxClass>(superclassValue);
+    auto function = superclass->findMethod(method.lexeme);
+    if (function == nullptr) {
+        throw RuntimeError(method, "Undefined property '" + method.lexeme + "'.");
+    }
+    return std::shared_ptr<LoxCallable>(function->bind(ptrAnyCast<LoxInstance>(object)));
+}
+
+inline void print(Interpreter& interpreter, const std::any& value) {
+    Output& output = interpreter.getOutput();
+    output.write(interpreter.stringify(value));
+    output.write("\n");
+}
+
+/**
+ * @brief A global variable referred to by compiled code, whose storage is looked up once and then cached.
+ *
+ * Compiled programs run a single interpreter, so the cache never has to be invalidated.
+ */
+class GlobalSlot {
+   public:
+    explicit GlobalSlot(const char* name) : name(name) {}
+
+    std::any& get(Interpreter& interpreter, const Token& token) {
+        if (slot == nullptr && (slot = interpreter.findGlobal(name)) == nullptr) {
+            throw RuntimeError(token, "Undefined variable '" + token.lexeme + "'.");
+        }
+        return *slot;
+    }
+    void assign(Interpreter& interpreter, const Token& token, const std::any& value) {
+        get(interpreter, token) = value;
+    }
+    void define(Interpreter& interpreter, const std::any& value) {
+        if (slot == nullptr) {
+            interpreter.defineGlobal(name, value);
+            slot = interpreter.findGlobal(name);
+        }
+        else {
+            *slot = value;
+        }
+    }
+
+   private:
+    const char* const name;
+    std::any* slot = nullptr;
+};
+
+/// @brief Runs a compiled program's top-level code in a fresh isolate, then lets its tasks finish. Returns the exit
+/// code the CLI would have for the same script.
+int run(void (*)(Interpreter&));
+
+}  // namespace compiled
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef CPPLOX_INCLUDE_COROUTINE_HPP
+#define CPPLOX_INCLUDE_COROUTINE_HPP
+
+#include <cstddef>
+
+#ifndef _WIN32
+#include <ucontext.h>
+#endif
+
+/**
+ * @brief A stackful execution context that can be suspended and resumed.
+ *
+ * The tree-walking interpreter keeps its state on the C++ stack, so suspending a Lox task means suspending that
+ * whole stack. Each coroutine therefore owns a separate stack, and switching between coroutines swaps stacks and
+ * registers (ucontext on POSIX, fibers on Windows).
+ *
+ * Coroutines belong to the thread that created them and must only be switched on that thread.
+ */
+class Coroutine {
+   public:
+    using Entry = void (*)(void*);
+
+    // Matches the usual main thread stack, so tasks can recurse as deeply as the main program; pages are only
+    // committed as they are touched
+    static constexpr size_t defaultStackSize = 8 * 1024 * 1024;
+
+    /// @brief Wraps the calling thread's own context, so it can be switched away from and back to.
+    Coroutine();
+    /// @brief Creates a coroutine that will call the given function with the given argument when first switched to.
+    /// The function must never return; it must end by switching to another coroutine.
+    Coroutine(Entry, void*, size_t = defaultStackSize);
+    ~Coroutine();
+
+    Coroutine(const Coroutine&) = delete;
+    Coroutine& operator=(const Coroutine&) = delete;
+
+    /// @brief Suspends the calling context, which must be this coroutine, and resumes the given one.
+    void switchTo(Coroutine&);
+
+   private:
+    Entry entry = nullptr;
+    void* argument = nullptr;
+
+#ifdef _WIN32
+    void* fiber = nullptr;
+    // Whether the constructor turned the thread into a fiber and the destructor must turn it back
+    bool convertedThread = false;
+
+    static void __stdcall start(void*);
+#else
+    ucontext_t context;
+    void* stack = nullptr;
+    size_t stackSize = 0;
+
+    static void start();
+#endif
+};
+
+#endif
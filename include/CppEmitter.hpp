@@ -0,0 +1,118 @@
+#ifndef CPPLOX_INCLUDE_CPPEMITTER_HPP
+#define CPPLOX_INCLUDE_CPPEMITTER_HPP
+
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ClosureAnalysis.hpp"
+#include "Expr.hpp"
+#include "Program.hpp"
+#include "Stmt.hpp"
+
+/**
+ * @brief Translates a resolved program and the modules it imports into a standalone C++ translation unit.
+ *
+ * The emitted code links against the cpplox library and includes CompiledRuntime.hpp, keeps values as std::any
+ * and performs every operation through the same runtime checks as Interpreter, so output, runtime errors and their
+ * line numbers are identical. Global variables stay late-bound in the interpreter's globals, which also hold the
+ * natives. Local variables become C++ locals, or shared cells when a closure captures them, and functions become
+ * CompiledFunctions whose bodies are plain C++ functions.
+ */
+class CppEmitter : public ExprVisitor<std::string>, public StmtVisitor<void> {
+   public:
+    explicit CppEmitter(std::shared_ptr<const Program>);
+
+    /// @brief Returns the C++ source of the program. The given name of the script appears in a header comment.
+    std::string emit(const std::string&);
+
+    std::string visitAssignExpr(std::shared_ptr<Assign>);
+    std::string visitBinaryExpr(std::shared_ptr<Binary>);
+    std::string visitCallExpr(std::shared_ptr<Call>);
+    std::string visitGetExpr(std::shared_ptr<Get>);
+    std::string visitGroupingExpr(std::shared_ptr<Grouping>);
+    std::string visitLiteralExpr(std::shared_ptr<Literal>);
+    std::string visitLogicalExpr(std::shared_ptr<Logical>);
+    std::string visitSetExpr(std::shared_ptr<Set>);
+    std::string visitSuperExpr(std::shared_ptr<Super>);
+    std::string visitThisExpr(std::shared_ptr<This>);
+    std::string visitUnaryExpr(std::shared_ptr<Unary>);
+    std::string visitVariableExpr(std::shared_ptr<Variable>);
+
+    void visitBlockStmt(std::shared_ptr<Block>);
+    void visitClassStmt(std::shared_ptr<Class>);
+    void visitExpressionStmt(std::shared_ptr<Expression>);
+    void visitForStmt(std::shared_ptr<For>);
+    void visitFunctionStmt(std::shared_ptr<Function>);
+    void visitIfStmt(std::shared_ptr<If>);
+    void visitImportStmt(std::shared_ptr<Import>);
+    void visitPrintStmt(std::shared_ptr<Print>);
+    void visitReturnStmt(std::shared_ptr<Return>);
+    void visitVarStmt(std::shared_ptr<Var>);
+    void visitWhileStmt(std::shared_ptr<While>);
+
+    // A captured variable lives in a Cell, and a method's "this" is held by the bound CompiledFunction
+    using Slot = ClosureAnalysis::Slot;
+    using Closures = ClosureAnalysis::Closures;
+
+   private:
+    const std::shared_ptr<const Program> program;
+    ResolvedLocals locals;
+    ResolvedImports imports;
+    std::map<std::string, size_t> moduleIndices;
+    Closures closures;
+
+    // Translation unit sections
+    std::ostringstream constants;
+    std::ostringstream prototypes;
+    std::ostringstream definitions;
+    std::map<std::string, std::string> tokenNames;
+    std::map<std::string, std::string> globalNames;
+    std::map<std::string, std::string> stringNames;
+    size_t functionCount = 0;
+    size_t tempCount = 0;
+
+    // Function being emitted
+    const void* owner = nullptr;
+    std::ostringstream* body = nullptr;
+    size_t indent = 0;
+
+    /// @brief Emits a C++ function running the given top-level statements.
+    void emitTopLevel(const std::string&, const void*, const std::vector<std::shared_ptr<Stmt>>&);
+    /// @brief Emits the body of the given function or method. Returns the name of the C++ function.
+    std::string emitFunction(const std::shared_ptr<Function>&, bool);
+    /// @brief Returns an expression creating a CompiledFunction for the given function or method.
+    std::string closure(const std::shared_ptr<Function>&, bool);
+
+    /// @brief Emits the statements computing the given expression, returning a C++ expression of its value.
+    std::string evaluate(const std::shared_ptr<Expr>&);
+    /// @brief Emits a temporary holding the given value unless it already is one. Returns the temporary.
+    std::string materialize(const std::string&);
+    /// @brief Returns the given value, moved from if it is a temporary, which is only ever used once.
+    std::string take(const std::string&) const;
+    std::string temp();
+
+    void line(const std::string&);
+    void open(const std::string&);
+    void close(const std::string& = "}");
+    void execute(const std::shared_ptr<Stmt>&);
+
+    /// @brief Returns the C++ expression naming the value of the given local variable.
+    std::string access(const Slot*);
+    /// @brief Returns the C++ expression naming the Cell of the given captured variable.
+    std::string cell(const Slot*);
+    /// @brief Emits the declaration of the given local variable, initialized to the given value.
+    void declare(const Slot*, const std::string&);
+    std::string variable(const Slot*) const;
+
+    /// @brief Returns the name of a constant Token with the given token's type, lexeme and line.
+    std::string token(const Token&);
+    /// @brief Returns the name of the GlobalSlot of the given global variable.
+    std::string global(const std::string&);
+    /// @brief Returns the name of a constant std::any holding the given string.
+    std::string string(const std::string&);
+};
+
+#endif
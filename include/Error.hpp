@@ -7,14 +7,40 @@
 
 #include "Token.hpp"
 
-extern bool hadError;
-extern bool hadRuntimeError;
+/// @brief Error flags and error stream of one isolate.
+struct ErrorState {
+    bool hadError = false;
+    bool hadRuntimeError = false;
+    std::ostream* stream = &std::cerr;
+};
+
+/// @brief Returns the error state of the isolate running on the calling thread, or a per-thread default if there is none.
+ErrorState& errorState();
+
+/// @brief Makes the given ErrorState current on the calling thread for the lifetime of the scope.
+class ErrorScope {
+   public:
+    ErrorScope(ErrorState&);
+    ~ErrorScope();
+
+    ErrorScope(const ErrorScope&) = delete;
+    ErrorScope& operator=(const ErrorScope&) = delete;
+
+   private:
+    ErrorState* previous;
+};
 
 class ParseError : public std::runtime_error {
    public:
     using std::runtime_error::runtime_error;
 };
 
+/// @brief Error raised by native code, which has no token to report. Converted to a RuntimeError at the call site.
+class NativeError : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
+
 class RuntimeError : public std::runtime_error {
    public:
     RuntimeError(const Token& tok, const std::string& msg) : std::runtime_error(msg), token(tok) {}
@@ -30,8 +56,9 @@ class RuntimeError : public std::runtime_error {
  * @param message: Error message to display.
  */
 inline void report(size_t line, std::string_view where, std::string_view message) {
-    std::cerr << "[line " << line << "] Error" << where << ": " << message << std::endl;
-    hadError = true;
+    ErrorState& state = errorState();
+    *state.stream << "[line " << line << "] Error" << where << ": " << message << std::endl;
+    state.hadError = true;
 }
 
 /**
@@ -58,8 +85,9 @@ inline void error(const Token& token, std::string_view message) {
  * @brief Reports a runtime error.
  */
 inline void runtimeError(RuntimeError error) {
-    std::cerr << error.what() << "\n[line " << error.token.line << "]" << std::endl;
-    hadRuntimeError = true;
+    ErrorState& state = errorState();
+    *state.stream << error.what() << "\n[line " << error.token.line << "]" << std::endl;
+    state.hadRuntimeError = true;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef CPPLOX_INCLUDE_ESCAPEANALYSIS_HPP
+#define CPPLOX_INCLUDE_ESCAPEANALYSIS_HPP
+
+#include <any>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ClosureAnalysis.hpp"
+#include "Expr.hpp"
+#include "Program.hpp"
+#include "Stmt.hpp"
+
+/// @brief Value of a variable whose instance was scalar replaced, whose fields are variables of its environment.
+struct ScalarReplaced {};
+
+/// @brief A local variable initialized with a new instance that never escapes, so it can be scalar replaced.
+struct ScalarSite {
+    /// @brief A field set by the class's initializer, from an argument or a constant.
+    struct Field {
+        // Name of the variable holding the field, "<variable>.<field>", which no identifier can clash with
+        std::string key;
+        size_t argument;
+        std::any constant;
+    };
+    static constexpr size_t noArgument = static_cast<size_t>(-1);
+
+    // The class the callee has to be for the instance to be scalar replaced; anything else is called as usual.
+    // Not owning, since the class belongs to the same program as the site.
+    const Class* klass;
+    // Fields in the order the initializer sets them
+    std::vector<Field> fields;
+};
+
+/// @brief A field access on a variable that may hold a scalar replaced instance.
+struct ScalarAccess {
+    // Number of scopes between the access and the variable, as resolved
+    size_t depth;
+    std::string variable;
+    std::string key;
+};
+
+/**
+ * @brief Finds instances that never escape the variable they are created for, so they can be scalar replaced.
+ *
+ * A site is a local variable declared as `var v = C(...)`, where C names a top-level class without a superclass
+ * whose initializer only sets fields of this to its parameters or to constants. The instance doesn't escape if
+ * the variable is never reassigned or captured and is only used to get and set fields that aren't methods, since
+ * its identity is then never observed. The Interpreter then keeps the fields as variables of the scope instead of
+ * creating the instance, provided the callee turns out to be that class when the declaration runs.
+ */
+class EscapeAnalysis : public ExprVisitor<void>, public StmtVisitor<void> {
+   public:
+    explicit EscapeAnalysis(const ResolvedLocals& locals) : locals(locals) {}
+
+    /// @brief Marks the scalar replaceable sites of the given top-level statements and their field accesses.
+    void analyze(const std::vector<std::shared_ptr<Stmt>>&);
+
+    void visitAssignExpr(std::shared_ptr<Assign>);
+    void visitBinaryExpr(std::shared_ptr<Binary>);
+    void visitCallExpr(std::shared_ptr<Call>);
+    void visitGetExpr(std::shared_ptr<Get>);
+    void visitGroupingExpr(std::shared_ptr<Grouping>);
+    void visitLiteralExpr(std::shared_ptr<Literal>);
+    void visitLogicalExpr(std::shared_ptr<Logical>);
+    void visitSetExpr(std::shared_ptr<Set>);
+    void visitSuperExpr(std::shared_ptr<Super>);
+    void visitThisExpr(std::shared_ptr<This>);
+    void visitUnaryExpr(std::shared_ptr<Unary>);
+    void visitVariableExpr(std::shared_ptr<Variable>);
+
+    void visitBlockStmt(std::shared_ptr<Block>);
+    void visitClassStmt(std::shared_ptr<Class>);
+    void visitExpressionStmt(std::shared_ptr<Expression>);
+    void visitForStmt(std::shared_ptr<For>);
+    void visitFunctionStmt(std::shared_ptr<Function>);
+    void visitIfStmt(std::shared_ptr<If>);
+    void visitImportStmt(std::shared_ptr<Import>);
+    void visitPrintStmt(std::shared_ptr<Print>);
+    void visitReturnStmt(std::shared_ptr<Return>);
+    void visitVarStmt(std::shared_ptr<Var>);
+    void visitWhileStmt(std::shared_ptr<While>);
+
+   private:
+    using Slot = ClosureAnalysis::Slot;
+
+    /// @brief A variable initialized with a new instance, and every use of it seen so far.
+    struct Candidate {
+        std::shared_ptr<Var> declaration;
+        std::shared_ptr<ScalarSite> site;
+        std::set<std::string> methods;
+        bool escapes = false;
+        std::vector<std::shared_ptr<Get>> gets;
+        std::vector<std::shared_ptr<Set>> sets;
+    };
+
+    const ResolvedLocals& locals;
+    ClosureAnalysis::Closures closures;
+    // Top-level classes whose instances can be scalar replaced by name, or nullptr where a name is declared twice
+    std::map<std::string, std::shared_ptr<Class>> classes;
+    std::map<const Slot*, Candidate> candidates;
+
+    void resolve(const std::vector<std::shared_ptr<Stmt>>&);
+    void resolve(const std::shared_ptr<Stmt>&);
+    void resolve(const std::shared_ptr<Expr>&);
+
+    /// @brief Returns the candidate the given expression refers to, if it is a Variable referring to one.
+    Candidate* candidateOf(const std::shared_ptr<Expr>&);
+    /// @brief Returns the fields the initializer of the given class sets, or std::nullopt if it does anything else.
+    std::optional<std::vector<ScalarSite::Field>> initializedFields(const Class&, const std::string&) const;
+};
+
+#endif
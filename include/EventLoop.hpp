@@ -0,0 +1,80 @@
+#ifndef CPPLOX_INCLUDE_EVENTLOOP_HPP
+#define CPPLOX_INCLUDE_EVENTLOOP_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+class LoxTask;
+class Scheduler;
+
+/**
+ * @brief Timers and file descriptor readiness that tasks can block on.
+ *
+ * A task waiting for a timer or a file descriptor is suspended and handed to the event loop, which resumes it once
+ * the wait is over. The scheduler polls the loop whenever no task is runnable. File descriptors are watched with
+ * epoll, so waiting on them is only supported on Linux; timers work everywhere.
+ */
+class EventLoop {
+   public:
+    explicit EventLoop(Scheduler&);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /// @brief Suspends the running task for the given number of milliseconds.
+    void sleep(double);
+    /// @brief Suspends the running task until the given file descriptor is readable, or returns at once if it can't
+    /// be watched, e.g. because it is a regular file.
+    void waitReadable(int);
+    /// @brief Suspends the running task until the given file descriptor is writable, with the same caveat.
+    void waitWritable(int);
+    /// @brief Resumes every task waiting on the given file descriptor and stops watching it, e.g. before closing it.
+    void forget(int);
+
+    /// @brief Returns whether any task is waiting on the event loop.
+    bool pending() const { return !timers.empty() || !watches.empty(); }
+    /// @brief Resumes the tasks whose waits are over. If the given flag is set and none are, first blocks until one is.
+    void poll(bool);
+    /// @brief Stops waiting for anything and returns the tasks that were waiting, without resuming them.
+    std::vector<std::shared_ptr<LoxTask>> clear();
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        Clock::time_point deadline;
+        // Orders timers with the same deadline by creation
+        uint64_t sequence;
+        std::shared_ptr<LoxTask> task;
+
+        bool operator>(const Timer& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    struct Watch {
+        std::shared_ptr<LoxTask> reader;
+        std::shared_ptr<LoxTask> writer;
+    };
+
+    Scheduler& scheduler;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers;
+    uint64_t nextSequence = 0;
+    int epollFd = -1;
+    std::unordered_map<int, Watch> watches;
+
+    /// @brief Suspends the running task until the given file descriptor is ready for reading or writing.
+    void wait(int, bool);
+    /// @brief Registers interest in the given file descriptor according to its watch, returning false if epoll refused.
+    bool update(int);
+    /// @brief Resumes the tasks of timers that have expired.
+    void expireTimers();
+};
+
+#endif
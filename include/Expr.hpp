@@ -3,6 +3,7 @@
 
 #include <any>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "../include/Token.hpp"
@@ -19,35 +20,47 @@ class Super;
 class This;
 class Unary;
 class Variable;
-
+struct InlineSite;
+struct ScalarAccess;
+struct PropertyCache;
+struct SuperSite;
+
+/// @brief The class of a node, which visits dispatch on.
+enum class ExprKind { ASSIGN, BINARY, CALL, GET, GROUPING, LITERAL, LOGICAL, SET, SUPER, THIS, UNARY, VARIABLE };
+
+/**
+ * @brief Base of visitors whose visit methods, visit<Kind>Expr for each kind of node, all return R.
+ *
+ * Nodes dispatch on their kind rather than through virtual calls, and return the result without boxing it.
+ */
+template <typename R>
 struct ExprVisitor {
-    virtual std::any visitAssignExpr(std::shared_ptr<Assign> expr) = 0;
-    virtual std::any visitBinaryExpr(std::shared_ptr<Binary> expr) = 0;
-    virtual std::any visitCallExpr(std::shared_ptr<Call> expr) = 0;
-    virtual std::any visitGetExpr(std::shared_ptr<Get> expr) = 0;
-    virtual std::any visitGroupingExpr(std::shared_ptr<Grouping> expr) = 0;
-    virtual std::any visitLiteralExpr(std::shared_ptr<Literal> expr) = 0;
-    virtual std::any visitLogicalExpr(std::shared_ptr<Logical> expr) = 0;
-    virtual std::any visitSetExpr(std::shared_ptr<Set> expr) = 0;
-    virtual std::any visitSuperExpr(std::shared_ptr<Super> expr) = 0;
-    virtual std::any visitThisExpr(std::shared_ptr<This> expr) = 0;
-    virtual std::any visitUnaryExpr(std::shared_ptr<Unary> expr) = 0;
-    virtual std::any visitVariableExpr(std::shared_ptr<Variable> expr) = 0;
-    virtual ~ExprVisitor() = default;
+    using ExprResult = R;
 };
 
+/// @brief The type every value of an expression is proven to have, or UNKNOWN.
+enum class StaticType { UNKNOWN, NUMBER, STRING, BOOL, NIL };
+
 class Expr {
    public:
-    virtual std::any accept(ExprVisitor& visitor) = 0;
+    virtual ~Expr() = default;
+
+    /// @brief Calls the visit method of the given visitor for this node's kind, returning its result.
+    template <typename Visitor>
+    typename Visitor::ExprResult accept(Visitor& visitor);
+
+    const ExprKind kind;
+
+    // Set by TypeInference before the expression is first evaluated
+    StaticType type = StaticType::UNKNOWN;
+
+   protected:
+    explicit Expr(ExprKind kind) : kind(kind) {}
 };
 
 class Assign : public Expr, public std::enable_shared_from_this<Assign> {
    public:
-    Assign(const Token& name, std::shared_ptr<Expr> value) : name(name), value(value) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitAssignExpr(shared_from_this());
-    }
+    Assign(const Token& name, std::shared_ptr<Expr> value) : Expr(ExprKind::ASSIGN), name(name), value(value) {}
 
     const Token name;
     const std::shared_ptr<Expr> value;
@@ -55,11 +68,7 @@ class Assign : public Expr, public std::enable_shared_from_this<Assign> {
 
 class Binary : public Expr, public std::enable_shared_from_this<Binary> {
    public:
-    Binary(std::shared_ptr<Expr> left, const Token& oper, std::shared_ptr<Expr> right) : left(left), oper(oper), right(right) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitBinaryExpr(shared_from_this());
-    }
+    Binary(std::shared_ptr<Expr> left, const Token& oper, std::shared_ptr<Expr> right) : Expr(ExprKind::BINARY), left(left), oper(oper), right(right) {}
 
     const std::shared_ptr<Expr> left;
     const Token oper;
@@ -68,58 +77,45 @@ class Binary : public Expr, public std::enable_shared_from_this<Binary> {
 
 class Call : public Expr, public std::enable_shared_from_this<Call> {
    public:
-    Call(std::shared_ptr<Expr> callee, const Token& paren, const std::vector<std::shared_ptr<Expr>>& arguments) : callee(callee), paren(paren), arguments(arguments) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitCallExpr(shared_from_this());
-    }
+    Call(std::shared_ptr<Expr> callee, const Token& paren, const std::vector<std::shared_ptr<Expr>>& arguments) : Expr(ExprKind::CALL), callee(callee), paren(paren), arguments(arguments) {}
 
     const std::shared_ptr<Expr> callee;
     const Token paren;
     const std::vector<std::shared_ptr<Expr>> arguments;
+
+    // Filled in by optimization passes
+    std::shared_ptr<InlineSite> inlined;
 };
 
 class Get : public Expr, public std::enable_shared_from_this<Get> {
    public:
-    Get(std::shared_ptr<Expr> object, const Token& name) : object(object), name(name) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitGetExpr(shared_from_this());
-    }
+    Get(std::shared_ptr<Expr> object, const Token& name) : Expr(ExprKind::GET), object(object), name(name) {}
 
     const std::shared_ptr<Expr> object;
     const Token name;
+
+    // Filled in by optimization passes
+    std::shared_ptr<ScalarAccess> scalar;
+    std::shared_ptr<PropertyCache> cache;
 };
 
 class Grouping : public Expr, public std::enable_shared_from_this<Grouping> {
    public:
-    Grouping(std::shared_ptr<Expr> expression) : expression(expression) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitGroupingExpr(shared_from_this());
-    }
+    Grouping(std::shared_ptr<Expr> expression) : Expr(ExprKind::GROUPING), expression(expression) {}
 
     const std::shared_ptr<Expr> expression;
 };
 
 class Literal : public Expr, public std::enable_shared_from_this<Literal> {
    public:
-    Literal(std::any value) : value(value) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitLiteralExpr(shared_from_this());
-    }
+    Literal(std::any value) : Expr(ExprKind::LITERAL), value(value) {}
 
     const std::any value;
 };
 
 class Logical : public Expr, public std::enable_shared_from_this<Logical> {
    public:
-    Logical(std::shared_ptr<Expr> left, const Token& oper, std::shared_ptr<Expr> right) : left(left), oper(oper), right(right) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitLogicalExpr(shared_from_this());
-    }
+    Logical(std::shared_ptr<Expr> left, const Token& oper, std::shared_ptr<Expr> right) : Expr(ExprKind::LOGICAL), left(left), oper(oper), right(right) {}
 
     const std::shared_ptr<Expr> left;
     const Token oper;
@@ -128,47 +124,38 @@ class Logical : public Expr, public std::enable_shared_from_this<Logical> {
 
 class Set : public Expr, public std::enable_shared_from_this<Set> {
    public:
-    Set(std::shared_ptr<Expr> object, const Token& name, std::shared_ptr<Expr> value) : object(object), name(name), value(value) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitSetExpr(shared_from_this());
-    }
+    Set(std::shared_ptr<Expr> object, const Token& name, std::shared_ptr<Expr> value) : Expr(ExprKind::SET), object(object), name(name), value(value) {}
 
     const std::shared_ptr<Expr> object;
     const Token name;
     const std::shared_ptr<Expr> value;
+
+    // Filled in by optimization passes
+    std::shared_ptr<ScalarAccess> scalar;
+    std::shared_ptr<PropertyCache> cache;
 };
 
 class Super : public Expr, public std::enable_shared_from_this<Super> {
    public:
-    Super(const Token& keyword, const Token& method) : keyword(keyword), method(method) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitSuperExpr(shared_from_this());
-    }
+    Super(const Token& keyword, const Token& method) : Expr(ExprKind::SUPER), keyword(keyword), method(method) {}
 
     const Token keyword;
     const Token method;
+
+    // Filled in by optimization passes
+    std::shared_ptr<SuperSite> site;
 };
 
 class This : public Expr, public std::enable_shared_from_this<This> {
    public:
-    This(const Token& keyword) : keyword(keyword) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitThisExpr(shared_from_this());
-    }
+    This(const Token& keyword) : Expr(ExprKind::THIS), keyword(keyword) {}
 
     const Token keyword;
 };
 
 class Unary : public Expr, public std::enable_shared_from_this<Unary> {
    public:
-    Unary(const Token& oper, std::shared_ptr<Expr> right) : oper(oper), right(right) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitUnaryExpr(shared_from_this());
-    }
+    Unary(const Token& oper, std::shared_ptr<Expr> right) : Expr(ExprKind::UNARY), oper(oper), right(right) {}
 
     const Token oper;
     const std::shared_ptr<Expr> right;
@@ -176,13 +163,40 @@ class Unary : public Expr, public std::enable_shared_from_this<Unary> {
 
 class Variable : public Expr, public std::enable_shared_from_this<Variable> {
    public:
-    Variable(const Token& name) : name(name) {}
-
-    std::any accept(ExprVisitor& visitor) override {
-        return visitor.visitVariableExpr(shared_from_this());
-    }
+    Variable(const Token& name) : Expr(ExprKind::VARIABLE), name(name) {}
 
     const Token name;
 };
 
+template <typename Visitor>
+typename Visitor::ExprResult Expr::accept(Visitor& visitor) {
+    switch (kind) {
+        case ExprKind::ASSIGN:
+            return visitor.visitAssignExpr(static_cast<Assign*>(this)->shared_from_this());
+        case ExprKind::BINARY:
+            return visitor.visitBinaryExpr(static_cast<Binary*>(this)->shared_from_this());
+        case ExprKind::CALL:
+            return visitor.visitCallExpr(static_cast<Call*>(this)->shared_from_this());
+        case ExprKind::GET:
+            return visitor.visitGetExpr(static_cast<Get*>(this)->shared_from_this());
+        case ExprKind::GROUPING:
+            return visitor.visitGroupingExpr(static_cast<Grouping*>(this)->shared_from_this());
+        case ExprKind::LITERAL:
+            return visitor.visitLiteralExpr(static_cast<Literal*>(this)->shared_from_this());
+        case ExprKind::LOGICAL:
+            return visitor.visitLogicalExpr(static_cast<Logical*>(this)->shared_from_this());
+        case ExprKind::SET:
+            return visitor.visitSetExpr(static_cast<Set*>(this)->shared_from_this());
+        case ExprKind::SUPER:
+            return visitor.visitSuperExpr(static_cast<Super*>(this)->shared_from_this());
+        case ExprKind::THIS:
+            return visitor.visitThisExpr(static_cast<This*>(this)->shared_from_this());
+        case ExprKind::UNARY:
+            return visitor.visitUnaryExpr(static_cast<Unary*>(this)->shared_from_this());
+        case ExprKind::VARIABLE:
+            return visitor.visitVariableExpr(static_cast<Variable*>(this)->shared_from_this());
+    }
+    std::unreachable();
+}
+
 #endif
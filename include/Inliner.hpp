@@ -0,0 +1,86 @@
+#ifndef CPPLOX_INCLUDE_INLINER_HPP
+#define CPPLOX_INCLUDE_INLINER_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Expr.hpp"
+#include "Program.hpp"
+#include "Stmt.hpp"
+
+/// @brief A call site whose callee is expected to be a known function, whose returned expression runs in its place.
+struct InlineSite {
+    // The function the callee has to be for the body to be used; anything else is called as usual. Not owning,
+    // since the target belongs to the same program as the call site.
+    const Function* target;
+    // The expression the target returns
+    std::shared_ptr<Expr> body;
+    // Whether the target is a method called on an instance, whose fields must not shadow it
+    bool method;
+};
+
+/**
+ * @brief Finds calls to small functions and methods that can be inlined into their call sites.
+ *
+ * Candidates are functions and methods declared at the top level whose body is a single return of a small
+ * expression that calls nothing, so they are never recursive. A global function is inlined at calls of its name
+ * that aren't shadowed by a local, and a method, other than an initializer, at calls of a property of that name if
+ * no other class of the program declares it. Since globals and fields can be rebound at any time, every site is
+ * guarded at runtime: the Interpreter only evaluates the inlined body if the callee turns out to be the target.
+ */
+class Inliner : public ExprVisitor<void>, public StmtVisitor<void> {
+   public:
+    explicit Inliner(const ResolvedLocals& locals) : locals(locals) {}
+
+    /// @brief Marks the inlinable call sites of the given top-level statements.
+    void inlineCalls(const std::vector<std::shared_ptr<Stmt>>&);
+
+    void visitAssignExpr(std::shared_ptr<Assign>);
+    void visitBinaryExpr(std::shared_ptr<Binary>);
+    void visitCallExpr(std::shared_ptr<Call>);
+    void visitGetExpr(std::shared_ptr<Get>);
+    void visitGroupingExpr(std::shared_ptr<Grouping>);
+    void visitLiteralExpr(std::shared_ptr<Literal>);
+    void visitLogicalExpr(std::shared_ptr<Logical>);
+    void visitSetExpr(std::shared_ptr<Set>);
+    void visitSuperExpr(std::shared_ptr<Super>);
+    void visitThisExpr(std::shared_ptr<This>);
+    void visitUnaryExpr(std::shared_ptr<Unary>);
+    void visitVariableExpr(std::shared_ptr<Variable>);
+
+    void visitBlockStmt(std::shared_ptr<Block>);
+    void visitClassStmt(std::shared_ptr<Class>);
+    void visitExpressionStmt(std::shared_ptr<Expression>);
+    void visitForStmt(std::shared_ptr<For>);
+    void visitFunctionStmt(std::shared_ptr<Function>);
+    void visitIfStmt(std::shared_ptr<If>);
+    void visitImportStmt(std::shared_ptr<Import>);
+    void visitPrintStmt(std::shared_ptr<Print>);
+    void visitReturnStmt(std::shared_ptr<Return>);
+    void visitVarStmt(std::shared_ptr<Var>);
+    void visitWhileStmt(std::shared_ptr<While>);
+
+    /// @brief Largest number of nodes in the returned expression of an inlinable function.
+    static constexpr size_t maxBodySize = 16;
+
+   private:
+    const ResolvedLocals& locals;
+    // Inlinable global functions and methods by name, or nullptr where a name is declared more than once
+    std::map<std::string, std::shared_ptr<InlineSite>> functions;
+    std::map<std::string, std::shared_ptr<InlineSite>> methods;
+
+    void resolve(const std::vector<std::shared_ptr<Stmt>>&);
+    void resolve(const std::shared_ptr<Stmt>&);
+    void resolve(const std::shared_ptr<Expr>&);
+
+    /// @brief Records the given function as a candidate under its name, or as ambiguous if the name is taken.
+    static void addCandidate(std::map<std::string, std::shared_ptr<InlineSite>>&, const std::shared_ptr<Function>&, bool);
+    /// @brief Returns the expression the given function returns, or nullptr if it can't be inlined.
+    static std::shared_ptr<Expr> inlinableBody(const std::shared_ptr<Function>&);
+    /// @brief Returns the number of nodes of the given expression, or SIZE_MAX if it calls anything.
+    static size_t bodySize(const std::shared_ptr<Expr>&);
+};
+
+#endif
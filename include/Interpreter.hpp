@@ -2,70 +2,150 @@
 #define CPPLOX_INCLUDE_INTERPRETER_HPP
 
 #include <any>
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "Environment.hpp"
 #include "Expr.hpp"
+#include "Output.hpp"
+#include "Program.hpp"
+#include "Scheduler.hpp"
 #include "Stmt.hpp"
 
-class Interpreter : public ExprVisitor, public StmtVisitor {
+class LoxFunction;
+class NativeFunction;
+class RegisterVm;
+
+class Interpreter : public ExprVisitor<std::any>, public StmtVisitor<void> {
     friend class LoxFunction;
+    friend class Scheduler;
 
    public:
     Interpreter();
 
-    std::any visitAssignExpr(std::shared_ptr<Assign>) override;
-    std::any visitBinaryExpr(std::shared_ptr<Binary>) override;
-    std::any visitCallExpr(std::shared_ptr<Call>) override;
-    std::any visitGetExpr(std::shared_ptr<Get>) override;
-    std::any visitGroupingExpr(std::shared_ptr<Grouping>) override;
-    std::any visitLiteralExpr(std::shared_ptr<Literal>) override;
-    std::any visitLogicalExpr(std::shared_ptr<Logical>) override;
-    std::any visitSetExpr(std::shared_ptr<Set>) override;
-    std::any visitSuperExpr(std::shared_ptr<Super>) override;
-    std::any visitThisExpr(std::shared_ptr<This>) override;
-    std::any visitUnaryExpr(std::shared_ptr<Unary>) override;
-    std::any visitVariableExpr(std::shared_ptr<Variable>) override;
-
-    std::any visitBlockStmt(std::shared_ptr<Block>) override;
-    std::any visitClassStmt(std::shared_ptr<Class>) override;
-    std::any visitExpressionStmt(std::shared_ptr<Expression>) override;
-    std::any visitFunctionStmt(std::shared_ptr<Function>) override;
-    std::any visitIfStmt(std::shared_ptr<If>) override;
-    std::any visitPrintStmt(std::shared_ptr<Print>) override;
-    std::any visitReturnStmt(std::shared_ptr<Return>) override;
-    std::any visitVarStmt(std::shared_ptr<Var>) override;
-    std::any visitWhileStmt(std::shared_ptr<While>) override;
+    std::any visitAssignExpr(std::shared_ptr<Assign>);
+    std::any visitBinaryExpr(std::shared_ptr<Binary>);
+    std::any visitCallExpr(std::shared_ptr<Call>);
+    std::any visitGetExpr(std::shared_ptr<Get>);
+    std::any visitGroupingExpr(std::shared_ptr<Grouping>);
+    std::any visitLiteralExpr(std::shared_ptr<Literal>);
+    std::any visitLogicalExpr(std::shared_ptr<Logical>);
+    std::any visitSetExpr(std::shared_ptr<Set>);
+    std::any visitSuperExpr(std::shared_ptr<Super>);
+    std::any visitThisExpr(std::shared_ptr<This>);
+    std::any visitUnaryExpr(std::shared_ptr<Unary>);
+    std::any visitVariableExpr(std::shared_ptr<Variable>);
+
+    void visitBlockStmt(std::shared_ptr<Block>);
+    void visitClassStmt(std::shared_ptr<Class>);
+    void visitExpressionStmt(std::shared_ptr<Expression>);
+    void visitForStmt(std::shared_ptr<For>);
+    void visitFunctionStmt(std::shared_ptr<Function>);
+    void visitIfStmt(std::shared_ptr<If>);
+    void visitImportStmt(std::shared_ptr<Import>);
+    void visitPrintStmt(std::shared_ptr<Print>);
+    void visitReturnStmt(std::shared_ptr<Return>);
+    void visitVarStmt(std::shared_ptr<Var>);
+    void visitWhileStmt(std::shared_ptr<While>);
 
     /// @brief Interprets a given expression. i.e. run the interpreter.
     void interpret(std::vector<std::shared_ptr<Stmt>>);
 
-    /// @brief Records the number of scopes between the variable usage and its original scope.
-    void resolve(std::shared_ptr<Expr>, size_t);
+    /// @brief Adds the given resolution results to the ones used when looking up variables.
+    void addLocals(const ResolvedLocals&);
+    /// @brief Adds the given import targets to the ones used when executing import statements.
+    void addImports(const ResolvedImports&);
+    /// @brief Forgets the resolution results and import targets of the given program.
+    void removeProgram(const Program&);
+    /// @brief Makes the given compiled module available to import statements referring to the given canonical path.
+    void addModule(const std::string&, std::shared_ptr<const Program>);
+    /// @brief Records that the module at the given canonical path has run, so importing it does nothing.
+    void markImported(const std::string&);
+
+    /// @brief Returns a truth value based on the given std::any.
+    static bool isTruthy(const std::any&);
+    /// @brief Checks if two std::any's are equal.
+    static bool isEqual(const std::any&, const std::any&);
+
+    /// @brief Returns a std::string representation of the given std::any
+    std::string stringify(std::any);
+
+    /// @brief Defines the given native function as a global, under its own name.
+    void defineNative(std::shared_ptr<NativeFunction>);
+
+    /// @brief Returns the value of the given global variable, or std::nullopt if it isn't defined.
+    std::optional<std::any> getGlobal(const std::string&);
+    /// @brief Defines or redefines a global variable.
+    void defineGlobal(const std::string&, const std::any&);
+    /// @brief Returns the storage of the given global variable, or nullptr if it isn't defined. Globals are never
+    /// removed, so the pointer stays valid for the interpreter's lifetime.
+    std::any* findGlobal(const std::string&);
+
+    /// @brief Runs functions on the register VM, lowered to SSA form and optimized on their first call, instead of
+    /// walking their syntax trees. Functions that can't be lowered are still interpreted.
+    void setRegisterVm(bool enabled) { useRegisterVm = enabled; }
+    /// @brief Sets how aggressively programs are optimized while running. At level 0 the sites marked by the
+    /// Inliner, EscapeAnalysis and LoopAnalysis run as usual; from level 1 callees' bodies are evaluated in place,
+    /// instances that don't escape are scalar replaced and planned loops take their shortcuts. Defaults to 1.
+    void setOptimizationLevel(int level) { optimizationLevel = level; }
+
+    /// @brief Returns the sink that print statements write to.
+    Output& getOutput() { return output; }
+    /// @brief Returns the scheduler running this interpreter's tasks.
+    Scheduler& getScheduler() { return scheduler; }
 
    private:
+    // Methods of a subclass's super expressions, by SuperSite::index
+    using SuperMethodTable = std::vector<std::shared_ptr<LoxFunction>>;
+    // Variable of a subclass's "super" scope holding its SuperMethodTable, named so no identifier can clash with it
+    static constexpr const char* superMethodsKey = "super methods";
+
+    Output output;
     std::shared_ptr<Environment> globals{new Environment};
     std::shared_ptr<Environment> environment = globals;
-    std::map<std::shared_ptr<Expr>, size_t> locals;
+    ResolvedLocals locals;
+    ResolvedImports imports;
+    // Compiled modules by canonical path, and the paths of those that have already been run
+    std::map<std::string, std::shared_ptr<const Program>> modules;
+    std::set<std::string> importedModules;
+    bool useRegisterVm = false;
+    int optimizationLevel = 1;
+    // Register code by function, or nullptr for functions that can't be lowered. Weak, so unloaded programs are freed.
+    std::map<std::weak_ptr<Function>, std::shared_ptr<const RegisterVm>, std::owner_less<>> registerCode;
+    // Declared last, so tasks abandoned on destruction unwind while everything their frames refer to still exists
+    Scheduler scheduler{*this};
 
     /// @brief Helper method that uses the visitor pattern to return an expression's std::any.
     std::any evaluate(std::shared_ptr<Expr>);
-    /// @brief Returns a truth value based on the given std::any.
-    bool isTruthy(const std::any&);
-    /// @brief Checks if two std::any's are equal.
-    bool isEqual(const std::any&, const std::any&);
     /// @brief Checks if the given std::any holds a number. If it doesn't, throw an error with the given token.
     void checkNumberOperand(const Token&, const std::any&);
     /// @brief Checks if the given std::any's hold numbers. If either doesn't, throw an error with the given token.
     void checkNumberOperands(const Token&, const std::any&, const std::any&);
-    /// @brief Returns a std::string representation of the given std::any
-    std::string stringify(std::any);
+
+    /// @brief Calls the given callee with the arguments of the given call.
+    std::any callValue(const std::any&, const std::shared_ptr<Call>&);
+    /// @brief Makes a call marked by the Inliner, evaluating the inlined body if the callee is its target.
+    std::any callInlined(const std::shared_ptr<Call>&);
+    /// @brief Runs a declaration marked by EscapeAnalysis, scalar replacing the instance if the callee is its class.
+    void defineScalar(const std::shared_ptr<Var>&);
+    /// @brief Runs a for loop in the scope of its initializer, using the LoopPlan attached to it.
+    void runLoop(const For&);
+    /// @brief Returns the property with the given name of the given object, through the given site's cache if any.
+    std::any getProperty(const std::any&, const Token&, PropertyCache* = nullptr);
 
     /// @brief Executes a statement.
     void execute(std::shared_ptr<Stmt>);
     /// @brief Executes a block statement.
     void executeBlock(const std::vector<std::shared_ptr<Stmt>>&, std::shared_ptr<Environment>);
 
+    /// @brief Returns the register code of the given function, building it on first use, or nullptr if the
+    /// function is to be interpreted.
+    const RegisterVm* registerCodeFor(const std::shared_ptr<Function>&);
+
     /// @brief Get a variable's value by searching the enclosing environments.
     std::any lookUpVariable(const Token&, std::shared_ptr<Expr>);
 };
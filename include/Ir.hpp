@@ -0,0 +1,138 @@
+#ifndef CPPLOX_INCLUDE_IR_HPP
+#define CPPLOX_INCLUDE_IR_HPP
+
+#include <any>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Token.hpp"
+
+/// @brief Operations of the intermediate representation.
+enum class IrOp {
+    CONST,
+    PARAM,
+    COPY,
+    PHI,
+
+    // Variables outside the function's own scopes
+    LOAD_GLOBAL,
+    STORE_GLOBAL,
+    LOAD_ENV,
+    STORE_ENV,
+
+    // Throws unless the operand is a number, otherwise yields it
+    CHECK_NUMBER,
+
+    // Arithmetic. Only ADD accepts operands that aren't numbers, the others expect checked operands.
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE,
+    NEGATE,
+    NOT,
+
+    // Comparisons
+    EQUAL,
+    NOT_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    LESS,
+    LESS_EQUAL,
+
+    CALL,
+    GET,
+    FIELD_TARGET,
+    SET,
+    SUPER,
+    PRINT,
+
+    // Terminators
+    JUMP,
+    BRANCH,
+    RETURN
+};
+
+class IrBlock;
+
+/**
+ * @brief An instruction, which is also the SSA value it defines.
+ *
+ * Each instruction is defined exactly once and refers to the values it uses directly. A phi has one operand per
+ * predecessor of its block, in the order of IrBlock::predecessors.
+ */
+class IrInstruction {
+   public:
+    IrInstruction(IrOp op, IrBlock* block) : op(op), block(block) {}
+
+    /// @brief Returns whether the instruction writes to variables, fields or output, or transfers control.
+    bool hasSideEffects() const;
+    /// @brief Returns whether the instruction can throw a RuntimeError (or reach a std::bad_any_cast, like the
+    /// Interpreter does for unchecked comparisons).
+    bool mayThrow() const;
+    /// @brief Returns whether the result only depends on the operands, so equal instructions yield equal values.
+    bool isPure() const;
+    /// @brief Returns whether the result is known to be a number.
+    bool yieldsNumber() const;
+
+    std::string toString() const;
+
+    IrOp op;
+    IrBlock* block;
+    // SSA value number, unique within the function
+    size_t id = 0;
+    std::vector<IrInstruction*> operands;
+    // Targets of JUMP and BRANCH, the latter's taken when the condition is truthy first
+    std::vector<IrBlock*> targets;
+    // Value of CONST
+    std::any constant;
+    // Index of PARAM, depth of LOAD_ENV and STORE_ENV
+    size_t index = 0;
+    // Token naming the variable or property, or at which errors are reported
+    const Token* token = nullptr;
+    // Set once the operands are proven to be numbers, so the operation can't fail and needs no type dispatch
+    bool numeric = false;
+};
+
+/// @brief A basic block: phis first, then straight-line instructions, then exactly one terminator.
+class IrBlock {
+   public:
+    explicit IrBlock(size_t id) : id(id) {}
+
+    /// @brief Returns the terminator, or nullptr while the block is still being built.
+    IrInstruction* terminator() const;
+    /// @brief Returns the blocks the terminator can transfer control to.
+    std::vector<IrBlock*> successors() const;
+
+    size_t id;
+    std::vector<std::unique_ptr<IrInstruction>> instructions;
+    std::vector<IrBlock*> predecessors;
+};
+
+/// @brief The control flow graph of one Lox function in SSA form. The first block is the entry.
+class IrFunction {
+   public:
+    IrFunction(const std::string& name, size_t arity) : name(name), arity(arity) {}
+
+    /// @brief Appends a new, empty block.
+    IrBlock* addBlock();
+    /// @brief Numbers blocks and values consecutively in block order.
+    void renumber();
+    /// @brief Returns blocks in reverse post-order from the entry, which excludes unreachable blocks.
+    std::vector<IrBlock*> reversePostOrder() const;
+    /// @brief Removes blocks that can't be reached from the entry, along with their phi operands.
+    void removeUnreachableBlocks();
+    /// @brief Makes every use of each key instruction use its value instead.
+    void replaceUses(const std::vector<std::pair<IrInstruction*, IrInstruction*>>&);
+
+    /// @brief Returns a textual listing of the function.
+    std::string toString() const;
+
+    const std::string name;
+    const size_t arity;
+    std::vector<std::unique_ptr<IrBlock>> blocks;
+    // Number of values after renumber()
+    size_t valueCount = 0;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef CPPLOX_INCLUDE_IRBUILDER_HPP
+#define CPPLOX_INCLUDE_IRBUILDER_HPP
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Expr.hpp"
+#include "Ir.hpp"
+#include "Program.hpp"
+#include "Stmt.hpp"
+
+/**
+ * @brief Lowers a resolved function to SSA form.
+ *
+ * The function's own locals become SSA values, built on the fly with the algorithm of Braun et al. ("Simple and
+ * Efficient Construction of Static Single Assignment Form"). Variables of enclosing functions are reached through
+ * the closure environment, and globals through the interpreter's globals, as the Interpreter does.
+ *
+ * Functions that declare functions or classes aren't lowered, since those capture the function's locals in an
+ * environment.
+ */
+class IrBuilder : public ExprVisitor<IrInstruction*>, public StmtVisitor<void> {
+   public:
+    explicit IrBuilder(const ResolvedLocals& locals) : locals(locals) {}
+
+    /// @brief Returns the SSA form of the given function, or nullptr if it can't be lowered.
+    std::unique_ptr<IrFunction> build(const std::shared_ptr<Function>&);
+
+    /// @brief Returns every function and method declared in the given statements, including nested ones.
+    static std::vector<std::shared_ptr<Function>> functionsIn(const std::vector<std::shared_ptr<Stmt>>&);
+
+    IrInstruction* visitAssignExpr(std::shared_ptr<Assign>);
+    IrInstruction* visitBinaryExpr(std::shared_ptr<Binary>);
+    IrInstruction* visitCallExpr(std::shared_ptr<Call>);
+    IrInstruction* visitGetExpr(std::shared_ptr<Get>);
+    IrInstruction* visitGroupingExpr(std::shared_ptr<Grouping>);
+    IrInstruction* visitLiteralExpr(std::shared_ptr<Literal>);
+    IrInstruction* visitLogicalExpr(std::shared_ptr<Logical>);
+    IrInstruction* visitSetExpr(std::shared_ptr<Set>);
+    IrInstruction* visitSuperExpr(std::shared_ptr<Super>);
+    IrInstruction* visitThisExpr(std::shared_ptr<This>);
+    IrInstruction* visitUnaryExpr(std::shared_ptr<Unary>);
+    IrInstruction* visitVariableExpr(std::shared_ptr<Variable>);
+
+    void visitBlockStmt(std::shared_ptr<Block>);
+    void visitClassStmt(std::shared_ptr<Class>);
+    void visitExpressionStmt(std::shared_ptr<Expression>);
+    void visitForStmt(std::shared_ptr<For>);
+    void visitFunctionStmt(std::shared_ptr<Function>);
+    void visitIfStmt(std::shared_ptr<If>);
+    void visitImportStmt(std::shared_ptr<Import>);
+    void visitPrintStmt(std::shared_ptr<Print>);
+    void visitReturnStmt(std::shared_ptr<Return>);
+    void visitVarStmt(std::shared_ptr<Var>);
+    void visitWhileStmt(std::shared_ptr<While>);
+
+   private:
+    const ResolvedLocals& locals;
+
+    IrFunction* function = nullptr;
+    IrBlock* block = nullptr;
+    // Local variable ids by name, one map per scope, the function's parameter scope first
+    std::vector<std::map<std::string, size_t>> scopes;
+    size_t variableCount = 0;
+
+    // SSA construction state
+    std::map<IrBlock*, std::map<size_t, IrInstruction*>> definitions;
+    std::map<IrBlock*, std::vector<std::pair<size_t, IrInstruction*>>> incompletePhis;
+    std::set<IrBlock*> sealed;
+
+    IrInstruction* evaluate(const std::shared_ptr<Expr>&);
+    void execute(const std::shared_ptr<Stmt>&);
+    /// @brief Lowers a loop with the given condition, body and increment, any of which but the body may be nullptr.
+    void loop(const std::shared_ptr<Expr>&, const std::shared_ptr<Stmt>&, const std::shared_ptr<Expr>&);
+
+    /// @brief Appends an instruction to the current block.
+    IrInstruction* emit(IrOp, std::vector<IrInstruction*> = {}, const Token* = nullptr);
+    IrInstruction* constant(const std::any&);
+    void jump(IrBlock*);
+    void branch(IrInstruction*, IrBlock*, IrBlock*);
+
+    size_t declare(const std::string&);
+    /// @brief Emits a read of the variable the given expression refers to.
+    IrInstruction* read(const std::shared_ptr<Expr>&, const Token&);
+    /// @brief Emits a write of the variable the given expression refers to.
+    void write(const std::shared_ptr<Expr>&, const Token&, IrInstruction*);
+
+    void writeVariable(size_t, IrBlock*, IrInstruction*);
+    IrInstruction* readVariable(size_t, IrBlock*);
+    IrInstruction* readVariableRecursive(size_t, IrBlock*);
+    IrInstruction* addPhi(IrBlock*);
+    void addPhiOperands(size_t, IrInstruction*);
+    /// @brief Marks a block as having all its predecessors, completing the phis that were waiting for them.
+    void seal(IrBlock*);
+};
+
+#endif
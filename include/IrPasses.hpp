@@ -0,0 +1,75 @@
+#ifndef CPPLOX_INCLUDE_IRPASSES_HPP
+#define CPPLOX_INCLUDE_IRPASSES_HPP
+
+#include <memory>
+#include <vector>
+
+#include "Ir.hpp"
+
+/// @brief A transformation of a function in SSA form that preserves its behaviour, including runtime errors.
+class IrPass {
+   public:
+    /// @brief Returns the name of the pass, e.g. for listings.
+    virtual const char* name() const = 0;
+    /// @brief Transforms the given function. Returns whether anything changed.
+    virtual bool run(IrFunction&) = 0;
+
+    virtual ~IrPass() = default;
+};
+
+/// @brief Replaces copies and phis whose operands are all the same value by that value.
+class CopyPropagation : public IrPass {
+   public:
+    const char* name() const override { return "copy-propagation"; }
+    bool run(IrFunction&) override;
+};
+
+/**
+ * @brief Infers which values are numbers, then drops type checks of values that are and marks operations whose
+ * operands are, so they need neither type dispatch nor error handling.
+ *
+ * Inference is optimistic over phis, so loop counters are proven numeric as long as every update is.
+ */
+class TypeCheckElimination : public IrPass {
+   public:
+    const char* name() const override { return "type-check-elimination"; }
+    bool run(IrFunction&) override;
+};
+
+/// @brief Replaces pure instructions by an equal instruction that dominates them, including repeated type checks
+/// of the same value.
+class CommonSubexpressionElimination : public IrPass {
+   public:
+    const char* name() const override { return "cse"; }
+    bool run(IrFunction&) override;
+};
+
+/// @brief Moves pure instructions that can't throw and only use values defined outside a loop to its preheader.
+class LoopInvariantCodeMotion : public IrPass {
+   public:
+    const char* name() const override { return "licm"; }
+    bool run(IrFunction&) override;
+};
+
+/// @brief Removes instructions whose values are unused and which have no side effects and can't throw.
+class DeadCodeElimination : public IrPass {
+   public:
+    const char* name() const override { return "dce"; }
+    bool run(IrFunction&) override;
+};
+
+/// @brief Runs a sequence of passes over functions.
+class IrPassManager {
+   public:
+    void add(std::unique_ptr<IrPass> pass) { passes.push_back(std::move(pass)); }
+    /// @brief Runs every pass in order, then renumbers the function.
+    void run(IrFunction&);
+
+    /// @brief Returns the pass pipeline used before execution.
+    static IrPassManager standard();
+
+   private:
+    std::vector<std::unique_ptr<IrPass>> passes;
+};
+
+#endif
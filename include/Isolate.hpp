@@ -0,0 +1,74 @@
+#ifndef CPPLOX_INCLUDE_ISOLATE_HPP
+#define CPPLOX_INCLUDE_ISOLATE_HPP
+
+#include <any>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Error.hpp"
+#include "Interpreter.hpp"
+#include "NativeFunctions.hpp"
+#include "Program.hpp"
+#include "Stmt.hpp"
+
+/**
+ * @brief A self-contained Lox runtime: an interpreter with its own globals, output sink and error state.
+ *
+ * Isolates share no mutable state, so separate isolates may run concurrently on separate threads. A single
+ * isolate must only be used by one thread at a time.
+ *
+ * Errors are reported to the isolate's error stream and recorded in its flags rather than thrown.
+ */
+class Isolate {
+   public:
+    Isolate() = default;
+    /// @brief Creates an isolate reporting errors to the given stream.
+    Isolate(std::ostream& errors) { state.stream = &errors; }
+
+    Isolate(const Isolate&) = delete;
+    Isolate& operator=(const Isolate&) = delete;
+
+    /// @brief Scans, parses and resolves the given source code and every module it imports. Returns nullptr if a
+    /// syntax or resolution error was reported. Imports are resolved relative to the directory of the given path,
+    /// which names the file the source code was read from, or relative to the working directory if it is empty.
+    std::shared_ptr<const Program> compile(const std::string&, const std::string& = "");
+    /// @brief Executes a compiled program in this isolate's global scope.
+    void run(std::shared_ptr<const Program>);
+    /// @brief Compiles and executes the given source code, read from the file at the given path, if any.
+    void run(const std::string&, const std::string& = "");
+    /// @brief Releases what running the given program retained, so its syntax tree can be freed. Only valid once
+    /// no function or class it declared can be called anymore.
+    void unload(std::shared_ptr<const Program>);
+
+    /// @brief Calls the global function or class with the given name. Returns nil if the call failed.
+    std::any call(const std::string&, const std::vector<std::any>&);
+
+    /// @brief Returns the value of the given global variable, or std::nullopt if it isn't defined.
+    std::optional<std::any> getGlobal(const std::string& name) { return interpreter.getGlobal(name); }
+    /// @brief Defines or redefines a global variable.
+    void setGlobal(const std::string& name, const std::any& value) { interpreter.defineGlobal(name, value); }
+    /// @brief Defines a global native function, which may capture state of the embedder.
+    void defineNative(const std::string&, const std::vector<ValueType>&, NativeFunction::Fn);
+
+    /// @brief Returns whether a syntax or resolution error was reported.
+    bool hadError() const { return state.hadError; }
+    /// @brief Returns whether a runtime error was reported.
+    bool hadRuntimeError() const { return state.hadRuntimeError; }
+    /// @brief Forgets previously reported errors, e.g. before running the next line of a prompt.
+    void clearErrors() { state.hadError = state.hadRuntimeError = false; }
+
+    ErrorState& getErrorState() { return state; }
+    Interpreter& getInterpreter() { return interpreter; }
+    Output& getOutput() { return interpreter.getOutput(); }
+
+   private:
+    ErrorState state;
+    Interpreter interpreter;
+    // Programs whose resolution results have been handed to the interpreter
+    std::set<std::shared_ptr<const Program>> loaded;
+};
+
+#endif
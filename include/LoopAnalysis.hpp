@@ -0,0 +1,59 @@
+#ifndef CPPLOX_INCLUDE_LOOPANALYSIS_HPP
+#define CPPLOX_INCLUDE_LOOPANALYSIS_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ClosureAnalysis.hpp"
+#include "Expr.hpp"
+#include "Program.hpp"
+#include "Stmt.hpp"
+
+/// @brief How the Interpreter can run a for loop without walking all of it every iteration.
+struct LoopPlan {
+    // Whether the body is a block declaring nothing that closures can capture, so one environment can be cleared
+    // and reused every iteration
+    bool reuseBody = false;
+
+    // Whether the loop is `for (var i = ...; i < limit; i = i + step)`, with any comparison and constant step,
+    // where only the increment assigns the counter. The counter is then stepped in place and only the limit
+    // is evaluated to test it.
+    bool counted = false;
+    std::string counter;
+    TokenType comparison = TokenType::LESS;
+    // A literal or a variable, whose evaluation has no effects
+    std::shared_ptr<Expr> limit;
+    double step = 0;
+};
+
+/**
+ * @brief Finds for loops the Interpreter can run faster than their syntax trees, attaching a LoopPlan to each.
+ *
+ * The plan is only a shape: whether the counter and limit hold numbers is still checked when the loop runs, and
+ * a loop whose values don't fit runs as usual.
+ */
+class LoopAnalysis {
+   public:
+    explicit LoopAnalysis(const ResolvedLocals& locals) : locals(locals) {}
+
+    /// @brief Plans the for loops of the given top-level statements and of every function they declare.
+    void analyze(const std::vector<std::shared_ptr<Stmt>>&);
+
+   private:
+    const ResolvedLocals& locals;
+    ClosureAnalysis::Closures closures;
+    // Number of Assign expressions referring to each local variable
+    std::map<const ClosureAnalysis::Slot*, size_t> assignments;
+
+    void analyze(const std::shared_ptr<Stmt>&);
+    /// @brief Returns the plan for the given loop, or nullptr if it has to run as usual.
+    std::shared_ptr<LoopPlan> plan(const For&) const;
+    /// @brief Whether the given loop counts its initializer's variable, filling in the counter's part of the plan.
+    bool planCounter(const For&, LoopPlan&) const;
+    /// @brief Whether the given statement declares a function or class anywhere within it.
+    static bool declaresClosures(const std::shared_ptr<Stmt>&);
+};
+
+#endif
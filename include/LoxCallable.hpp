@@ -6,7 +6,9 @@
 #include <vector>
 
 #include "Interpreter.hpp"
+#include "Util.hpp"
 
+/// @brief Base of everything that can be called. Callables are always stored in a std::any as a std::shared_ptr<LoxCallable>.
 class LoxCallable {
    public:
     /// @brief Returns the number of arguments that this callable takes. 
@@ -15,6 +17,14 @@ class LoxCallable {
     virtual std::any call(Interpreter&, const std::vector<std::any>&) = 0;
     /// @brief Returns a string representation of this callable.
     virtual std::string toString() const = 0;
+
+    virtual ~LoxCallable() = default;
 };
 
-#endif
\ No newline at end of file
+/// @brief If the given std::any holds a callable of the specified type, return a casted std::shared_ptr. Otherwise, return nullptr.
+template <typename T>
+std::shared_ptr<T> callableAnyCast(const std::any& obj) {
+    return std::dynamic_pointer_cast<T>(ptrAnyCast<LoxCallable>(obj));
+}
+
+#endif
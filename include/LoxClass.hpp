@@ -1,26 +1,70 @@
 #ifndef CPPLOX_INCLUDE_LOXCLASS_HPP
 #define CPPLOX_INCLUDE_LOXCLASS_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 
 #include "LoxCallable.hpp"
 #include "LoxFunction.hpp"
 
+/**
+ * @brief Inline cache of a Get or Set site: the slot its field name has in the class of the last instance it saw.
+ *
+ * Syntax trees may be shared by isolates on different threads, so the class's id and the slot are packed into one
+ * atomic word. A slot never changes once assigned, so a racing store only replaces one valid entry with another.
+ */
+struct PropertyCache {
+    std::atomic<uint64_t> entry{0};
+};
+
 class LoxClass : public LoxCallable, public std::enable_shared_from_this<LoxClass> {
    public:
-    LoxClass(const std::string& s, std::shared_ptr<LoxClass> super, std::map<std::string, std::shared_ptr<LoxFunction>>&& methds)
-        : name(s), superclass(super), methods(std::move(methds)) {}
+    using MethodTable = std::unordered_map<std::string, std::shared_ptr<LoxFunction>>;
+
+    /// @brief Creates a class whose method table holds the given methods plus every inherited method they don't override.
+    LoxClass(const std::string&, std::shared_ptr<LoxClass>, MethodTable&&, const Class* = nullptr);
 
     size_t arity() override;
     std::any call(Interpreter&, const std::vector<std::any>&) override;
     std::string toString() const override;
 
-    /// @brief Searches for and returns the method with the given name. Returns nullptr if not found.
+    /// @brief Returns the method with the given name, which may be inherited. Returns nullptr if not found.
     std::shared_ptr<LoxFunction> findMethod(const std::string&) const;
 
+    static constexpr size_t noSlot = static_cast<size_t>(-1);
+    /// @brief Maximum number of distinct field names laid out in slots; further fields fall back to a dictionary.
+    static constexpr size_t maxFieldSlots = 64;
+
+    /// @brief Returns the slot index of the given field name in this class's instances, or noSlot if it has none.
+    size_t findFieldSlot(const std::string&) const;
+    /// @brief Returns the slot index of the given field name, assigning the next free slot if it has none. Returns noSlot if the layout is full.
+    size_t addFieldSlot(const std::string&);
+    /// @brief Like findFieldSlot, but first tries the given site's cache and remembers the slot found in it.
+    size_t findFieldSlot(const std::string&, PropertyCache&) const;
+    /// @brief Like addFieldSlot, but first tries the given site's cache and remembers the slot found in it.
+    size_t addFieldSlot(const std::string&, PropertyCache&);
+
     const std::string name;
+    // Unique among every class created by the process, so caches shared across isolates never confuse two classes
+    const uint32_t id;
     const std::shared_ptr<LoxClass> superclass;
-    const std::map<std::string, std::shared_ptr<LoxFunction>> methods;
+    // Syntax tree the class was created from, or nullptr for classes compiled ahead of time
+    const Class* const declaration;
+    // Own and inherited methods, flattened so lookup doesn't walk the superclass chain
+    const MethodTable methods;
+    // The init method, if any, looked up once since every instantiation needs it
+    const std::shared_ptr<LoxFunction> initializer;
+
+   private:
+    // Field layout shared by all instances of this class. Slots are only ever added, so indices stay valid.
+    std::unordered_map<std::string, size_t> fieldSlots;
+
+    /// @brief Returns the slot the given cache holds for this class, or noSlot if it holds another class's.
+    size_t cachedSlot(const PropertyCache&) const;
+    /// @brief Remembers the given slot in the given cache, unless it is noSlot.
+    void cacheSlot(PropertyCache&, size_t) const;
 };
 
 #endif
\ No newline at end of file
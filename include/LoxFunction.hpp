@@ -5,6 +5,8 @@
 #include "LoxInstance.hpp"
 
 class LoxFunction : public LoxCallable {
+    friend class Interpreter;
+
    public:
     LoxFunction(std::shared_ptr<Function> decl, std::shared_ptr<Environment> clos, bool isInit)
         : declaration(decl), closure(clos), isInitializer(isInit) {}
@@ -14,7 +16,11 @@ class LoxFunction : public LoxCallable {
     std::string toString() const override { return "<fn " + declaration->name.lexeme + ">"; }
 
     /// @brief Binds this LoxFunction as a method of the given LoxInstance.
-    std::shared_ptr<LoxFunction> bind(std::shared_ptr<LoxInstance>);
+    virtual std::shared_ptr<LoxFunction> bind(std::shared_ptr<LoxInstance>);
+
+   protected:
+    /// @brief For functions whose body isn't a syntax tree, which override arity(), call(), toString() and bind().
+    explicit LoxFunction(bool isInit) : isInitializer(isInit) {}
 
    private:
     const std::shared_ptr<Function> declaration;
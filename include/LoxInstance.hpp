@@ -4,24 +4,38 @@
 #include <memory>
 #include <string>
 #include <any>
-#include <map>
+#include <unordered_map>
+#include <vector>
 
 #include "Token.hpp"
 
 class LoxClass;
-
+class LoxFunction;
+struct PropertyCache;
+
+/**
+ * @brief An instance of a LoxClass.
+ *
+ * Field values are stored in a vector of slots indexed by the class's shared field layout, with an empty std::any
+ * marking a field this instance hasn't set. Fields beyond the layout's capacity go into a per-instance dictionary.
+ */
 class LoxInstance : public std::enable_shared_from_this<LoxInstance> {
    public:
     LoxInstance(std::shared_ptr<LoxClass> loxCl) : loxClass(loxCl) {}
 
     std::string toString();
 
-    std::any get(const Token&);
-    void set(const Token&, const std::any&);
+    /// @brief Returns the given property's value. A field's slot is looked up through the given site's cache, if any.
+    std::any get(const Token&, PropertyCache* = nullptr);
+    /// @brief Sets the given field. Its slot is looked up through the given site's cache, if any.
+    void set(const Token&, const std::any&, PropertyCache* = nullptr);
+    /// @brief Returns the method the given property refers to, or nullptr if it is a field or doesn't exist.
+    std::shared_ptr<LoxFunction> findMethod(const std::string&) const;
 
    private:
     const std::shared_ptr<LoxClass> loxClass;
-    std::map<std::string, std::any> fields;
+    std::vector<std::any> slots;
+    std::unique_ptr<std::unordered_map<std::string, std::any>> dictionary;
 };
 
-#endif
\ No newline at end of file
+#endif
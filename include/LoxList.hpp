@@ -0,0 +1,33 @@
+#ifndef CPPLOX_INCLUDE_LOXLIST_HPP
+#define CPPLOX_INCLUDE_LOXLIST_HPP
+
+#include <any>
+#include <vector>
+
+#include "NativeObject.hpp"
+
+/**
+ * @brief Native growable array of values, stored contiguously.
+ *
+ * Methods: get(index), set(index, value), push(value), pop(), length() and slice(start, end), where slice
+ * returns a new list holding the elements in [start, end).
+ */
+class LoxList : public NativeObject {
+   public:
+    LoxList() = default;
+    LoxList(std::vector<std::any>&& elems) : elements(std::move(elems)) {}
+
+    /// @brief Returns the list's elements in the form [a, b, c].
+    std::string toString(Interpreter&) override;
+
+    std::vector<std::any> elements;
+
+   protected:
+    const NativeMethodTable& methods() const override;
+
+   private:
+    // Set while the list is being stringified, so a list containing itself doesn't recurse forever
+    bool printing = false;
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef CPPLOX_INCLUDE_LOXLISTENER_HPP
+#define CPPLOX_INCLUDE_LOXLISTENER_HPP
+
+#ifdef __linux__
+
+#include <any>
+#include <memory>
+#include <string>
+
+#include "NativeObject.hpp"
+
+/**
+ * @brief Native listening socket on a Unix-domain path or a loopback port.
+ *
+ * Methods: accept(), which suspends the calling task until a client connects and returns a LoxStream for the
+ * connection, port(), which returns the bound port or nil for Unix-domain sockets, and close().
+ */
+class LoxListener : public NativeObject {
+   public:
+    explicit LoxListener(int f) : fd(f) {}
+    ~LoxListener();
+
+    std::string toString(Interpreter&) override { return "<listener>"; }
+
+    /// @brief Starts listening on the given address, as interpreted by toSocketAddress().
+    static std::shared_ptr<LoxListener> listen(const std::any&);
+
+   protected:
+    const NativeMethodTable& methods() const override;
+
+   private:
+    int fd;
+};
+
+#endif
+
+#endif
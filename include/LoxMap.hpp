@@ -0,0 +1,72 @@
+#ifndef CPPLOX_INCLUDE_LOXMAP_HPP
+#define CPPLOX_INCLUDE_LOXMAP_HPP
+
+#include <any>
+#include <vector>
+
+#include "NativeObject.hpp"
+
+/**
+ * @brief Native hash map from numbers, strings and booleans to values.
+ *
+ * Uses open addressing with linear probing over a single power-of-two sized array of slots. Keys compare equal
+ * exactly when Interpreter::isEqual considers them equal.
+ *
+ * Methods: get(key), set(key, value), has(key), delete(key), length(), keys() and values(), where get returns nil
+ * for a missing key and keys/values return Lists.
+ */
+class LoxMap : public NativeObject {
+   public:
+    /// @brief Returns the map's entries in the form {key: value, ...}.
+    std::string toString(Interpreter&) override;
+
+    /// @brief Returns a pointer to the value stored under the given key, or nullptr if there is none.
+    std::any* find(const std::any&);
+    /// @brief Stores a value under the given key, replacing any existing value.
+    void insert(const std::any&, const std::any&);
+    /// @brief Removes the given key. Returns whether it was present.
+    bool erase(const std::any&);
+
+    size_t size() const { return count; }
+
+   protected:
+    const NativeMethodTable& methods() const override;
+
+   private:
+    enum class SlotState : unsigned char {
+        EMPTY,
+        FULL,
+        TOMBSTONE
+    };
+
+    struct Slot {
+        size_t hash = 0;
+        SlotState state = SlotState::EMPTY;
+        std::any key;
+        std::any value;
+    };
+
+    static constexpr size_t minCapacity = 8;
+
+    std::vector<Slot> slots;
+    // Number of FULL slots
+    size_t count = 0;
+    // Number of FULL and TOMBSTONE slots, which both lengthen probe sequences
+    size_t used = 0;
+
+    bool printing = false;
+
+    /// @brief Returns the slot holding the given key, or the slot it should be inserted into if absent.
+    Slot& probe(const std::any&, size_t);
+    /// @brief Rehashes all live entries into a slot array of the given capacity.
+    void rehash(size_t);
+
+    /// @brief Throws a NativeError unless the given value is a valid key.
+    static void checkKey(const std::any&);
+    /// @brief Hashes a valid key consistently with Interpreter::isEqual.
+    static size_t hashKey(const std::any&);
+    /// @brief Compares two valid keys the way Interpreter::isEqual does.
+    static bool keysEqual(const std::any&, const std::any&);
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef CPPLOX_INCLUDE_LOXNUMBERARRAY_HPP
+#define CPPLOX_INCLUDE_LOXNUMBERARRAY_HPP
+
+#include <vector>
+
+#include "NativeObject.hpp"
+
+/**
+ * @brief Native growable array of unboxed numbers, with vectorized bulk operations.
+ *
+ * Element access: get(index), set(index, number), push(number), length() and toList().
+ * Reductions: sum(), dot(array), min() and max(), which return NaN if any element is NaN.
+ * Operations returning a new array: scale(factor), add(array), apply(op, operand) with op one of "+", "-", "*" or
+ * "/", and prefixSum(). sort() sorts the array in place, with NaNs last.
+ */
+class LoxNumberArray : public NativeObject {
+   public:
+    // Largest size NumberArray(size) accepts, 8 GiB of elements
+    static constexpr size_t maxSize = size_t(1) << 30;
+
+    LoxNumberArray(size_t size) : elements(size) {}
+    LoxNumberArray(std::vector<double>&& elems) : elements(std::move(elems)) {}
+
+    /// @brief Returns the array's elements in the form [a, b, c].
+    std::string toString(Interpreter&) override;
+
+    std::vector<double> elements;
+
+   protected:
+    const NativeMethodTable& methods() const override;
+};
+
+#endif
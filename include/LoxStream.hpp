@@ -0,0 +1,47 @@
+#ifndef CPPLOX_INCLUDE_LOXSTREAM_HPP
+#define CPPLOX_INCLUDE_LOXSTREAM_HPP
+
+#ifdef __linux__
+
+#include <any>
+#include <string>
+
+#include <sys/socket.h>
+
+#include "NativeObject.hpp"
+
+/**
+ * @brief Native non-blocking byte stream over a file descriptor: a file, a pipe end or a connected socket.
+ *
+ * Methods: read(), which returns the next chunk of available data as a string or nil at the end of the stream,
+ * write(string), which returns once everything has been written, and close(). Reading and writing suspend the
+ * calling task rather than blocking the interpreter.
+ */
+class LoxStream : public NativeObject {
+   public:
+    /// @brief Takes ownership of the given file descriptor, which should be non-blocking.
+    explicit LoxStream(int f) : fd(f) {}
+    ~LoxStream();
+
+    std::string toString(Interpreter&) override { return "<stream>"; }
+
+    /// @brief Connects to the given address, suspending the running task until the connection is established.
+    static std::shared_ptr<LoxStream> connect(Interpreter&, const std::any&);
+
+   protected:
+    const NativeMethodTable& methods() const override;
+
+   private:
+    int fd;
+
+    /// @brief Returns the file descriptor, or throws a NativeError if the stream has been closed.
+    int checkOpen() const;
+};
+
+/// @brief Converts a listen()/connect() address to a socket address: a string names a Unix-domain socket and a
+/// number a port on the loopback interface. Throws a NativeError for anything else. Returns the address's length.
+socklen_t toSocketAddress(const std::any&, sockaddr_storage&);
+
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef CPPLOX_INCLUDE_LOXSTRINGBUILDER_HPP
+#define CPPLOX_INCLUDE_LOXSTRINGBUILDER_HPP
+
+#include <string>
+
+#include "NativeObject.hpp"
+
+/**
+ * @brief Native mutable string with amortized O(1) appends.
+ *
+ * Building a string with `s = s + x;` copies both operands on every iteration. A StringBuilder instead
+ * grows a single buffer in place, so `sb.append(x)` in a loop is linear in the length of the result.
+ */
+class LoxStringBuilder : public NativeObject {
+   public:
+    /// @brief Returns the builder's contents.
+    std::string toString(Interpreter&) override { return buffer; }
+
+   protected:
+    const NativeMethodTable& methods() const override;
+
+   private:
+    std::string buffer;
+};
+
+#endif
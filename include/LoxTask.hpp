@@ -0,0 +1,53 @@
+#ifndef CPPLOX_INCLUDE_LOXTASK_HPP
+#define CPPLOX_INCLUDE_LOXTASK_HPP
+
+#include <any>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "Coroutine.hpp"
+#include "Environment.hpp"
+#include "NativeObject.hpp"
+
+class LoxCallable;
+class Scheduler;
+
+/**
+ * @brief Native handle to a cooperative task created by spawn(function).
+ *
+ * Methods: done(), which returns whether the task has finished, and await(), which is the same as await(task).
+ */
+class LoxTask : public NativeObject {
+    friend class Scheduler;
+
+   public:
+    LoxTask(Scheduler& sched, std::shared_ptr<LoxCallable> fn) : scheduler(sched), function(fn) {}
+
+    std::string toString(Interpreter&) override { return finished ? "<task: done>" : "<task>"; }
+
+   protected:
+    const NativeMethodTable& methods() const override;
+
+   private:
+    Scheduler& scheduler;
+    // The function to run, released once the task has finished; nullptr for the main program
+    std::shared_ptr<LoxCallable> function;
+    // The task's stack, released once the task has finished
+    std::unique_ptr<Coroutine> context;
+    // The interpreter's current environment while the task is suspended
+    std::shared_ptr<Environment> environment;
+
+    // Whether the task's function has begun running on its stack, and whether it was abandoned before finishing
+    bool started = false;
+    bool cancelled = false;
+    bool finished = false;
+    std::any result;
+    std::exception_ptr error;
+
+    // The task this one is blocked on, if any, and the tasks blocked on this one
+    LoxTask* awaiting = nullptr;
+    std::vector<std::shared_ptr<LoxTask>> waiters;
+};
+
+#endif
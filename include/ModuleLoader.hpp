@@ -0,0 +1,67 @@
+#ifndef CPPLOX_INCLUDE_MODULELOADER_HPP
+#define CPPLOX_INCLUDE_MODULELOADER_HPP
+
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "Program.hpp"
+
+/**
+ * @brief Front end for a program together with every module it imports.
+ *
+ * Imports are discovered as each module is parsed, and every newly discovered module is scanned, parsed and
+ * resolved on a shared thread pool, so independent modules go through the front end in parallel before anything
+ * runs. Compiled modules are kept in a process-wide cache keyed by canonical path and validated by a hash of the
+ * file's contents, so a module is only compiled again once it has changed.
+ */
+class ModuleLoader {
+   public:
+    /// @brief Creates a loader for source code read from the given file, or from no file if the path is empty.
+    /// Imports are resolved relative to the file's directory, or the working directory if there is no file.
+    explicit ModuleLoader(const std::string&);
+
+    ModuleLoader(const ModuleLoader&) = delete;
+    ModuleLoader& operator=(const ModuleLoader&) = delete;
+
+    /// @brief Compiles the given source code and all of its imports, reporting errors to the current ErrorState.
+    /// Returns nullptr if any of them had a syntax or resolution error or couldn't be read.
+    std::shared_ptr<const Program> load(const std::string&);
+    /// @brief Compiles every module imported by the given, already resolved program, as load() does.
+    std::shared_ptr<const Program> load(std::shared_ptr<Program>);
+
+    /// @brief Scans, parses and resolves the given source code on its own, reporting errors to the current
+    /// ErrorState. Returns nullptr if an error was reported.
+    static std::shared_ptr<Program> compile(const std::string&);
+
+   private:
+    struct Module {
+        std::shared_ptr<const Program> program;
+        // Errors reported while compiling the module
+        std::string errors;
+        bool unreadable = false;
+    };
+
+    std::filesystem::path directory;
+    // Canonical path of the file being loaded, or empty if there is none
+    std::string entryPath;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t pending = 0;
+    // Every module discovered so far, by canonical path; nodes stay put, so tasks can fill them in without the lock
+    std::map<std::string, Module> modules;
+
+    /// @brief Queues every module the given program imports that hasn't been discovered yet.
+    void discover(const Program&);
+    /// @brief Reads and compiles the module at the given canonical path. Runs on the thread pool.
+    void loadModule(const std::string&, Module&);
+    /// @brief Reports the errors of the modules the given program imports, depth first and in import order, and
+    /// records every module imported without error. Returns false if any errors were reported.
+    bool collect(const Program&, Program&, std::map<std::string, bool>&);
+};
+
+#endif
@@ -1,13 +1,89 @@
 #ifndef CPPLOX_INCLUDE_NATIVEFUNCTIONS_HPP
 #define CPPLOX_INCLUDE_NATIVEFUNCTIONS_HPP
 
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "LoxCallable.hpp"
 
-class NativeClock : public LoxCallable {
+/// @brief Types that a native function can require of its arguments.
+enum class ValueType {
+    ANY,
+    NUMBER,
+    STRING,
+    BOOL
+};
+
+/// @brief Throws a NativeError if the given arguments don't match the given signature of the named function.
+void checkArguments(std::string_view, const std::vector<ValueType>&, std::span<const std::any>);
+
+/**
+ * @brief A function implemented in C++.
+ *
+ * Arguments are checked against the signature before the function is invoked, so the implementation can
+ * std::any_cast them without checking again. The implementation may be any callable, so natives defined by an
+ * embedder can carry the embedder's state.
+ */
+class NativeFunction : public LoxCallable {
    public:
-    size_t arity() override { return 0; }
+    using Fn = std::function<std::any(Interpreter&, std::span<const std::any>)>;
+
+    NativeFunction(const std::string& nm, const std::vector<ValueType>& sig, Fn fn) : name(nm), signature(sig), function(std::move(fn)) {}
+
+    size_t arity() override { return signature.size(); }
     std::any call(Interpreter&, const std::vector<std::any>&) override;
-    std::string toString() const override { return "<native fn: clock>"; }
+    std::string toString() const override { return "<native fn: " + name + ">"; }
+
+    const std::string name;
+
+   private:
+    const std::vector<ValueType> signature;
+    const Fn function;
 };
 
-#endif
\ No newline at end of file
+/// @brief clock(): Returns the number of seconds since the epoch.
+std::any nativeClock(Interpreter&, std::span<const std::any>);
+/// @brief str(value): Returns the string representation of any value.
+std::any nativeStr(Interpreter&, std::span<const std::any>);
+/// @brief len(string): Returns the length of a string.
+std::any nativeLen(Interpreter&, std::span<const std::any>);
+/// @brief sqrt(number): Returns the square root of a number.
+std::any nativeSqrt(Interpreter&, std::span<const std::any>);
+/// @brief floor(number): Rounds a number down to an integer.
+std::any nativeFloor(Interpreter&, std::span<const std::any>);
+/// @brief abs(number): Returns the absolute value of a number.
+std::any nativeAbs(Interpreter&, std::span<const std::any>);
+/// @brief StringBuilder(): Returns a new, empty LoxStringBuilder.
+std::any nativeStringBuilder(Interpreter&, std::span<const std::any>);
+/// @brief List(): Returns a new, empty LoxList.
+std::any nativeList(Interpreter&, std::span<const std::any>);
+/// @brief Map(): Returns a new, empty LoxMap.
+std::any nativeMap(Interpreter&, std::span<const std::any>);
+/// @brief NumberArray(size): Returns a new LoxNumberArray of the given size, filled with zeros.
+std::any nativeNumberArray(Interpreter&, std::span<const std::any>);
+/// @brief toNumberArray(list): Returns a new LoxNumberArray holding the numbers in the given List.
+std::any nativeToNumberArray(Interpreter&, std::span<const std::any>);
+/// @brief spawn(function): Queues a task that calls the given function with no arguments, and returns a LoxTask for it.
+std::any nativeSpawn(Interpreter&, std::span<const std::any>);
+/// @brief yield(): Lets every other queued task run before continuing.
+std::any nativeYield(Interpreter&, std::span<const std::any>);
+/// @brief await(task): Waits for a LoxTask to finish and returns its function's result.
+std::any nativeAwait(Interpreter&, std::span<const std::any>);
+/// @brief sleep(milliseconds): Suspends the calling task for the given time while other tasks run.
+std::any nativeSleep(Interpreter&, std::span<const std::any>);
+
+#ifdef __linux__
+/// @brief openFile(path, mode): Opens a file for reading ("r"), writing ("w") or appending ("a") as a LoxStream.
+std::any nativeOpenFile(Interpreter&, std::span<const std::any>);
+/// @brief pipe(): Returns a List holding the read end and the write end of a new pipe, as LoxStreams.
+std::any nativePipe(Interpreter&, std::span<const std::any>);
+/// @brief listen(address): Returns a LoxListener on a Unix-domain socket path or a loopback port (0 picks a free one).
+std::any nativeListen(Interpreter&, std::span<const std::any>);
+/// @brief connect(address): Connects to a Unix-domain socket path or a loopback port and returns a LoxStream.
+std::any nativeConnect(Interpreter&, std::span<const std::any>);
+#endif
+
+#endif
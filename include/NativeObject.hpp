@@ -0,0 +1,72 @@
+#ifndef CPPLOX_INCLUDE_NATIVEOBJECT_HPP
+#define CPPLOX_INCLUDE_NATIVEOBJECT_HPP
+
+#include <any>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "NativeFunctions.hpp"
+#include "Token.hpp"
+
+class NativeObject;
+
+/// @brief Signature and implementation of a native object's method.
+struct NativeMethodInfo {
+    using Fn = std::any (*)(Interpreter&, NativeObject&, std::span<const std::any>);
+
+    std::vector<ValueType> signature;
+    Fn function;
+};
+
+using NativeMethodTable = std::unordered_map<std::string_view, NativeMethodInfo>;
+
+/**
+ * @brief Base of objects implemented in C++. Native objects are always stored in a std::any as a std::shared_ptr<NativeObject>.
+ *
+ * Properties of a native object are its methods, looked up in a static per-type NativeMethodTable.
+ */
+class NativeObject : public std::enable_shared_from_this<NativeObject> {
+   public:
+    /// @brief Returns the method with the given name, bound to this object.
+    std::any get(const Token&);
+
+    /// @brief Returns a string representation of this object.
+    virtual std::string toString(Interpreter&) = 0;
+
+    virtual ~NativeObject() = default;
+
+   protected:
+    /// @brief Returns the methods available on this type of object.
+    virtual const NativeMethodTable& methods() const = 0;
+};
+
+/// @brief If the given std::any holds a native object of the specified type, return a casted std::shared_ptr. Otherwise, return nullptr.
+template <typename T>
+std::shared_ptr<T> nativeAnyCast(const std::any& obj) {
+    return std::dynamic_pointer_cast<T>(ptrAnyCast<NativeObject>(obj));
+}
+
+/// @brief Converts the given number to an index into a sequence of the given size. Throws a NativeError if it isn't a valid index.
+size_t toIndex(const std::any&, size_t);
+
+/// @brief A method of a native object, bound to the object it was accessed from.
+class NativeMethod : public LoxCallable {
+   public:
+    NativeMethod(std::string_view nm, const NativeMethodInfo& inf, std::shared_ptr<NativeObject> recv)
+        : name(nm), info(inf), receiver(recv) {}
+
+    size_t arity() override { return info.signature.size(); }
+    std::any call(Interpreter&, const std::vector<std::any>&) override;
+    std::string toString() const override { return "<native method: " + std::string(name) + ">"; }
+
+   private:
+    const std::string_view name;
+    const NativeMethodInfo& info;
+    const std::shared_ptr<NativeObject> receiver;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef CPPLOX_INCLUDE_NUMERICKERNELS_HPP
+#define CPPLOX_INCLUDE_NUMERICKERNELS_HPP
+
+#include <span>
+
+/*
+ * Bulk operations over contiguous doubles, vectorized with AVX2 or SSE2 when the compiler targets them and
+ * scalar otherwise. AVX2 has to be enabled at build time (-mavx2 or /arch:AVX2); SSE2 is part of x86-64.
+ *
+ * Reductions accumulate lane-wise, so their results may differ from a sequential sum in the last bits.
+ * Element-wise kernels allow the output to alias an input.
+ */
+
+/// @brief Returns the sum of all elements.
+double kernelSum(std::span<const double>);
+/// @brief Returns the dot product of two equally sized spans.
+double kernelDot(std::span<const double>, std::span<const double>);
+/// @brief Returns the smallest element of a non-empty span, or NaN if it contains one.
+double kernelMin(std::span<const double>);
+/// @brief Returns the largest element of a non-empty span, or NaN if it contains one.
+double kernelMax(std::span<const double>);
+
+/// @brief out[i] = in[i] * factor
+void kernelScale(std::span<const double>, double, std::span<double>);
+/// @brief out[i] = left[i] + right[i]
+void kernelAdd(std::span<const double>, std::span<const double>, std::span<double>);
+/// @brief out[i] = in[i] + operand
+void kernelAddScalar(std::span<const double>, double, std::span<double>);
+/// @brief out[i] = in[i] - operand
+void kernelSubScalar(std::span<const double>, double, std::span<double>);
+/// @brief out[i] = in[i] / operand
+void kernelDivScalar(std::span<const double>, double, std::span<double>);
+
+/// @brief out[i] = in[0] + ... + in[i]
+void kernelPrefixSum(std::span<const double>, std::span<double>);
+/// @brief Sorts the span in ascending order, with any NaNs last.
+void kernelSort(std::span<double>);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef CPPLOX_INCLUDE_OUTPUT_HPP
+#define CPPLOX_INCLUDE_OUTPUT_HPP
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Buffered sink for program output, written straight to a file descriptor.
+ *
+ * Replaces per-line std::endl flushes with a user-space buffer whose flush policy is selected by FlushMode.
+ */
+class Output {
+   public:
+    enum class FlushMode {
+        LINE,   // Flush after every write containing a newline
+        BLOCK,  // Flush when the buffer fills up
+        EXIT    // Only flush on explicit request, e.g. at exit or before reporting an error
+    };
+
+    static constexpr size_t bufferSize = 64 * 1024;
+
+    /// @brief Creates an output writing to standard output, line-buffered if it is a terminal and block-buffered otherwise.
+    Output();
+    /// @brief Creates an output writing to the given file descriptor with the given flush mode.
+    Output(int, FlushMode);
+    ~Output();
+
+    Output(const Output&) = delete;
+    Output& operator=(const Output&) = delete;
+
+    /// @brief Appends the given text to the buffer, flushing according to the current FlushMode.
+    void write(std::string_view);
+    /// @brief Writes all buffered text to the file descriptor.
+    void flush();
+
+    /// @brief Flushes and changes the flush mode.
+    void setMode(FlushMode);
+    /// @brief Flushes and redirects further output to the given file descriptor.
+    void setFd(int);
+    /// @brief Flushes and redirects further output into the given string instead of the file descriptor, or back to the
+    /// file descriptor if nullptr.
+    void setCapture(std::string*);
+
+    /// @brief Parses a flush mode name ("line", "block" or "exit").
+    static std::optional<FlushMode> parseMode(std::string_view);
+
+   private:
+    int fd;
+    FlushMode mode;
+    std::string buffer;
+    std::string* capture = nullptr;
+
+    /// @brief Writes the given bytes to the capture string or the file descriptor, retrying on partial writes.
+    void writeAll(const char*, size_t);
+};
+
+#endif
@@ -10,6 +10,20 @@
 #include "Stmt.hpp"
 #include "Token.hpp"
 
+/// @brief How tightly an operator binds its operands, from loosest to tightest.
+enum class Precedence {
+    NONE,
+    ASSIGNMENT,  // =
+    OR,          // or
+    AND,         // and
+    EQUALITY,    // == !=
+    COMPARISON,  // < > <= >=
+    TERM,        // + -
+    FACTOR,      // * /
+    UNARY,       // ! -
+    CALL         // . ()
+};
+
 class Parser {
    public:
     Parser(const std::vector<Token>& tok) : tokens(tok) {}
@@ -19,9 +33,15 @@ class Parser {
      */
     std::vector<std::shared_ptr<Stmt>> parse();
 
+    /**
+     * @brief Returns whether a syntax error was found at the end of the tokens, i.e. more input could complete them.
+     */
+    bool isIncomplete() const { return incomplete; }
+
    private:
     std::vector<Token> tokens;
     size_t current = 0;
+    bool incomplete = false;
 
     /// @brief Handles declarations.
     std::shared_ptr<Stmt> declaration();
@@ -34,52 +54,19 @@ class Parser {
      */
     std::shared_ptr<Expr> expression();
 
-    /// @brief Handles assignment expressions.
-    std::shared_ptr<Expr> assignment();
-
-    /// @brief Handles logical or expressions.
-    std::shared_ptr<Expr> logicalOr();
-
-    /// @brief Handles logical and expressions.
-    std::shared_ptr<Expr> logicalAnd();
-
-    /**
-     * @brief Handles equality expressions.
-     */
-    std::shared_ptr<Expr> equality();
-
     /**
-     * @brief Handles comparison/relative expressions.
+     * @brief Parses an expression whose operators bind at least as tightly as the given precedence.
+     *
+     * Operators are looked up in a table by token type, so an operand costs one call however many precedence levels
+     * sit above it, and only nested operands and parentheses recurse.
      */
-    std::shared_ptr<Expr> comparison();
-
-    /**
-     * @brief Handles addition and subtraction.
-     */
-    std::shared_ptr<Expr> term();
-
-    /**
-     * @brief Handles multiplication and division.
-     */
-    std::shared_ptr<Expr> factor();
-
-    /**
-     * @brief Handles unary expressions.
-     */
-    std::shared_ptr<Expr> unary();
+    std::shared_ptr<Expr> parsePrecedence(Precedence);
 
     /**
      * @brief Handles literals and parenthesized expressions.
      */
     std::shared_ptr<Expr> primary();
 
-    /// @brief Handles call expressions.
-    std::shared_ptr<Expr> call();
-
-    /// @brief Helper function to reduce code duplication when parsing (possibly) binary expressions. Defaults to class Binary.
-    template <typename exprClass = Binary, typename... Args>
-    std::shared_ptr<Expr> binaryExpression(std::shared_ptr<Expr> (Parser::*)(), const Args...);
-
     /// @brief Parse a call expression's argument list.
     std::shared_ptr<Expr> finishCall(std::shared_ptr<Expr>);
 
@@ -91,17 +78,17 @@ class Parser {
     bool check(TokenType);
 
     /// @brief Returns the current token without advancing.
-    Token peek();
+    const Token& peek();
     /// @brief Returns the previous token.
-    Token previous();
+    const Token& previous();
 
     /// @brief Check whether the end of the list of tokens has been reached.
     bool isAtEnd();
     /// @brief Advance to the next token.
-    Token advance();
+    const Token& advance();
 
     /// @brief If the current token matches the given TokenType, advance. Otherwise, throw a ParseError.
-    Token consume(TokenType, std::string_view);
+    const Token& consume(TokenType, std::string_view);
 
     /// @brief Report an error and return a ParseError.
     ParseError error(const Token&, std::string_view);
@@ -122,7 +109,7 @@ class Parser {
     std::shared_ptr<While> whileStatement();
 
     /// @brief Handles a for loop.
-    std::shared_ptr<Stmt> forStatement();
+    std::shared_ptr<For> forStatement();
 
     /// @brief Handles a return statement.
     std::shared_ptr<Stmt> returnStatement();
@@ -138,6 +125,9 @@ class Parser {
 
     /// @brief Handle class declaration.
     std::shared_ptr<Class> classDeclaration();
+
+    /// @brief Handle an import declaration. Assumes the IMPORT keyword has been consumed already.
+    std::shared_ptr<Import> importDeclaration();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef CPPLOX_INCLUDE_POOL_HPP
+#define CPPLOX_INCLUDE_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+/**
+ * @brief Size-class slab allocator for small, frequently created runtime objects.
+ *
+ * Blocks are carved out of large slabs and recycled through per-size-class free lists, which are thread-local, so
+ * allocation usually takes no lock. A thread holding more than two slabs' worth of free blocks of a size class, e.g.
+ * because it frees blocks another thread allocated, hands the surplus to a shared depot, and so does a thread that
+ * exits. Threads refill from the depot before carving new slabs, and slabs whose blocks are all back in the depot
+ * are returned to the system.
+ */
+class SlabPool {
+   public:
+    static constexpr size_t granularity = 16;
+    static constexpr size_t maxBlockSize = 256;
+    static constexpr size_t slabSize = 64 * 1024;
+
+    /// @brief Allocation counters of the calling thread. slabs counts the slabs it carved.
+    struct Stats {
+        size_t allocations = 0;
+        size_t deallocations = 0;
+        size_t slabs = 0;
+    };
+
+    /// @brief Returns a block of at least the given size, which must not exceed maxBlockSize.
+    static void* allocate(size_t);
+    /// @brief Returns a block obtained from allocate() with the same size to its free list.
+    static void deallocate(void*, size_t);
+
+    /// @brief Returns the calling thread's allocation counters.
+    static Stats stats();
+    /// @brief Returns the number of slabs currently held by the pool, across all threads.
+    static size_t liveSlabs();
+};
+
+/// @brief Standard allocator that serves single small objects from SlabPool and everything else from operator new.
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n == 1 && sizeof(T) <= SlabPool::maxBlockSize && alignof(T) <= SlabPool::granularity) {
+            return static_cast<T*>(SlabPool::allocate(sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        if (n == 1 && sizeof(T) <= SlabPool::maxBlockSize && alignof(T) <= SlabPool::granularity) {
+            SlabPool::deallocate(p, sizeof(T));
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+};
+
+/// @brief Like std::make_shared, but allocates the object and its control block from SlabPool.
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+#endif
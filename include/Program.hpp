@@ -0,0 +1,34 @@
+#ifndef CPPLOX_INCLUDE_PROGRAM_HPP
+#define CPPLOX_INCLUDE_PROGRAM_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Expr.hpp"
+#include "Stmt.hpp"
+
+/// @brief Resolution results: the number of scopes between each local variable usage and its declaration.
+using ResolvedLocals = std::map<std::shared_ptr<Expr>, size_t>;
+/// @brief The canonical path of the module each import statement refers to.
+using ResolvedImports = std::map<std::shared_ptr<Import>, std::string>;
+
+/**
+ * @brief Source code that has been scanned, parsed and resolved, ready to be run any number of times.
+ *
+ * A program is immutable once compiled and may be run by several isolates, including concurrently.
+ */
+struct Program {
+    std::vector<std::shared_ptr<Stmt>> statements;
+    ResolvedLocals locals;
+    ResolvedImports imports;
+    // Canonical path of the file the program was read from, or empty if there is none. A module importing it back
+    // refers to the program itself, which is already running.
+    std::string path;
+    // Every module imported directly or indirectly, by canonical path. Only filled in for the program being run,
+    // since a cached module may be imported alongside different versions of its own imports.
+    std::map<std::string, std::shared_ptr<const Program>> modules;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef CPPLOX_INCLUDE_REGISTERVM_HPP
+#define CPPLOX_INCLUDE_REGISTERVM_HPP
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Environment.hpp"
+#include "Ir.hpp"
+
+class Interpreter;
+
+/**
+ * @brief Register code for one function, translated from its optimized SSA form, and the machine executing it.
+ *
+ * Every SSA value gets its own register. Phis are resolved by moving each incoming value into a shadow register
+ * at the end of the predecessor, then into the phi's register at the start of its block, so the moves of one edge
+ * act as a parallel copy.
+ */
+class RegisterVm {
+   public:
+    explicit RegisterVm(const IrFunction&);
+
+    /// @brief Runs the function with the given closure environment and arguments, returning its return value.
+    std::any execute(Interpreter&, const std::shared_ptr<Environment>&, const std::vector<std::any>&) const;
+
+   private:
+    enum class Op : uint8_t {
+        MOVE,
+        CONST,
+        PARAM,
+        LOAD_GLOBAL,
+        STORE_GLOBAL,
+        LOAD_ENV,
+        STORE_ENV,
+        CHECK_NUMBER,
+        ADD,
+        ADD_NUMBER,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        NEGATE,
+        NOT,
+        EQUAL,
+        NOT_EQUAL,
+        GREATER,
+        GREATER_EQUAL,
+        LESS,
+        LESS_EQUAL,
+        GREATER_NUMBER,
+        GREATER_EQUAL_NUMBER,
+        LESS_NUMBER,
+        LESS_EQUAL_NUMBER,
+        CALL,
+        GET,
+        FIELD_TARGET,
+        SET,
+        SUPER,
+        PRINT,
+        JUMP,
+        BRANCH,
+        RETURN
+    };
+
+    struct Instruction {
+        Op op;
+        // Destination and operand registers, or jump targets for JUMP and BRANCH
+        uint32_t target = 0;
+        uint32_t a = 0;
+        uint32_t b = 0;
+        // Index of a constant, parameter or argument list, or environment depth
+        uint32_t index = 0;
+        const Token* token = nullptr;
+    };
+
+    std::vector<Instruction> code;
+    std::vector<std::any> constants;
+    // Argument registers of every call, each call's a contiguous run starting at its index
+    std::vector<uint32_t> arguments;
+    size_t registerCount = 0;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef CPPLOX_INCLUDE_REPLSESSION_HPP
+#define CPPLOX_INCLUDE_REPLSESSION_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Isolate.hpp"
+#include "Program.hpp"
+#include "Resolver.hpp"
+
+/**
+ * @brief Interactive session on an isolate, fed one line of input at a time.
+ *
+ * Lines are accumulated until they form complete declarations, so a function or class may span several lines; a
+ * blank line ends the pending input as it is. Each completed chunk is resolved by the session's resolver and run.
+ * Afterwards its syntax tree and resolution results are released, unless a function or class it declared is still
+ * reachable, so a session's memory only grows with the definitions that are still alive.
+ */
+class ReplSession {
+   public:
+    explicit ReplSession(Isolate& iso) : isolate(iso) {}
+
+    ReplSession(const ReplSession&) = delete;
+    ReplSession& operator=(const ReplSession&) = delete;
+
+    /// @brief Adds a line of input. Returns false if more lines are needed, or true once the pending input has
+    /// been run or its errors reported.
+    bool feed(const std::string&);
+
+    /// @brief Returns whether earlier lines are waiting to be completed.
+    bool isPending() const { return !buffer.empty(); }
+    /// @brief Returns the number of programs kept alive because code they declared is still reachable.
+    size_t retainedCount() const { return retained.size(); }
+
+   private:
+    Isolate& isolate;
+    // Lines of the declaration being entered
+    std::string buffer;
+
+    ResolvedLocals resolved;
+    Resolver resolver{resolved};
+
+    // Programs that have run and still declare reachable functions or classes
+    std::vector<std::shared_ptr<const Program>> retained;
+
+    /// @brief Unloads every retained program whose functions and classes are no longer reachable.
+    void release();
+};
+
+#endif
@@ -2,12 +2,25 @@
 #define CPPLOX_INCLUDE_RESOLVER_HPP
 
 #include <stack>
+#include <string>
+#include <vector>
 
 #include "Expr.hpp"
 #include "Interpreter.hpp"
 #include "Stmt.hpp"
 
-class Resolver : public ExprVisitor, public StmtVisitor {
+/// @brief The super expressions in a subclass's methods, whose methods the Interpreter looks up once per class.
+struct SuperMethods {
+    // Name of the method each super expression refers to, by SuperSite::index
+    std::vector<std::string> names;
+};
+
+/// @brief Which of its class's SuperMethods a super expression refers to.
+struct SuperSite {
+    size_t index;
+};
+
+class Resolver : public ExprVisitor<void>, public StmtVisitor<void> {
     enum class FunctionType {
         NONE,
         FUNCTION,
@@ -21,40 +34,45 @@ class Resolver : public ExprVisitor, public StmtVisitor {
     };
 
    public:
-    Resolver(Interpreter& interp) : interpreter(interp) {}
+    /// @brief Creates a resolver that records its results in the given table.
+    Resolver(ResolvedLocals& res) : locals(res) {}
 
-    std::any visitAssignExpr(std::shared_ptr<Assign>) override;
-    std::any visitBinaryExpr(std::shared_ptr<Binary>) override;
-    std::any visitCallExpr(std::shared_ptr<Call>) override;
-    std::any visitGetExpr(std::shared_ptr<Get>) override;
-    std::any visitGroupingExpr(std::shared_ptr<Grouping>) override;
-    std::any visitLiteralExpr(std::shared_ptr<Literal>) override;
-    std::any visitLogicalExpr(std::shared_ptr<Logical>) override;
-    std::any visitSetExpr(std::shared_ptr<Set>) override;
-    std::any visitSuperExpr(std::shared_ptr<Super>) override;
-    std::any visitThisExpr(std::shared_ptr<This>) override;
-    std::any visitUnaryExpr(std::shared_ptr<Unary>) override;
-    std::any visitVariableExpr(std::shared_ptr<Variable>) override;
+    void visitAssignExpr(std::shared_ptr<Assign>);
+    void visitBinaryExpr(std::shared_ptr<Binary>);
+    void visitCallExpr(std::shared_ptr<Call>);
+    void visitGetExpr(std::shared_ptr<Get>);
+    void visitGroupingExpr(std::shared_ptr<Grouping>);
+    void visitLiteralExpr(std::shared_ptr<Literal>);
+    void visitLogicalExpr(std::shared_ptr<Logical>);
+    void visitSetExpr(std::shared_ptr<Set>);
+    void visitSuperExpr(std::shared_ptr<Super>);
+    void visitThisExpr(std::shared_ptr<This>);
+    void visitUnaryExpr(std::shared_ptr<Unary>);
+    void visitVariableExpr(std::shared_ptr<Variable>);
 
-    std::any visitBlockStmt(std::shared_ptr<Block>) override;
-    std::any visitClassStmt(std::shared_ptr<Class>) override;
-    std::any visitExpressionStmt(std::shared_ptr<Expression>) override;
-    std::any visitFunctionStmt(std::shared_ptr<Function>) override;
-    std::any visitIfStmt(std::shared_ptr<If>) override;
-    std::any visitPrintStmt(std::shared_ptr<Print>) override;
-    std::any visitReturnStmt(std::shared_ptr<Return>) override;
-    std::any visitVarStmt(std::shared_ptr<Var>) override;
-    std::any visitWhileStmt(std::shared_ptr<While>) override;
+    void visitBlockStmt(std::shared_ptr<Block>);
+    void visitClassStmt(std::shared_ptr<Class>);
+    void visitExpressionStmt(std::shared_ptr<Expression>);
+    void visitForStmt(std::shared_ptr<For>);
+    void visitFunctionStmt(std::shared_ptr<Function>);
+    void visitIfStmt(std::shared_ptr<If>);
+    void visitImportStmt(std::shared_ptr<Import>);
+    void visitPrintStmt(std::shared_ptr<Print>);
+    void visitReturnStmt(std::shared_ptr<Return>);
+    void visitVarStmt(std::shared_ptr<Var>);
+    void visitWhileStmt(std::shared_ptr<While>);
 
     /// @brief Resolves a list of statements.
     void resolve(const std::vector<std::shared_ptr<Stmt>>&);
 
    private:
-    Interpreter& interpreter;
+    ResolvedLocals& locals;
     std::stack<std::map<std::string, bool>> scopes;
 
     FunctionType currentFunction = FunctionType::NONE;
     ClassType currentClass = ClassType::NONE;
+    // Super expressions of the innermost class with a superclass, or nullptr outside of one
+    SuperMethods* currentSuperMethods = nullptr;
 
     /// @brief Begins a new scope. i.e. pushes a new scope onto the stack.
     void beginScope();
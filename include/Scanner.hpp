@@ -16,6 +16,11 @@ class Scanner {
      */
     std::vector<Token> scanTokens();
 
+    /**
+     * @brief Returns whether the source ended inside a string or block comment, i.e. more input could complete it.
+     */
+    bool isIncomplete() const { return incomplete; }
+
    private:
     std::string source;
     std::vector<Token> tokens;
@@ -26,6 +31,8 @@ class Scanner {
 
     size_t sourceLen;
 
+    bool incomplete = false;
+
     /**
      * @brief Checks whether end of source has been reached.
      */
@@ -0,0 +1,74 @@
+#ifndef CPPLOX_INCLUDE_SCHEDULER_HPP
+#define CPPLOX_INCLUDE_SCHEDULER_HPP
+
+#include <any>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "EventLoop.hpp"
+
+class Interpreter;
+class LoxCallable;
+class LoxTask;
+
+/**
+ * @brief Run queue of cooperative tasks sharing one interpreter and one thread.
+ *
+ * Tasks run until they yield, await an unfinished task or finish, at which point the task at the front of the run
+ * queue takes over. The main program is a task too, created when the first task is spawned. Spawned tasks first
+ * run when the current task gives way, and any still pending when the main program ends are run to completion.
+ */
+class Scheduler {
+   public:
+    explicit Scheduler(Interpreter& interp) : interpreter(interp) {}
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    /// @brief Creates a task that will call the given function with no arguments, and queues it.
+    std::shared_ptr<LoxTask> spawn(std::shared_ptr<LoxCallable>);
+    /// @brief Moves the current task to the back of the run queue, letting every queued task run first.
+    void yield();
+    /// @brief Blocks the current task until the given task has finished, then returns its result or rethrows its error.
+    std::any await(LoxTask&);
+
+    /// @brief Returns the running task, creating the main program's task if no task exists yet.
+    std::shared_ptr<LoxTask> running();
+    /// @brief Suspends the running task until it is passed to resume(). The caller must keep hold of the task.
+    void suspend();
+    /// @brief Queues a suspended task to continue.
+    void resume(std::shared_ptr<LoxTask>);
+    /// @brief Returns the event loop, creating it on first use.
+    EventLoop& getEvents();
+
+    /// @brief Runs queued tasks until all of them have finished. Rethrows the first error no task has awaited.
+    void finishAll();
+    /// @brief Cancels every queued and blocked task, e.g. after the main program failed. Tasks that have started are
+    /// resumed one last time to unwind their stacks, so everything their frames own is released. Must be called from
+    /// the main program's task.
+    void abandon();
+
+   private:
+    Interpreter& interpreter;
+    // The running task, or nullptr if no task has been spawned yet
+    std::shared_ptr<LoxTask> current;
+    std::deque<std::shared_ptr<LoxTask>> runQueue;
+    // A task that has just finished, whose stack is released by the next task once it is off that stack
+    std::shared_ptr<LoxTask> finishedTask;
+    // Tasks that failed before anything awaited them
+    std::vector<std::shared_ptr<LoxTask>> failed;
+    std::unique_ptr<EventLoop> events;
+
+    /// @brief Coroutine entry point of a spawned task.
+    static void run(void*);
+    /// @brief Marks the current task as finished, wakes its waiters and switches away for good.
+    void finish(LoxTask&);
+    /// @brief Suspends the given task, which must be the running one, and resumes the front of the run queue.
+    void switchFrom(LoxTask&);
+    /// @brief Releases the stack of the task that finished last, if any.
+    void releaseFinished();
+};
+
+#endif
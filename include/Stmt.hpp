@@ -3,6 +3,7 @@
 
 #include <any>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "../include/Token.hpp"
@@ -11,73 +12,87 @@
 class Block;
 class Class;
 class Expression;
+class For;
 class Function;
 class If;
+class Import;
 class Print;
 class Return;
 class Var;
 class While;
-
+struct SuperMethods;
+struct LoopPlan;
+struct ScalarSite;
+
+/// @brief The class of a node, which visits dispatch on.
+enum class StmtKind { BLOCK, CLASS, EXPRESSION, FOR, FUNCTION, IF, IMPORT, PRINT, RETURN, VAR, WHILE };
+
+/**
+ * @brief Base of visitors whose visit methods, visit<Kind>Stmt for each kind of node, all return R.
+ *
+ * Nodes dispatch on their kind rather than through virtual calls, and return the result without boxing it.
+ */
+template <typename R>
 struct StmtVisitor {
-    virtual std::any visitBlockStmt(std::shared_ptr<Block> stmt) = 0;
-    virtual std::any visitClassStmt(std::shared_ptr<Class> stmt) = 0;
-    virtual std::any visitExpressionStmt(std::shared_ptr<Expression> stmt) = 0;
-    virtual std::any visitFunctionStmt(std::shared_ptr<Function> stmt) = 0;
-    virtual std::any visitIfStmt(std::shared_ptr<If> stmt) = 0;
-    virtual std::any visitPrintStmt(std::shared_ptr<Print> stmt) = 0;
-    virtual std::any visitReturnStmt(std::shared_ptr<Return> stmt) = 0;
-    virtual std::any visitVarStmt(std::shared_ptr<Var> stmt) = 0;
-    virtual std::any visitWhileStmt(std::shared_ptr<While> stmt) = 0;
-    virtual ~StmtVisitor() = default;
+    using StmtResult = R;
 };
 
 class Stmt {
    public:
-    virtual std::any accept(StmtVisitor& visitor) = 0;
+    virtual ~Stmt() = default;
+
+    /// @brief Calls the visit method of the given visitor for this node's kind, returning its result.
+    template <typename Visitor>
+    typename Visitor::StmtResult accept(Visitor& visitor);
+
+    const StmtKind kind;
+
+   protected:
+    explicit Stmt(StmtKind kind) : kind(kind) {}
 };
 
 class Block : public Stmt, public std::enable_shared_from_this<Block> {
    public:
-    Block(const std::vector<std::shared_ptr<Stmt>>& statements) : statements(statements) {}
-
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitBlockStmt(shared_from_this());
-    }
+    Block(const std::vector<std::shared_ptr<Stmt>>& statements) : Stmt(StmtKind::BLOCK), statements(statements) {}
 
     const std::vector<std::shared_ptr<Stmt>> statements;
 };
 
 class Class : public Stmt, public std::enable_shared_from_this<Class> {
    public:
-    Class(const Token& name, std::shared_ptr<Variable> superclass, const std::vector<std::shared_ptr<Function>>& methods) : name(name), superclass(superclass), methods(methods) {}
-
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitClassStmt(shared_from_this());
-    }
+    Class(const Token& name, std::shared_ptr<Variable> superclass, const std::vector<std::shared_ptr<Function>>& methods) : Stmt(StmtKind::CLASS), name(name), superclass(superclass), methods(methods) {}
 
     const Token name;
     const std::shared_ptr<Variable> superclass;
     const std::vector<std::shared_ptr<Function>> methods;
+
+    // Filled in by optimization passes
+    std::shared_ptr<SuperMethods> superMethods;
 };
 
 class Expression : public Stmt, public std::enable_shared_from_this<Expression> {
    public:
-    Expression(std::shared_ptr<Expr> expression) : expression(expression) {}
-
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitExpressionStmt(shared_from_this());
-    }
+    Expression(std::shared_ptr<Expr> expression) : Stmt(StmtKind::EXPRESSION), expression(expression) {}
 
     const std::shared_ptr<Expr> expression;
 };
 
-class Function : public Stmt, public std::enable_shared_from_this<Function> {
+class For : public Stmt, public std::enable_shared_from_this<For> {
    public:
-    Function(const Token& name, const std::vector<Token>& params, const std::vector<std::shared_ptr<Stmt>>& body) : name(name), params(params), body(body) {}
+    For(std::shared_ptr<Stmt> initializer, std::shared_ptr<Expr> condition, std::shared_ptr<Expr> increment, std::shared_ptr<Stmt> body) : Stmt(StmtKind::FOR), initializer(initializer), condition(condition), increment(increment), body(body) {}
 
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitFunctionStmt(shared_from_this());
-    }
+    const std::shared_ptr<Stmt> initializer;
+    const std::shared_ptr<Expr> condition;
+    const std::shared_ptr<Expr> increment;
+    const std::shared_ptr<Stmt> body;
+
+    // Filled in by optimization passes
+    std::shared_ptr<LoopPlan> plan;
+};
+
+class Function : public Stmt, public std::enable_shared_from_this<Function> {
+   public:
+    Function(const Token& name, const std::vector<Token>& params, const std::vector<std::shared_ptr<Stmt>>& body) : Stmt(StmtKind::FUNCTION), name(name), params(params), body(body) {}
 
     const Token name;
     const std::vector<Token> params;
@@ -86,35 +101,31 @@ class Function : public Stmt, public std::enable_shared_from_this<Function> {
 
 class If : public Stmt, public std::enable_shared_from_this<If> {
    public:
-    If(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> thenBranch, std::shared_ptr<Stmt> elseBranch) : condition(condition), thenBranch(thenBranch), elseBranch(elseBranch) {}
-
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitIfStmt(shared_from_this());
-    }
+    If(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> thenBranch, std::shared_ptr<Stmt> elseBranch) : Stmt(StmtKind::IF), condition(condition), thenBranch(thenBranch), elseBranch(elseBranch) {}
 
     const std::shared_ptr<Expr> condition;
     const std::shared_ptr<Stmt> thenBranch;
     const std::shared_ptr<Stmt> elseBranch;
 };
 
-class Print : public Stmt, public std::enable_shared_from_this<Print> {
+class Import : public Stmt, public std::enable_shared_from_this<Import> {
    public:
-    Print(std::shared_ptr<Expr> expression) : expression(expression) {}
+    Import(const Token& keyword, const Token& path) : Stmt(StmtKind::IMPORT), keyword(keyword), path(path) {}
 
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitPrintStmt(shared_from_this());
-    }
+    const Token keyword;
+    const Token path;
+};
+
+class Print : public Stmt, public std::enable_shared_from_this<Print> {
+   public:
+    Print(std::shared_ptr<Expr> expression) : Stmt(StmtKind::PRINT), expression(expression) {}
 
     const std::shared_ptr<Expr> expression;
 };
 
 class Return : public Stmt, public std::enable_shared_from_this<Return> {
    public:
-    Return(const Token& keyword, std::shared_ptr<Expr> value) : keyword(keyword), value(value) {}
-
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitReturnStmt(shared_from_this());
-    }
+    Return(const Token& keyword, std::shared_ptr<Expr> value) : Stmt(StmtKind::RETURN), keyword(keyword), value(value) {}
 
     const Token keyword;
     const std::shared_ptr<Expr> value;
@@ -122,26 +133,50 @@ class Return : public Stmt, public std::enable_shared_from_this<Return> {
 
 class Var : public Stmt, public std::enable_shared_from_this<Var> {
    public:
-    Var(const Token& name, std::shared_ptr<Expr> initializer) : name(name), initializer(initializer) {}
-
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitVarStmt(shared_from_this());
-    }
+    Var(const Token& name, std::shared_ptr<Expr> initializer) : Stmt(StmtKind::VAR), name(name), initializer(initializer) {}
 
     const Token name;
     const std::shared_ptr<Expr> initializer;
+
+    // Filled in by optimization passes
+    std::shared_ptr<ScalarSite> scalar;
 };
 
 class While : public Stmt, public std::enable_shared_from_this<While> {
    public:
-    While(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> body) : condition(condition), body(body) {}
-
-    std::any accept(StmtVisitor& visitor) override {
-        return visitor.visitWhileStmt(shared_from_this());
-    }
+    While(std::shared_ptr<Expr> condition, std::shared_ptr<Stmt> body) : Stmt(StmtKind::WHILE), condition(condition), body(body) {}
 
     const std::shared_ptr<Expr> condition;
     const std::shared_ptr<Stmt> body;
 };
 
+template <typename Visitor>
+typename Visitor::StmtResult Stmt::accept(Visitor& visitor) {
+    switch (kind) {
+        case StmtKind::BLOCK:
+            return visitor.visitBlockStmt(static_cast<Block*>(this)->shared_from_this());
+        case StmtKind::CLASS:
+            return visitor.visitClassStmt(static_cast<Class*>(this)->shared_from_this());
+        case StmtKind::EXPRESSION:
+            return visitor.visitExpressionStmt(static_cast<Expression*>(this)->shared_from_this());
+        case StmtKind::FOR:
+            return visitor.visitForStmt(static_cast<For*>(this)->shared_from_this());
+        case StmtKind::FUNCTION:
+            return visitor.visitFunctionStmt(static_cast<Function*>(this)->shared_from_this());
+        case StmtKind::IF:
+            return visitor.visitIfStmt(static_cast<If*>(this)->shared_from_this());
+        case StmtKind::IMPORT:
+            return visitor.visitImportStmt(static_cast<Import*>(this)->shared_from_this());
+        case StmtKind::PRINT:
+            return visitor.visitPrintStmt(static_cast<Print*>(this)->shared_from_this());
+        case StmtKind::RETURN:
+            return visitor.visitReturnStmt(static_cast<Return*>(this)->shared_from_this());
+        case StmtKind::VAR:
+            return visitor.visitVarStmt(static_cast<Var*>(this)->shared_from_this());
+        case StmtKind::WHILE:
+            return visitor.visitWhileStmt(static_cast<While*>(this)->shared_from_this());
+    }
+    std::unreachable();
+}
+
 #endif
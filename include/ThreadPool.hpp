@@ -0,0 +1,63 @@
+#ifndef CPPLOX_INCLUDE_THREADPOOL_HPP
+#define CPPLOX_INCLUDE_THREADPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads with work stealing.
+ *
+ * Each worker owns a deque of tasks. It runs its own tasks newest first and, when it runs out, steals the oldest
+ * task from another worker. Tasks submitted from inside a task go to the submitting worker's deque; others are
+ * spread round-robin.
+ */
+class ThreadPool {
+   public:
+    using Task = std::function<void()>;
+
+    /// @brief Starts the given number of workers, defaulting to one per hardware thread.
+    explicit ThreadPool(size_t = std::thread::hardware_concurrency());
+    /// @brief Finishes all submitted tasks, then stops the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// @brief Queues a task to be run by some worker.
+    void submit(Task);
+    /// @brief Blocks until every submitted task has finished.
+    void wait();
+
+    size_t size() const { return threads.size(); }
+
+   private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // Guards sleeping and waking; the counters are atomic so the fast paths don't need it
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> nextWorker{0};
+    bool stopping = false;
+
+    /// @brief Takes a task from the given worker's deque or, failing that, steals one. Returns false if there is none.
+    bool tryRun(size_t);
+    /// @brief Main loop of the worker with the given index.
+    void work(size_t);
+};
+
+#endif
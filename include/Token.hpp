@@ -48,6 +48,7 @@ enum class TokenType {
     FUN,
     FOR,
     IF,
+    IMPORT,
     NIL,
     OR,
     PRINT,
@@ -0,0 +1,97 @@
+#ifndef CPPLOX_INCLUDE_TYPEINFERENCE_HPP
+#define CPPLOX_INCLUDE_TYPEINFERENCE_HPP
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "ClosureAnalysis.hpp"
+#include "Expr.hpp"
+#include "Program.hpp"
+#include "Stmt.hpp"
+
+/**
+ * @brief Infers the static type of every expression of a resolved program, so the Interpreter can skip the runtime
+ * checks of operations whose operands are proven to be numbers.
+ *
+ * The analysis is flow-sensitive over the locals of each function: a variable takes the type of the value last
+ * assigned to it, branches are joined, and loops are iterated to a fixpoint. A variable used as an operand of an
+ * operation that only succeeds on numbers is known to hold a number afterwards, so parameters used numerically are
+ * proven too. Globals and variables captured by closures may change behind the analysis' back and are never proven.
+ */
+class TypeInference : public ExprVisitor<unsigned>, public StmtVisitor<void> {
+   public:
+    // Set of the types a value may have, one bit per StaticType other than UNKNOWN plus one for objects
+    using Types = ExprResult;
+
+    explicit TypeInference(const ResolvedLocals& locals) : locals(locals) {}
+
+    /// @brief Annotates the expressions of the given top-level statements with their static types.
+    void infer(const std::vector<std::shared_ptr<Stmt>>&);
+
+    Types visitAssignExpr(std::shared_ptr<Assign>);
+    Types visitBinaryExpr(std::shared_ptr<Binary>);
+    Types visitCallExpr(std::shared_ptr<Call>);
+    Types visitGetExpr(std::shared_ptr<Get>);
+    Types visitGroupingExpr(std::shared_ptr<Grouping>);
+    Types visitLiteralExpr(std::shared_ptr<Literal>);
+    Types visitLogicalExpr(std::shared_ptr<Logical>);
+    Types visitSetExpr(std::shared_ptr<Set>);
+    Types visitSuperExpr(std::shared_ptr<Super>);
+    Types visitThisExpr(std::shared_ptr<This>);
+    Types visitUnaryExpr(std::shared_ptr<Unary>);
+    Types visitVariableExpr(std::shared_ptr<Variable>);
+
+    void visitBlockStmt(std::shared_ptr<Block>);
+    void visitClassStmt(std::shared_ptr<Class>);
+    void visitExpressionStmt(std::shared_ptr<Expression>);
+    void visitForStmt(std::shared_ptr<For>);
+    void visitFunctionStmt(std::shared_ptr<Function>);
+    void visitIfStmt(std::shared_ptr<If>);
+    void visitImportStmt(std::shared_ptr<Import>);
+    void visitPrintStmt(std::shared_ptr<Print>);
+    void visitReturnStmt(std::shared_ptr<Return>);
+    void visitVarStmt(std::shared_ptr<Var>);
+    void visitWhileStmt(std::shared_ptr<While>);
+
+   private:
+    using Slot = ClosureAnalysis::Slot;
+
+    /// @brief Types of the tracked variables at a point of the function being analyzed.
+    struct State {
+        // Whether the point can be reached at all, as it can't after a return
+        bool reachable = true;
+        std::map<const Slot*, Types> variables;
+
+        bool operator==(const State&) const = default;
+    };
+
+    const ResolvedLocals& locals;
+    ClosureAnalysis::Closures closures;
+    State state;
+    // Every type each expression was seen with, over all iterations of the loops around it
+    std::map<Expr*, Types> seen;
+
+    /// @brief Returns the types the given expression may evaluate to, updating the state with its effects.
+    Types infer(const std::shared_ptr<Expr>&);
+    void execute(const std::vector<std::shared_ptr<Stmt>>&);
+    void execute(const std::shared_ptr<Stmt>&);
+    /// @brief Runs a loop with the given condition, body and increment, any of which but the body may be nullptr.
+    void inferLoop(const std::shared_ptr<Expr>&, const std::shared_ptr<Stmt>&, const std::shared_ptr<Expr>&);
+    void inferFunction(const std::shared_ptr<Function>&);
+
+    /// @brief Returns the variable the given expression refers to if its type is tracked, otherwise nullptr.
+    const Slot* tracked(const Expr*) const;
+    /// @brief Records that the given operand, which an operation just checked, holds a number, unless the given
+    /// operand evaluated after it may have assigned to it since.
+    void refine(const std::shared_ptr<Expr>&, const std::shared_ptr<Expr>& = nullptr);
+    /// @brief Records the types of the variable declared by the given node or token, if it is tracked.
+    void define(const void*, Types);
+
+    static State join(const State&, const State&);
+    /// @brief Returns whether evaluating the given expression may assign to the given variable.
+    bool assigns(const std::shared_ptr<Expr>&, const Slot*) const;
+    static StaticType toStaticType(Types);
+};
+
+#endif
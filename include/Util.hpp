@@ -2,6 +2,10 @@
 #define CPPLOX_INCLUDE_UTIL_HPP
 
 #include <any>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <string>
 
 /**
@@ -18,6 +22,31 @@ inline std::string boolToString(const std::any& obj) {
     return boolToString(std::any_cast<bool>(obj));
 }
 
+/**
+ * @brief Converts a given double to the shortest string that round-trips to the same value.
+ *
+ * Integral values print in fixed notation without a fractional part, however large. Formatting is done in a stack
+ * buffer and does not depend on the current locale.
+ */
+inline std::string numberToString(double d) {
+    // Room for the sign and every digit of the largest finite double in fixed notation
+    char buffer[std::numeric_limits<double>::max_exponent10 + 3];
+    std::to_chars_result result;
+
+    // Integer fast path; 2^53 is the largest magnitude below which every integer is exactly representable
+    if (std::abs(d) < 9007199254740992.0 && d == std::trunc(d) && !(d == 0 && std::signbit(d))) {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), static_cast<int64_t>(d));
+    }
+    else if (std::isfinite(d) && d == std::trunc(d)) {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), d, std::chars_format::fixed);
+    }
+    else {
+        result = std::to_chars(buffer, buffer + sizeof(buffer), d);
+    }
+
+    return std::string(buffer, result.ptr);
+}
+
 /// @brief If the given std::any holds a std::shared_ptr to the specified type, return a casted std::shared_ptr. Otherwise, return nullptr.
 template <typename T>
 std::shared_ptr<T> ptrAnyCast(const std::any& obj) {
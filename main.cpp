@@ -1,24 +1,36 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <exception>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <optional>
 #include <string>
-#include <vector>
+#include <string_view>
 
-#include "include/AstPrinter.hpp"
-#include "include/Error.hpp"
-#include "include/Interpreter.hpp"
-#include "include/Parser.hpp"
-#include "include/Resolver.hpp"
-#include "include/Scanner.hpp"
-#include "include/Token.hpp"
-
-#define DEBUG_PRINT 0
-
-extern bool hadError;
-extern bool hadRuntimeError;
+#include "include/Batch.hpp"
+#include "include/CppEmitter.hpp"
+#include "include/IrBuilder.hpp"
+#include "include/IrPasses.hpp"
+#include "include/Isolate.hpp"
+#include "include/Output.hpp"
+#include "include/ReplSession.hpp"
 
 namespace {
-Interpreter interpreter;
+Isolate isolate;
+std::terminate_handler defaultTerminate;
+
+/// @brief Parses a non-negative decimal option value, or returns std::nullopt if it isn't one or doesn't fit an int.
+std::optional<int> parseNonNegative(std::string_view value) {
+    int result = 0;
+    auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (value.empty() || ec != std::errc() || end != value.data() + value.size() || result < 0) {
+        return std::nullopt;
+    }
+    return result;
 }
+}  // namespace
 
 /**
  * @brief Reads source code from a file and executes it.
@@ -32,15 +44,112 @@ void runFile(const std::string& path);
  */
 void runPrompt();
 
+/**
+ * @brief Runs many scripts concurrently, then prints their output in order followed by a timing summary.
+ *
+ * @param path: std::string containing a directory of scripts or a file listing one script path per line.
+ * @return The highest exit code of any script, or 0 if all of them succeeded.
+ */
+int runScripts(const std::string& path);
+
+/**
+ * @brief Compiles a script and the modules it imports to a standalone C++ translation unit.
+ *
+ * @param out: std::string containing the path of the C++ file to write.
+ * @param path: std::string containing the script's path.
+ * @return 0 on success, 65 if the script had a compile error, or 73 if the C++ file couldn't be written.
+ */
+int emitCpp(const std::string& out, const std::string& path);
+
+/**
+ * @brief Prints the optimized SSA form of every function in a script and the modules it imports.
+ *
+ * @param path: std::string containing the script's path.
+ * @return 0 on success, or 65 if the script had a compile error.
+ */
+int dumpIr(const std::string& path);
+
 int main(int argc, char* argv[]) {
+    const std::string usage = "Usage: cpplox [--flush=line|block|exit] [--output-fd=<fd>] [--opt-level=<n>] [--vm] [--batch <dir|list> | --emit-cpp <out.cpp> script | --dump-ir script | script]";
+    Output& output = isolate.getOutput();
+
+    // Keep what was already printed if an uncaught exception ends the process
+    defaultTerminate = std::set_terminate([] {
+        isolate.getOutput().flush();
+        defaultTerminate();
+    });
+
+    // Parse options
+    std::optional<std::string> batch;
+    std::optional<std::string> emitPath;
+    bool irDump = false;
+    int argi = 1;
+    for (; argi < argc && std::string_view(argv[argi]).starts_with("--"); ++argi) {
+        std::string_view arg = argv[argi];
+
+        if (arg.starts_with("--flush=")) {
+            auto mode = Output::parseMode(arg.substr(std::string_view("--flush=").size()));
+            if (!mode) {
+                std::cerr << usage << std::endl;
+                exit(64);
+            }
+            output.setMode(*mode);
+        }
+        else if (arg.starts_with("--output-fd=")) {
+            auto fd = parseNonNegative(arg.substr(std::string_view("--output-fd=").size()));
+            if (!fd) {
+                std::cerr << usage << std::endl;
+                exit(64);
+            }
+            output.setFd(*fd);
+        }
+        else if (arg.starts_with("--opt-level=")) {
+            auto level = parseNonNegative(arg.substr(std::string_view("--opt-level=").size()));
+            if (!level) {
+                std::cerr << usage << std::endl;
+                exit(64);
+            }
+            isolate.getInterpreter().setOptimizationLevel(*level);
+        }
+        else if (arg == "--batch" && argi + 1 < argc) {
+            batch = argv[++argi];
+        }
+        else if (arg == "--emit-cpp" && argi + 1 < argc) {
+            emitPath = argv[++argi];
+        }
+        else if (arg == "--dump-ir") {
+            irDump = true;
+        }
+        else if (arg == "--vm") {
+            isolate.getInterpreter().setRegisterVm(true);
+        }
+        else {
+            std::cerr << usage << std::endl;
+            exit(64);
+        }
+    }
+
     // Incorrect usage
-    if (argc > 2) {
-        std::cerr << "Usage: cpplox [script]" << std::endl;
+    if (argc - argi > (batch ? 0 : 1) || (emitPath && (batch || argc - argi != 1)) ||
+        (irDump && (batch || emitPath || argc - argi != 1))) {
+        std::cerr << usage << std::endl;
         exit(64);
     }
+    // Translate a script to C++ instead of running it
+    else if (emitPath) {
+        return emitCpp(*emitPath, argv[argi]);
+    }
+    // Show what the register VM would run
+    else if (irDump) {
+        return dumpIr(argv[argi]);
+    }
+    // Run a batch of scripts
+    else if (batch) {
+        return runScripts(*batch);
+    }
     // Read source code from file
-    else if (argc == 2) {
-        runFile(argv[1]);
+    else if (argc - argi == 1) {
+        runFile(argv[argi]);
     }
     // Interact with user through command prompt
     else {
@@ -49,44 +158,6 @@ int main(int argc, char* argv[]) {
     return 0;
 }
 
-/**
- * @brief Reads and executes source code in the form of a std::string.
- *
- * @param source: std::string containing the code to be run.
- */
-void run(const std::string& source) {
-    Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
-#if DEBUG_PRINT != 0
-    std::cout << "Scanning completed" << std::endl;
-#endif
-
-    Parser parser(tokens);
-    std::vector<std::shared_ptr<Stmt>> stmts = parser.parse();
-    // Check for syntax error
-    if (hadError) {
-        return;
-    }
-#if DEBUG_PRINT != 0
-    std::cout << "Parsing completed" << std::endl;
-#endif
-
-    Resolver resolver(interpreter);
-    resolver.resolve(stmts);
-    // Check for resolution error
-    if (hadError) {
-        return;
-    }
-#if DEBUG_PRINT != 0
-    std::cout << "Resolution completed" << std::endl;
-#endif
-
-    interpreter.interpret(stmts);
-#if DEBUG_PRINT != 0
-    std::cout << "Interpreting completed" << std::endl;
-#endif
-}
-
 void runFile(const std::string& path) {
     // Get source code from path
     std::ifstream inFile(path);
@@ -95,27 +166,120 @@ void runFile(const std::string& path) {
     std::string fileContents(begin, end);
 
     // Execute source code
-    run(fileContents);
+    isolate.run(fileContents, path);
 
     // Terminate program if error was found
-    if (hadError) {
+    isolate.getOutput().flush();
+    if (isolate.hadError()) {
         exit(65);
     }
-    else if (hadRuntimeError) {
+    else if (isolate.hadRuntimeError()) {
         exit(70);
     }
 }
 
 void runPrompt() {
     std::string line;
+    Output& output = isolate.getOutput();
+    ReplSession session(isolate);
 
     // Get code from user
-    std::cout << "> ";
+    output.write("> ");
+    output.flush();
     while (std::getline(std::cin, line)) {
-        std::cout << "> ";
-        run(line);
+        session.feed(line);
+
+        // Show everything the line printed before prompting again, continuing unfinished declarations
+        output.write(session.isPending() ? "... " : "> ");
+        output.flush();
 
         // Errors shouldn't stop line-by-line prompt code input
-        hadError = false;
+        isolate.clearErrors();
+    }
+}
+
+int runScripts(const std::string& path) {
+    auto scripts = collectBatchScripts(path);
+    if (!scripts) {
+        std::cerr << "Could not read batch '" << path << "'." << std::endl;
+        return 66;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = runBatch(*scripts);
+    std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - start;
+
+    // Print each script's output as if the scripts had run one after another
+    Output& output = isolate.getOutput();
+    for (const BatchResult& result : results) {
+        output.write(result.output);
+        if (!result.errors.empty()) {
+            output.flush();
+            std::cerr << result.errors << std::flush;
+        }
+    }
+    output.flush();
+
+    // Summarize timings on stderr so stdout only holds the scripts' own output
+    int exitCode = 0;
+    size_t failed = 0;
+    std::cerr << std::fixed << std::setprecision(2);
+    std::chrono::duration<double, std::milli> total{};
+    for (const BatchResult& result : results) {
+        std::cerr << std::setw(10) << result.elapsed.count() << " ms  " << std::setw(3) << result.exitCode << "  "
+                  << result.path << '\n';
+        exitCode = std::max(exitCode, result.exitCode);
+        failed += result.exitCode != 0;
+        total += result.elapsed;
+    }
+    std::cerr << results.size() << " scripts, " << failed << " failed, " << total.count() << " ms total, "
+              << wall.count() << " ms wall" << std::endl;
+
+    return exitCode;
+}
+
+int emitCpp(const std::string& out, const std::string& path) {
+    std::ifstream inFile(path);
+    std::string source{std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>()};
+
+    auto program = isolate.compile(source, path);
+    if (!program) {
+        return 65;
+    }
+
+    std::ofstream outFile(out);
+    outFile << CppEmitter(program).emit(path);
+    if (!outFile.flush()) {
+        std::cerr << "Could not write '" << out << "'." << std::endl;
+        return 73;
+    }
+    return 0;
+}
+
+int dumpIr(const std::string& path) {
+    std::ifstream inFile(path);
+    std::string source{std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>()};
+
+    auto program = isolate.compile(source, path);
+    if (!program) {
+        return 65;
+    }
+
+    ResolvedLocals locals = program->locals;
+    std::vector<std::shared_ptr<Stmt>> statements = program->statements;
+    for (const auto& [modulePath, module] : program->modules) {
+        locals.insert(module->locals.begin(), module->locals.end());
+        statements.insert(statements.end(), module->statements.begin(), module->statements.end());
     }
+
+    for (const auto& function : IrBuilder::functionsIn(statements)) {
+        auto ir = IrBuilder(locals).build(function);
+        if (!ir) {
+            std::cout << "function " << function->name.lexeme << ": not lowered, declares functions or classes\n\n";
+            continue;
+        }
+        IrPassManager::standard().run(*ir);
+        std::cout << ir->toString() << '\n';
+    }
+    return 0;
 }
@@ -2,13 +2,26 @@
 
 #include <sstream>
 
-std::any AstPrinter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+std::string AstPrinter::visitAssignExpr(std::shared_ptr<Assign> expr) {
+    return parenthesize("= " + expr->name.lexeme, expr->value);
+}
+std::string AstPrinter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     return parenthesize(expr->oper.lexeme, expr->left, expr->right);
 }
-std::any AstPrinter::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+std::string AstPrinter::visitCallExpr(std::shared_ptr<Call> expr) {
+    std::string result = "(call " + print(expr->callee);
+    for (const auto& arg : expr->arguments) {
+        result += " " + print(arg);
+    }
+    return result + ")";
+}
+std::string AstPrinter::visitGetExpr(std::shared_ptr<Get> expr) {
+    return parenthesize("." + expr->name.lexeme, expr->object);
+}
+std::string AstPrinter::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
     return parenthesize("group", expr->expression);
 }
-std::any AstPrinter::visitLiteralExpr(std::shared_ptr<Literal> expr) {
+std::string AstPrinter::visitLiteralExpr(std::shared_ptr<Literal> expr) {
     const auto& value_type = expr->value.type();
 
     if (value_type == typeid(nullptr)) {
@@ -26,9 +39,24 @@ std::any AstPrinter::visitLiteralExpr(std::shared_ptr<Literal> expr) {
 
     return "Unrecognized literal";
 }
-std::any AstPrinter::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+std::string AstPrinter::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+    return parenthesize(expr->oper.lexeme, expr->left, expr->right);
+}
+std::string AstPrinter::visitSetExpr(std::shared_ptr<Set> expr) {
+    return parenthesize("= ." + expr->name.lexeme, expr->object, expr->value);
+}
+std::string AstPrinter::visitSuperExpr(std::shared_ptr<Super> expr) {
+    return "super." + expr->method.lexeme;
+}
+std::string AstPrinter::visitThisExpr(std::shared_ptr<This>) {
+    return "this";
+}
+std::string AstPrinter::visitUnaryExpr(std::shared_ptr<Unary> expr) {
     return parenthesize(expr->oper.lexeme, expr->right);
 }
+std::string AstPrinter::visitVariableExpr(std::shared_ptr<Variable> expr) {
+    return expr->name.lexeme;
+}
 
 template <typename... Args>
 std::string AstPrinter::parenthesize(std::string_view name, Args... args) {
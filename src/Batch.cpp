@@ -0,0 +1,103 @@
+#include "../include/Batch.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+#include "../include/Isolate.hpp"
+#include "../include/ThreadPool.hpp"
+
+namespace {
+/// @brief Runs the script at the given path, filling in the rest of the result.
+void runScript(BatchResult& result) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::ifstream inFile(result.path);
+    if (!inFile) {
+        result.errors = "Could not read '" + result.path + "'.\n";
+        result.exitCode = 66;
+        return;
+    }
+    std::string source(std::istreambuf_iterator<char>(inFile), {});
+
+    std::ostringstream errors;
+    {
+        Isolate isolate(errors);
+        isolate.getOutput().setCapture(&result.output);
+
+        // Anything the interpreter doesn't report itself must still end only this script, not the whole batch
+        try {
+            isolate.run(source, result.path);
+        }
+        catch (const std::exception& error) {
+            errors << "Internal error: " << error.what() << "\n";
+            result.exitCode = 70;
+        }
+        catch (...) {
+            errors << "Internal error.\n";
+            result.exitCode = 70;
+        }
+        isolate.getOutput().flush();
+
+        if (isolate.hadError()) {
+            result.exitCode = 65;
+        }
+        else if (isolate.hadRuntimeError()) {
+            result.exitCode = 70;
+        }
+    }
+    result.errors = std::move(errors).str();
+
+    result.elapsed = std::chrono::steady_clock::now() - start;
+}
+}  // namespace
+
+std::optional<std::vector<std::string>> collectBatchScripts(const std::string& path) {
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    std::vector<std::string> scripts;
+
+    if (fs::is_directory(path, error)) {
+        for (auto it = fs::recursive_directory_iterator(path, error); !error && it != fs::end(it); it.increment(error)) {
+            if (it->is_regular_file(error) && it->path().extension() == ".lox") {
+                scripts.push_back(it->path().string());
+            }
+        }
+        if (error) {
+            return std::nullopt;
+        }
+        std::sort(scripts.begin(), scripts.end());
+        return scripts;
+    }
+
+    std::ifstream list(path);
+    if (!list) {
+        return std::nullopt;
+    }
+    std::string line;
+    while (std::getline(list, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            scripts.push_back(line);
+        }
+    }
+    return scripts;
+}
+
+std::vector<BatchResult> runBatch(const std::vector<std::string>& paths, size_t threadCount) {
+    std::vector<BatchResult> results(paths.size());
+
+    ThreadPool pool(std::min(threadCount, paths.size()));
+    for (size_t i = 0; i < paths.size(); ++i) {
+        results[i].path = paths[i];
+        pool.submit([&result = results[i]] { runScript(result); });
+    }
+    pool.wait();
+
+    return results;
+}
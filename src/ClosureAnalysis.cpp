@@ -0,0 +1,218 @@
+#include "../include/ClosureAnalysis.hpp"
+
+#include <algorithm>
+
+void ClosureAnalysis::analyze(const void* owner, const std::vector<std::shared_ptr<Stmt>>& statements) {
+    functions = {owner};
+    resolve(statements);
+}
+
+void ClosureAnalysis::visitAssignExpr(std::shared_ptr<Assign> expr) {
+    resolve(expr->value);
+    reference(expr, expr->name.lexeme);
+}
+
+void ClosureAnalysis::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+    resolve(expr->left);
+    resolve(expr->right);
+}
+
+void ClosureAnalysis::visitCallExpr(std::shared_ptr<Call> expr) {
+    resolve(expr->callee);
+    for (const auto& arg : expr->arguments) {
+        resolve(arg);
+    }
+}
+
+void ClosureAnalysis::visitGetExpr(std::shared_ptr<Get> expr) {
+    resolve(expr->object);
+}
+
+void ClosureAnalysis::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+    resolve(expr->expression);
+}
+
+void ClosureAnalysis::visitLiteralExpr(std::shared_ptr<Literal>) {}
+
+void ClosureAnalysis::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+    resolve(expr->left);
+    resolve(expr->right);
+}
+
+void ClosureAnalysis::visitSetExpr(std::shared_ptr<Set> expr) {
+    resolve(expr->object);
+    resolve(expr->value);
+}
+
+void ClosureAnalysis::visitSuperExpr(std::shared_ptr<Super> expr) {
+    // "this" lives in the scope just inside the one holding "super"
+    auto it = locals.find(expr);
+    if (it != locals.end() && it->second > 0) {
+        Slot* object = lookUp(it->second - 1, "this");
+        use(object);
+        closures.thisOfSuper[expr.get()] = object;
+    }
+    reference(expr, "super");
+}
+
+void ClosureAnalysis::visitThisExpr(std::shared_ptr<This> expr) {
+    reference(expr, "this");
+}
+
+void ClosureAnalysis::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+    resolve(expr->right);
+}
+
+void ClosureAnalysis::visitVariableExpr(std::shared_ptr<Variable> expr) {
+    reference(expr, expr->name.lexeme);
+}
+
+void ClosureAnalysis::visitBlockStmt(std::shared_ptr<Block> stmt) {
+    scopes.emplace_back();
+    resolve(stmt->statements);
+    scopes.pop_back();
+}
+
+void ClosureAnalysis::visitClassStmt(std::shared_ptr<Class> stmt) {
+    declare(stmt.get(), stmt->name.lexeme, functions.back());
+
+    if (stmt->superclass != nullptr) {
+        resolve(stmt->superclass);
+
+        scopes.emplace_back();
+        closures.supers[stmt.get()] = declare(nullptr, "super", functions.back());
+    }
+
+    // The Resolver shares one scope holding "this" between all methods, but each method binds its own
+    for (const auto& method : stmt->methods) {
+        scopes.emplace_back();
+        Slot* receiver = declare(nullptr, "this", method.get());
+        receiver->receiver = true;
+        closures.receivers[method.get()] = receiver;
+
+        resolveFunction(method);
+        scopes.pop_back();
+    }
+
+    if (stmt->superclass != nullptr) {
+        scopes.pop_back();
+    }
+}
+
+void ClosureAnalysis::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+    resolve(stmt->expression);
+}
+
+void ClosureAnalysis::visitForStmt(std::shared_ptr<For> stmt) {
+    if (stmt->initializer != nullptr) {
+        scopes.emplace_back();
+        resolve(stmt->initializer);
+    }
+    if (stmt->condition != nullptr) {
+        resolve(stmt->condition);
+    }
+    resolve(stmt->body);
+    if (stmt->increment != nullptr) {
+        resolve(stmt->increment);
+    }
+    if (stmt->initializer != nullptr) {
+        scopes.pop_back();
+    }
+}
+
+void ClosureAnalysis::visitFunctionStmt(std::shared_ptr<Function> stmt) {
+    declare(stmt.get(), stmt->name.lexeme, functions.back());
+    resolveFunction(stmt);
+}
+
+void ClosureAnalysis::visitIfStmt(std::shared_ptr<If> stmt) {
+    resolve(stmt->condition);
+    resolve(stmt->thenBranch);
+    if (stmt->elseBranch != nullptr) {
+        resolve(stmt->elseBranch);
+    }
+}
+
+void ClosureAnalysis::visitImportStmt(std::shared_ptr<Import>) {}
+
+void ClosureAnalysis::visitPrintStmt(std::shared_ptr<Print> stmt) {
+    resolve(stmt->expression);
+}
+
+void ClosureAnalysis::visitReturnStmt(std::shared_ptr<Return> stmt) {
+    if (stmt->value != nullptr) {
+        resolve(stmt->value);
+    }
+}
+
+void ClosureAnalysis::visitVarStmt(std::shared_ptr<Var> stmt) {
+    declare(stmt.get(), stmt->name.lexeme, functions.back());
+    if (stmt->initializer != nullptr) {
+        resolve(stmt->initializer);
+    }
+}
+
+void ClosureAnalysis::visitWhileStmt(std::shared_ptr<While> stmt) {
+    resolve(stmt->condition);
+    resolve(stmt->body);
+}
+
+void ClosureAnalysis::resolve(const std::vector<std::shared_ptr<Stmt>>& stmts) {
+    for (const auto& stmt : stmts) {
+        stmt->accept(*this);
+    }
+}
+
+void ClosureAnalysis::resolve(const std::shared_ptr<Stmt>& stmt) { stmt->accept(*this); }
+
+void ClosureAnalysis::resolve(const std::shared_ptr<Expr>& expr) { expr->accept(*this); }
+
+void ClosureAnalysis::resolveFunction(const std::shared_ptr<Function>& function) {
+    functions.push_back(function.get());
+    scopes.emplace_back();
+    for (const auto& param : function->params) {
+        declare(&param, param.lexeme, function.get());
+    }
+    resolve(function->body);
+    scopes.pop_back();
+    functions.pop_back();
+}
+
+ClosureAnalysis::Slot* ClosureAnalysis::declare(const void* declaration, const std::string& name, const void* owner) {
+    if (scopes.empty()) {
+        return nullptr;
+    }
+
+    Slot* slot = &closures.slots.emplace_back(Slot{name, closures.slots.size(), owner});
+    scopes.back()[name] = slot;
+    if (declaration != nullptr) {
+        closures.declarations[declaration] = slot;
+    }
+    return slot;
+}
+
+ClosureAnalysis::Slot* ClosureAnalysis::lookUp(size_t depth, const std::string& name) {
+    return scopes.at(scopes.size() - 1 - depth).at(name);
+}
+
+void ClosureAnalysis::reference(const std::shared_ptr<Expr>& expr, const std::string& name) {
+    auto it = locals.find(expr);
+    if (it == locals.end()) {
+        return;
+    }
+
+    Slot* slot = lookUp(it->second, name);
+    use(slot);
+    closures.references[expr.get()] = slot;
+}
+
+void ClosureAnalysis::use(Slot* slot) {
+    for (size_t i = functions.size() - 1; functions[i] != slot->owner; --i) {
+        slot->captured = true;
+
+        auto& captures = closures.captures[functions[i]];
+        if (std::find(captures.begin(), captures.end(), slot) == captures.end()) {
+            captures.push_back(slot);
+        }
+    }
+}
@@ -0,0 +1,17 @@
+#include "../include/CompiledFunction.hpp"
+
+std::any CompiledFunction::call(Interpreter& interpreter, const std::vector<std::any>& arguments) {
+    std::any result = body(interpreter, *this, arguments);
+
+    // Initializers always return their instance, even from an early return
+    if (isInitializer) {
+        return receiver;
+    }
+    return result;
+}
+
+std::shared_ptr<LoxFunction> CompiledFunction::bind(std::shared_ptr<LoxInstance> instance) {
+    auto bound = std::make_shared<CompiledFunction>(*this);
+    bound->receiver = instance;
+    return bound;
+}
@@ -0,0 +1,30 @@
+#include "../include/CompiledRuntime.hpp"
+
+#include "../include/Isolate.hpp"
+
+int compiled::run(void (*program)(Interpreter&)) {
+    Isolate isolate;
+    ErrorScope scope(isolate.getErrorState());
+    Interpreter& interpreter = isolate.getInterpreter();
+    Scheduler& scheduler = interpreter.getScheduler();
+
+    // Same as Interpreter::interpret()
+    try {
+        program(interpreter);
+        scheduler.finishAll();
+    }
+    catch (RuntimeError& error) {
+        scheduler.abandon();
+        interpreter.getOutput().flush();
+        runtimeError(error);
+    }
+
+    interpreter.getOutput().flush();
+    if (isolate.hadError()) {
+        return 65;
+    }
+    else if (isolate.hadRuntimeError()) {
+        return 70;
+    }
+    return 0;
+}
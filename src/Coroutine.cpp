@@ -0,0 +1,95 @@
+#include "../include/Coroutine.hpp"
+
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+Coroutine::Coroutine() {
+    if (IsThreadAFiber()) {
+        fiber = GetCurrentFiber();
+    }
+    else {
+        fiber = ConvertThreadToFiber(nullptr);
+        convertedThread = true;
+    }
+    if (!fiber) {
+        throw std::bad_alloc();
+    }
+}
+
+Coroutine::Coroutine(Entry ent, void* arg, size_t size) : entry(ent), argument(arg) {
+    fiber = CreateFiber(size, start, this);
+    if (!fiber) {
+        throw std::bad_alloc();
+    }
+}
+
+Coroutine::~Coroutine() {
+    if (convertedThread) {
+        ConvertFiberToThread();
+    }
+    else if (entry) {
+        DeleteFiber(fiber);
+    }
+}
+
+void Coroutine::switchTo(Coroutine& target) {
+    SwitchToFiber(target.fiber);
+}
+
+void __stdcall Coroutine::start(void* self) {
+    auto& coroutine = *static_cast<Coroutine*>(self);
+    coroutine.entry(coroutine.argument);
+}
+
+#else
+
+namespace {
+// The coroutine being started, since makecontext can only pass int arguments portably
+thread_local Coroutine* starting = nullptr;
+}  // namespace
+
+Coroutine::Coroutine() {}
+
+Coroutine::Coroutine(Entry ent, void* arg, size_t size) : entry(ent), argument(arg) {
+    // Reserve the stack lazily, below an inaccessible guard page so an overflow faults instead of corrupting memory
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    stackSize = (size + pageSize - 1) / pageSize * pageSize + pageSize;
+    stack = mmap(nullptr, stackSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (stack == MAP_FAILED) {
+        stack = nullptr;
+        throw std::bad_alloc();
+    }
+    mprotect(stack, pageSize, PROT_NONE);
+
+    getcontext(&context);
+    context.uc_stack.ss_sp = stack;
+    context.uc_stack.ss_size = stackSize;
+    context.uc_link = nullptr;
+    makecontext(&context, start, 0);
+}
+
+Coroutine::~Coroutine() {
+    if (stack) {
+        munmap(stack, stackSize);
+    }
+}
+
+void Coroutine::switchTo(Coroutine& target) {
+    starting = &target;
+    swapcontext(&context, &target.context);
+}
+
+void Coroutine::start() {
+    Coroutine& coroutine = *starting;
+    coroutine.entry(coroutine.argument);
+}
+
+#endif
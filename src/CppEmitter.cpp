@@ -0,0 +1,562 @@
+#include "../include/CppEmitter.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace {
+using Slot = CppEmitter::Slot;
+
+/// @brief Returns whether evaluating the given expression can change a variable or a field.
+bool hasEffects(const std::shared_ptr<Expr>& expr) {
+    if (std::dynamic_pointer_cast<Assign>(expr) || std::dynamic_pointer_cast<Call>(expr) || std::dynamic_pointer_cast<Set>(expr)) {
+        return true;
+    }
+    else if (auto binary = std::dynamic_pointer_cast<Binary>(expr)) {
+        return hasEffects(binary->left) || hasEffects(binary->right);
+    }
+    else if (auto logical = std::dynamic_pointer_cast<Logical>(expr)) {
+        return hasEffects(logical->left) || hasEffects(logical->right);
+    }
+    else if (auto grouping = std::dynamic_pointer_cast<Grouping>(expr)) {
+        return hasEffects(grouping->expression);
+    }
+    else if (auto unary = std::dynamic_pointer_cast<Unary>(expr)) {
+        return hasEffects(unary->right);
+    }
+    else if (auto get = std::dynamic_pointer_cast<Get>(expr)) {
+        return hasEffects(get->object);
+    }
+    return false;
+}
+
+/// @brief Returns the given string as a C++ string literal.
+std::string quote(const std::string& s) {
+    std::ostringstream out;
+    out << '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (c < 0x20 || c >= 0x7f) {
+                    // Octal escapes take at most three digits, so they can't run into a following digit
+                    out << '\\' << std::oct << std::setw(3) << std::setfill('0') << static_cast<int>(c) << std::dec;
+                }
+                else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+}  // namespace
+
+CppEmitter::CppEmitter(std::shared_ptr<const Program> prog) : program(prog), locals(prog->locals), imports(prog->imports) {
+    for (const auto& [path, module] : program->modules) {
+        moduleIndices.emplace(path, moduleIndices.size());
+        locals.insert(module->locals.begin(), module->locals.end());
+        imports.insert(module->imports.begin(), module->imports.end());
+    }
+
+    ClosureAnalysis analysis(locals, closures);
+    for (const auto& [path, module] : program->modules) {
+        analysis.analyze(module.get(), module->statements);
+    }
+    analysis.analyze(program.get(), program->statements);
+}
+
+std::string CppEmitter::emit(const std::string& name) {
+    for (const auto& [path, module] : program->modules) {
+        size_t index = moduleIndices.at(path);
+        // The program itself counts as imported, so a cycle of imports leading back to it doesn't run it again
+        constants << "bool imported" << index << " = " << (path == program->path ? "true" : "false") << ";\n";
+        prototypes << "void module" << index << "(Interpreter&);\n";
+        emitTopLevel("module" + std::to_string(index), module.get(), module->statements);
+    }
+    emitTopLevel("program", program.get(), program->statements);
+
+    std::ostringstream out;
+    out << "// Generated by cpplox --emit-cpp from " << name << ". Do not edit.\n";
+    out << "#include \"CompiledRuntime.hpp\"\n\n";
+    out << "namespace {\n";
+    out << constants.str() << '\n';
+    out << prototypes.str() << '\n';
+    out << definitions.str();
+    out << "}  // namespace\n\n";
+    out << "int main() {\n";
+    out << "    return compiled::run(program);\n";
+    out << "}\n";
+    return out.str();
+}
+
+void CppEmitter::emitTopLevel(const std::string& name, const void* unit, const std::vector<std::shared_ptr<Stmt>>& statements) {
+    std::ostringstream code;
+    owner = unit;
+    body = &code;
+    indent = 0;
+
+    open("void " + name + "(Interpreter& interpreter)");
+    for (const auto& statement : statements) {
+        execute(statement);
+    }
+    close();
+
+    definitions << code.str() << '\n';
+}
+
+std::string CppEmitter::emitFunction(const std::shared_ptr<Function>& function, bool isMethod) {
+    std::string name = "fn" + std::to_string(functionCount++) + "_" + function->name.lexeme;
+    std::string signature = "std::any " + name +
+                            "([[maybe_unused]] Interpreter& interpreter, [[maybe_unused]] CompiledFunction& self, "
+                            "[[maybe_unused]] const std::vector<std::any>& arguments)";
+    prototypes << signature << ";\n";
+
+    // Emit into a buffer of its own, since this may be in the middle of emitting the enclosing function
+    const void* enclosingOwner = owner;
+    std::ostringstream* enclosingBody = body;
+    size_t enclosingIndent = indent;
+
+    std::ostringstream code;
+    owner = function.get();
+    body = &code;
+    indent = 0;
+
+    open(signature);
+    if (isMethod) {
+        const Slot* receiver = closures.receivers.at(function.get());
+        if (receiver->captured) {
+            line("auto " + variable(receiver) + " = std::make_shared<Cell>(Cell{self.receiver});");
+        }
+    }
+    for (size_t i = 0; i < function->params.size(); ++i) {
+        declare(closures.declarations.at(&function->params[i]), "arguments[" + std::to_string(i) + "]");
+    }
+    for (const auto& statement : function->body) {
+        execute(statement);
+    }
+    line("return nullptr;");
+    close();
+
+    definitions << code.str() << '\n';
+
+    owner = enclosingOwner;
+    body = enclosingBody;
+    indent = enclosingIndent;
+    return name;
+}
+
+std::string CppEmitter::closure(const std::shared_ptr<Function>& function, bool isMethod) {
+    std::string name = emitFunction(function, isMethod);
+
+    std::string cells;
+    auto captures = closures.captures.find(function.get());
+    if (captures != closures.captures.end()) {
+        for (const Slot* slot : captures->second) {
+            cells += (cells.empty() ? "" : ", ") + cell(slot);
+        }
+    }
+
+    bool isInitializer = isMethod && function->name.lexeme == "init";
+    return "std::make_shared<CompiledFunction>(" + quote(function->name.lexeme) + ", " +
+           std::to_string(function->params.size()) + ", " + name + ", std::vector<std::shared_ptr<Cell>>{" + cells +
+           "}, " + (isInitializer ? "true" : "false") + ")";
+}
+
+std::string CppEmitter::visitAssignExpr(std::shared_ptr<Assign> expr) {
+    std::string value = evaluate(expr->value);
+
+    auto it = closures.references.find(expr.get());
+    if (it != closures.references.end()) {
+        line(access(it->second) + " = " + value + ";");
+    }
+    else {
+        line(global(expr->name.lexeme) + ".assign(interpreter, " + token(expr->name) + ", " + value + ");");
+    }
+    return value;
+}
+std::string CppEmitter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+    std::string left = evaluate(expr->left);
+    if (hasEffects(expr->right)) {
+        left = materialize(left);
+    }
+    std::string right = evaluate(expr->right);
+
+    std::string op = token(expr->oper);
+    std::string result;
+    switch (expr->oper.type) {
+        case TokenType::GREATER:
+            result = "compiled::greater(" + op + ", " + left + ", " + right + ")";
+            break;
+        case TokenType::GREATER_EQUAL:
+            result = "compiled::greaterEqual(" + left + ", " + right + ")";
+            break;
+        case TokenType::LESS:
+            result = "compiled::less(" + left + ", " + right + ")";
+            break;
+        case TokenType::LESS_EQUAL:
+            result = "compiled::lessEqual(" + left + ", " + right + ")";
+            break;
+        case TokenType::EQUAL_EQUAL:
+            result = "compiled::equal(" + left + ", " + right + ")";
+            break;
+        case TokenType::BANG_EQUAL:
+            result = "compiled::notEqual(" + left + ", " + right + ")";
+            break;
+        case TokenType::PLUS:
+            result = "compiled::add(interpreter, " + op + ", " + left + ", " + right + ")";
+            break;
+        case TokenType::MINUS:
+            result = "compiled::subtract(" + op + ", " + left + ", " + right + ")";
+            break;
+        case TokenType::STAR:
+            result = "compiled::multiply(" + op + ", " + left + ", " + right + ")";
+            break;
+        case TokenType::SLASH:
+            result = "compiled::divide(" + op + ", " + left + ", " + right + ")";
+            break;
+        default:
+            result = "std::any(nullptr)";
+    }
+
+    std::string name = temp();
+    line("std::any " + name + " = " + result + ";");
+    return name;
+}
+std::string CppEmitter::visitCallExpr(std::shared_ptr<Call> expr) {
+    std::string callee = evaluate(expr->callee);
+    for (const auto& arg : expr->arguments) {
+        if (hasEffects(arg)) {
+            callee = materialize(callee);
+            break;
+        }
+    }
+
+    // Each argument is stored as soon as it is evaluated, so later arguments can't change it
+    std::string arguments = temp();
+    line("std::vector<std::any> " + arguments + ";");
+    if (!expr->arguments.empty()) {
+        line(arguments + ".reserve(" + std::to_string(expr->arguments.size()) + ");");
+    }
+    for (const auto& arg : expr->arguments) {
+        line(arguments + ".push_back(" + take(evaluate(arg)) + ");");
+    }
+
+    std::string name = temp();
+    line("std::any " + name + " = compiled::call(interpreter, " + token(expr->paren) + ", " + callee + ", " + arguments + ");");
+    return name;
+}
+std::string CppEmitter::visitGetExpr(std::shared_ptr<Get> expr) {
+    std::string object = evaluate(expr->object);
+
+    std::string name = temp();
+    line("std::any " + name + " = compiled::get(" + token(expr->name) + ", " + object + ");");
+    return name;
+}
+std::string CppEmitter::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+    return evaluate(expr->expression);
+}
+std::string CppEmitter::visitLiteralExpr(std::shared_ptr<Literal> expr) {
+    const std::any& value = expr->value;
+    if (value.type() == typeid(double)) {
+        std::ostringstream number;
+        number << std::setprecision(17) << std::any_cast<double>(value);
+        std::string digits = number.str();
+        if (digits.find_first_of(".e") == std::string::npos) {
+            digits += ".0";
+        }
+        return "std::any(" + digits + ")";
+    }
+    else if (value.type() == typeid(std::string)) {
+        return string(std::any_cast<std::string>(value));
+    }
+    else if (value.type() == typeid(bool)) {
+        return std::string(std::any_cast<bool>(value) ? "std::any(true)" : "std::any(false)");
+    }
+    return std::string("std::any(nullptr)");
+}
+std::string CppEmitter::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+    std::string result = temp();
+    line("std::any " + result + " = " + take(evaluate(expr->left)) + ";");
+
+    // The right operand is only evaluated when the left one doesn't decide the result
+    open(std::string("if (") + (expr->oper.type == TokenType::OR ? "!" : "") + "compiled::truthy(" + result + "))");
+    line(result + " = " + take(evaluate(expr->right)) + ";");
+    close();
+    return result;
+}
+std::string CppEmitter::visitSetExpr(std::shared_ptr<Set> expr) {
+    std::string object = evaluate(expr->object);
+
+    std::string instance = temp();
+    line("auto " + instance + " = compiled::fieldTarget(" + token(expr->name) + ", " + object + ");");
+    std::string value = evaluate(expr->value);
+    line(instance + "->set(" + token(expr->name) + ", " + value + ");");
+    return value;
+}
+std::string CppEmitter::visitSuperExpr(std::shared_ptr<Super> expr) {
+    std::string superclass = access(closures.references.at(expr.get()));
+    std::string object = access(closures.thisOfSuper.at(expr.get()));
+
+    std::string name = temp();
+    line("std::any " + name + " = compiled::superMethod(" + token(expr->method) + ", " + superclass + ", " + object + ");");
+    return name;
+}
+std::string CppEmitter::visitThisExpr(std::shared_ptr<This> expr) {
+    return access(closures.references.at(expr.get()));
+}
+std::string CppEmitter::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+    std::string right = evaluate(expr->right);
+
+    std::string name = temp();
+    if (expr->oper.type == TokenType::MINUS) {
+        line("std::any " + name + " = compiled::negate(" + token(expr->oper) + ", " + right + ");");
+    }
+    else {
+        line("std::any " + name + " = compiled::logicalNot(" + right + ");");
+    }
+    return name;
+}
+std::string CppEmitter::visitVariableExpr(std::shared_ptr<Variable> expr) {
+    auto it = closures.references.find(expr.get());
+    if (it != closures.references.end()) {
+        return access(it->second);
+    }
+
+    // Reading a global can fail, so it has to happen in order
+    std::string name = temp();
+    line("std::any " + name + " = " + global(expr->name.lexeme) + ".get(interpreter, " + token(expr->name) + ");");
+    return name;
+}
+
+void CppEmitter::visitBlockStmt(std::shared_ptr<Block> stmt) {
+    open("");
+    for (const auto& statement : stmt->statements) {
+        execute(statement);
+    }
+    close();
+}
+void CppEmitter::visitClassStmt(std::shared_ptr<Class> stmt) {
+    auto it = closures.declarations.find(stmt.get());
+    const Slot* slot = it != closures.declarations.end() ? it->second : nullptr;
+    if (slot != nullptr) {
+        declare(slot, "std::any(nullptr)");
+    }
+    else {
+        line(global(stmt->name.lexeme) + ".define(interpreter, nullptr);");
+    }
+
+    std::string loxClass = temp();
+    line("std::shared_ptr<LoxClass> " + loxClass + ";");
+    open("");
+    std::string superclass = temp();
+    line("std::shared_ptr<LoxClass> " + superclass + ";");
+    if (stmt->superclass != nullptr) {
+        std::string value = materialize(evaluate(stmt->superclass));
+        open("if (!(" + superclass + " = callableAnyCast<LoxClass>(" + value + ")))");
+        line("error(" + token(stmt->superclass->name) + ", \"Superclass must be a class.\");");
+        close();
+        declare(closures.supers.at(stmt.get()), value);
+    }
+
+    std::string methods = temp();
+    line("LoxClass::MethodTable " + methods + ";");
+    for (const auto& method : stmt->methods) {
+        line(methods + "[" + quote(method->name.lexeme) + "] = " + closure(method, true) + ";");
+    }
+    line(loxClass + " = std::make_shared<LoxClass>(" + quote(stmt->name.lexeme) + ", " + superclass + ", std::move(" +
+         methods + "));");
+    close();
+
+    std::string value = "std::shared_ptr<LoxCallable>(" + loxClass + ")";
+    if (slot != nullptr) {
+        line(access(slot) + " = " + value + ";");
+    }
+    else {
+        line(global(stmt->name.lexeme) + ".assign(interpreter, " + token(stmt->name) + ", " + value + ");");
+    }
+}
+void CppEmitter::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+    evaluate(stmt->expression);
+}
+void CppEmitter::visitForStmt(std::shared_ptr<For> stmt) {
+    // The initializer's variable is declared once for every iteration
+    open("");
+    if (stmt->initializer != nullptr) {
+        execute(stmt->initializer);
+    }
+    open("while (true)");
+    if (stmt->condition != nullptr) {
+        line("if (!compiled::truthy(" + evaluate(stmt->condition) + ")) break;");
+    }
+    execute(stmt->body);
+    if (stmt->increment != nullptr) {
+        evaluate(stmt->increment);
+    }
+    close();
+    close();
+}
+void CppEmitter::visitFunctionStmt(std::shared_ptr<Function> stmt) {
+    auto it = closures.declarations.find(stmt.get());
+    if (it == closures.declarations.end()) {
+        line(global(stmt->name.lexeme) + ".define(interpreter, std::shared_ptr<LoxCallable>(" + closure(stmt, false) + "));");
+    }
+    else if (it->second->captured) {
+        // The cell must exist before the function captures it to call itself
+        declare(it->second, "std::any(nullptr)");
+        line(access(it->second) + " = std::shared_ptr<LoxCallable>(" + closure(stmt, false) + ");");
+    }
+    else {
+        declare(it->second, "std::any(std::shared_ptr<LoxCallable>(" + closure(stmt, false) + "))");
+    }
+}
+void CppEmitter::visitIfStmt(std::shared_ptr<If> stmt) {
+    open("if (compiled::truthy(" + evaluate(stmt->condition) + "))");
+    execute(stmt->thenBranch);
+    if (stmt->elseBranch != nullptr) {
+        close("}");
+        open("else");
+        execute(stmt->elseBranch);
+    }
+    close();
+}
+void CppEmitter::visitImportStmt(std::shared_ptr<Import> stmt) {
+    auto path = imports.find(stmt);
+    auto module = path != imports.end() ? moduleIndices.find(path->second) : moduleIndices.end();
+    if (module == moduleIndices.end()) {
+        line("throw RuntimeError(" + token(stmt->path) + ", \"Module was not loaded.\");");
+        return;
+    }
+
+    // Each module runs once, in the global scope, the first time it is imported
+    std::string index = std::to_string(module->second);
+    open("if (!imported" + index + ")");
+    line("imported" + index + " = true;");
+    line("module" + index + "(interpreter);");
+    close();
+}
+void CppEmitter::visitPrintStmt(std::shared_ptr<Print> stmt) {
+    line("compiled::print(interpreter, " + evaluate(stmt->expression) + ");");
+}
+void CppEmitter::visitReturnStmt(std::shared_ptr<Return> stmt) {
+    std::string value = stmt->value != nullptr ? evaluate(stmt->value) : "std::any(nullptr)";
+    line("return " + take(value) + ";");
+}
+void CppEmitter::visitVarStmt(std::shared_ptr<Var> stmt) {
+    std::string value = stmt->initializer != nullptr ? evaluate(stmt->initializer) : "std::any(nullptr)";
+
+    auto it = closures.declarations.find(stmt.get());
+    if (it != closures.declarations.end()) {
+        declare(it->second, value);
+    }
+    else {
+        line(global(stmt->name.lexeme) + ".define(interpreter, " + value + ");");
+    }
+}
+void CppEmitter::visitWhileStmt(std::shared_ptr<While> stmt) {
+    open("while (true)");
+    line("if (!compiled::truthy(" + evaluate(stmt->condition) + ")) break;");
+    execute(stmt->body);
+    close();
+}
+
+std::string CppEmitter::evaluate(const std::shared_ptr<Expr>& expr) {
+    return expr->accept(*this);
+}
+std::string CppEmitter::materialize(const std::string& value) {
+    if (value.starts_with("t")) {
+        return value;
+    }
+
+    std::string name = temp();
+    line("std::any " + name + " = " + value + ";");
+    return name;
+}
+std::string CppEmitter::take(const std::string& value) const {
+    return value.starts_with("t") ? "std::move(" + value + ")" : value;
+}
+std::string CppEmitter::temp() {
+    return "t" + std::to_string(tempCount++);
+}
+
+void CppEmitter::line(const std::string& code) {
+    *body << std::string(indent * 4, ' ') << code << '\n';
+}
+void CppEmitter::open(const std::string& code) {
+    line(code.empty() ? "{" : code + " {");
+    ++indent;
+}
+void CppEmitter::close(const std::string& code) {
+    --indent;
+    line(code);
+}
+void CppEmitter::execute(const std::shared_ptr<Stmt>& stmt) {
+    stmt->accept(*this);
+}
+
+std::string CppEmitter::access(const Slot* slot) {
+    if (slot->owner == owner) {
+        if (slot->receiver && !slot->captured) {
+            return "self.receiver";
+        }
+        return slot->captured ? variable(slot) + "->value" : variable(slot);
+    }
+    return cell(slot) + "->value";
+}
+std::string CppEmitter::cell(const Slot* slot) {
+    if (slot->owner == owner) {
+        return variable(slot);
+    }
+
+    const auto& captures = closures.captures.at(owner);
+    size_t index = std::find(captures.begin(), captures.end(), slot) - captures.begin();
+    return "self.captures[" + std::to_string(index) + "]";
+}
+void CppEmitter::declare(const Slot* slot, const std::string& value) {
+    if (slot->captured) {
+        line("auto " + variable(slot) + " = std::make_shared<Cell>(Cell{" + take(value) + "});");
+    }
+    else {
+        line("std::any " + variable(slot) + " = " + take(value) + ";");
+    }
+}
+std::string CppEmitter::variable(const Slot* slot) const {
+    return "v" + std::to_string(slot->id) + "_" + slot->name;
+}
+
+std::string CppEmitter::token(const Token& tok) {
+    std::string key = std::to_string(static_cast<int>(tok.type)) + " " + std::to_string(tok.line) + " " + tok.lexeme;
+    auto [it, inserted] = tokenNames.emplace(key, "k" + std::to_string(tokenNames.size()));
+    if (inserted) {
+        constants << "const Token " << it->second << "(static_cast<TokenType>(" << static_cast<int>(tok.type) << "), "
+                  << quote(tok.lexeme) << ", nullptr, " << tok.line << ");\n";
+    }
+    return it->second;
+}
+std::string CppEmitter::global(const std::string& name) {
+    auto [it, inserted] = globalNames.emplace(name, "g" + std::to_string(globalNames.size()) + "_" + name);
+    if (inserted) {
+        constants << "compiled::GlobalSlot " << it->second << "(" << quote(name) << ");\n";
+    }
+    return it->second;
+}
+std::string CppEmitter::string(const std::string& s) {
+    auto [it, inserted] = stringNames.emplace(s, "s" + std::to_string(stringNames.size()));
+    if (inserted) {
+        constants << "const std::any " << it->second << " = std::string(" << quote(s) << ", " << s.size() << ");\n";
+    }
+    return it->second;
+}
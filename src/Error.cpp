@@ -1,4 +1,18 @@
 #include "../include/Error.hpp"
 
-bool hadError = false;
-bool hadRuntimeError = false;
\ No newline at end of file
+namespace {
+thread_local ErrorState defaultState;
+thread_local ErrorState* currentState = &defaultState;
+}  // namespace
+
+ErrorState& errorState() {
+    return *currentState;
+}
+
+ErrorScope::ErrorScope(ErrorState& state) : previous(currentState) {
+    currentState = &state;
+}
+
+ErrorScope::~ErrorScope() {
+    currentState = previous;
+}
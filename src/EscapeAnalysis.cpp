@@ -0,0 +1,280 @@
+#include "../include/EscapeAnalysis.hpp"
+
+void EscapeAnalysis::analyze(const std::vector<std::shared_ptr<Stmt>>& statements) {
+    ClosureAnalysis(locals, closures).analyze(&statements, statements);
+
+    for (const auto& stmt : statements) {
+        auto klass = std::dynamic_pointer_cast<Class>(stmt);
+        if (klass == nullptr) {
+            continue;
+        }
+
+        // A method declared twice is replaced by the later one, so leave such classes alone
+        std::set<std::string> methods;
+        bool unique = true;
+        for (const auto& method : klass->methods) {
+            unique = methods.insert(method->name.lexeme).second && unique;
+        }
+        const std::string& name = klass->name.lexeme;
+        classes[name] = classes.contains(name) || klass->superclass != nullptr || !unique ? nullptr : klass;
+    }
+
+    resolve(statements);
+
+    for (auto& [slot, candidate] : candidates) {
+        if (candidate.escapes) {
+            continue;
+        }
+
+        const std::string& variable = candidate.declaration->name.lexeme;
+        candidate.declaration->scalar = candidate.site;
+        for (const auto& get : candidate.gets) {
+            get->scalar = std::make_shared<ScalarAccess>(
+                ScalarAccess{locals.at(get->object), variable, variable + "." + get->name.lexeme});
+        }
+        for (const auto& set : candidate.sets) {
+            set->scalar = std::make_shared<ScalarAccess>(
+                ScalarAccess{locals.at(set->object), variable, variable + "." + set->name.lexeme});
+        }
+    }
+}
+
+void EscapeAnalysis::visitAssignExpr(std::shared_ptr<Assign> expr) {
+    resolve(expr->value);
+
+    // A reassigned variable may end up holding anything
+    auto it = closures.references.find(expr.get());
+    if (it != closures.references.end()) {
+        auto candidate = candidates.find(it->second);
+        if (candidate != candidates.end()) {
+            candidate->second.escapes = true;
+        }
+    }
+}
+
+void EscapeAnalysis::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+    resolve(expr->left);
+    resolve(expr->right);
+}
+
+void EscapeAnalysis::visitCallExpr(std::shared_ptr<Call> expr) {
+    resolve(expr->callee);
+    for (const auto& arg : expr->arguments) {
+        resolve(arg);
+    }
+}
+
+void EscapeAnalysis::visitGetExpr(std::shared_ptr<Get> expr) {
+    Candidate* candidate = candidateOf(expr->object);
+    if (candidate == nullptr) {
+        resolve(expr->object);
+    }
+    // Getting a method binds it to the instance
+    else if (candidate->methods.contains(expr->name.lexeme)) {
+        candidate->escapes = true;
+    }
+    else {
+        candidate->gets.push_back(expr);
+    }
+}
+
+void EscapeAnalysis::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+    resolve(expr->expression);
+}
+
+void EscapeAnalysis::visitLiteralExpr(std::shared_ptr<Literal>) {}
+
+void EscapeAnalysis::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+    resolve(expr->left);
+    resolve(expr->right);
+}
+
+void EscapeAnalysis::visitSetExpr(std::shared_ptr<Set> expr) {
+    Candidate* candidate = candidateOf(expr->object);
+    if (candidate == nullptr) {
+        resolve(expr->object);
+    }
+    else if (candidate->methods.contains(expr->name.lexeme)) {
+        candidate->escapes = true;
+    }
+    else {
+        candidate->sets.push_back(expr);
+    }
+
+    resolve(expr->value);
+}
+
+void EscapeAnalysis::visitSuperExpr(std::shared_ptr<Super>) {}
+
+void EscapeAnalysis::visitThisExpr(std::shared_ptr<This>) {}
+
+void EscapeAnalysis::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+    resolve(expr->right);
+}
+
+void EscapeAnalysis::visitVariableExpr(std::shared_ptr<Variable> expr) {
+    // Any use other than getting or setting a field lets the instance escape
+    if (Candidate* candidate = candidateOf(expr)) {
+        candidate->escapes = true;
+    }
+}
+
+void EscapeAnalysis::visitBlockStmt(std::shared_ptr<Block> stmt) {
+    resolve(stmt->statements);
+}
+
+void EscapeAnalysis::visitClassStmt(std::shared_ptr<Class> stmt) {
+    if (stmt->superclass != nullptr) {
+        resolve(stmt->superclass);
+    }
+    for (const auto& method : stmt->methods) {
+        resolve(method->body);
+    }
+}
+
+void EscapeAnalysis::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+    resolve(stmt->expression);
+}
+
+void EscapeAnalysis::visitForStmt(std::shared_ptr<For> stmt) {
+    if (stmt->initializer != nullptr) {
+        resolve(stmt->initializer);
+    }
+    if (stmt->condition != nullptr) {
+        resolve(stmt->condition);
+    }
+    resolve(stmt->body);
+    if (stmt->increment != nullptr) {
+        resolve(stmt->increment);
+    }
+}
+
+void EscapeAnalysis::visitFunctionStmt(std::shared_ptr<Function> stmt) {
+    resolve(stmt->body);
+}
+
+void EscapeAnalysis::visitIfStmt(std::shared_ptr<If> stmt) {
+    resolve(stmt->condition);
+    resolve(stmt->thenBranch);
+    if (stmt->elseBranch != nullptr) {
+        resolve(stmt->elseBranch);
+    }
+}
+
+void EscapeAnalysis::visitImportStmt(std::shared_ptr<Import>) {}
+
+void EscapeAnalysis::visitPrintStmt(std::shared_ptr<Print> stmt) {
+    resolve(stmt->expression);
+}
+
+void EscapeAnalysis::visitReturnStmt(std::shared_ptr<Return> stmt) {
+    if (stmt->value != nullptr) {
+        resolve(stmt->value);
+    }
+}
+
+void EscapeAnalysis::visitVarStmt(std::shared_ptr<Var> stmt) {
+    if (stmt->initializer == nullptr) {
+        return;
+    }
+    resolve(stmt->initializer);
+
+    // Only locals that closures can't reach, initialized by calling a global naming a suitable class
+    auto slot = closures.declarations.find(stmt.get());
+    auto call = std::dynamic_pointer_cast<Call>(stmt->initializer);
+    auto callee = call != nullptr ? std::dynamic_pointer_cast<Variable>(call->callee) : nullptr;
+    if (slot == closures.declarations.end() || slot->second->captured || callee == nullptr || locals.contains(callee)) {
+        return;
+    }
+    auto klass = classes.find(callee->name.lexeme);
+    if (klass == classes.end() || klass->second == nullptr) {
+        return;
+    }
+
+    auto fields = initializedFields(*klass->second, stmt->name.lexeme);
+    size_t arity = 0;
+    for (const auto& method : klass->second->methods) {
+        if (method->name.lexeme == "init") {
+            arity = method->params.size();
+        }
+    }
+    if (!fields || arity != call->arguments.size()) {
+        return;
+    }
+
+    Candidate& candidate = candidates[slot->second];
+    candidate.declaration = stmt;
+    candidate.site = std::make_shared<ScalarSite>(ScalarSite{klass->second.get(), std::move(*fields)});
+    for (const auto& method : klass->second->methods) {
+        candidate.methods.insert(method->name.lexeme);
+    }
+}
+
+void EscapeAnalysis::visitWhileStmt(std::shared_ptr<While> stmt) {
+    resolve(stmt->condition);
+    resolve(stmt->body);
+}
+
+void EscapeAnalysis::resolve(const std::vector<std::shared_ptr<Stmt>>& stmts) {
+    for (const auto& stmt : stmts) {
+        stmt->accept(*this);
+    }
+}
+
+void EscapeAnalysis::resolve(const std::shared_ptr<Stmt>& stmt) { stmt->accept(*this); }
+
+void EscapeAnalysis::resolve(const std::shared_ptr<Expr>& expr) { expr->accept(*this); }
+
+EscapeAnalysis::Candidate* EscapeAnalysis::candidateOf(const std::shared_ptr<Expr>& expr) {
+    if (std::dynamic_pointer_cast<Variable>(expr) == nullptr) {
+        return nullptr;
+    }
+
+    auto slot = closures.references.find(expr.get());
+    if (slot == closures.references.end()) {
+        return nullptr;
+    }
+    auto candidate = candidates.find(slot->second);
+    return candidate != candidates.end() ? &candidate->second : nullptr;
+}
+
+std::optional<std::vector<ScalarSite::Field>> EscapeAnalysis::initializedFields(const Class& klass,
+                                                                                 const std::string& variable) const {
+    std::vector<ScalarSite::Field> fields;
+
+    for (const auto& method : klass.methods) {
+        if (method->name.lexeme != "init") {
+            continue;
+        }
+
+        // Every statement has to be this.<field> = <parameter or constant>;
+        for (const auto& stmt : method->body) {
+            auto expression = std::dynamic_pointer_cast<Expression>(stmt);
+            auto set = expression != nullptr ? std::dynamic_pointer_cast<Set>(expression->expression) : nullptr;
+            if (set == nullptr || std::dynamic_pointer_cast<This>(set->object) == nullptr) {
+                return std::nullopt;
+            }
+
+            ScalarSite::Field field{variable + "." + set->name.lexeme, ScalarSite::noArgument, std::any()};
+            if (auto literal = std::dynamic_pointer_cast<Literal>(set->value)) {
+                field.constant = literal->value;
+            }
+            else if (auto parameter = std::dynamic_pointer_cast<Variable>(set->value)) {
+                auto depth = locals.find(parameter);
+                for (size_t i = 0; depth != locals.end() && depth->second == 0 && i < method->params.size(); ++i) {
+                    if (method->params[i].lexeme == parameter->name.lexeme) {
+                        field.argument = i;
+                    }
+                }
+                if (field.argument == ScalarSite::noArgument) {
+                    return std::nullopt;
+                }
+            }
+            else {
+                return std::nullopt;
+            }
+            fields.push_back(std::move(field));
+        }
+    }
+    return fields;
+}
@@ -0,0 +1,185 @@
+#include "../include/EventLoop.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+#include "../include/Error.hpp"
+#include "../include/LoxTask.hpp"
+#include "../include/Scheduler.hpp"
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+EventLoop::EventLoop(Scheduler& sched) : scheduler(sched) {
+#ifdef __linux__
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        throw NativeError(std::string("Could not create event loop: ") + std::strerror(errno));
+    }
+#endif
+}
+
+EventLoop::~EventLoop() {
+#ifdef __linux__
+    close(epollFd);
+#endif
+}
+
+void EventLoop::sleep(double milliseconds) {
+    auto delay = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(milliseconds));
+    timers.push({Clock::now() + std::max(delay, Clock::duration::zero()), nextSequence++, scheduler.running()});
+    scheduler.suspend();
+}
+
+void EventLoop::waitReadable(int fd) {
+    wait(fd, false);
+}
+
+void EventLoop::waitWritable(int fd) {
+    wait(fd, true);
+}
+
+void EventLoop::wait(int fd, bool write) {
+#ifdef __linux__
+    Watch& watch = watches[fd];
+    std::shared_ptr<LoxTask>& waiter = write ? watch.writer : watch.reader;
+    if (waiter) {
+        throw NativeError(write ? "Another task is already writing to this stream."
+                                : "Another task is already reading from this stream.");
+    }
+
+    waiter = scheduler.running();
+    if (!update(fd)) {
+        // epoll can't watch regular files, which are always ready anyway
+        waiter.reset();
+        if (!watch.reader && !watch.writer) {
+            watches.erase(fd);
+        }
+        return;
+    }
+    scheduler.suspend();
+#else
+    throw NativeError("Waiting on file descriptors requires Linux.");
+#endif
+}
+
+void EventLoop::forget(int fd) {
+    auto it = watches.find(fd);
+    if (it == watches.end()) {
+        return;
+    }
+
+#ifdef __linux__
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    if (it->second.reader) {
+        scheduler.resume(std::move(it->second.reader));
+    }
+    if (it->second.writer) {
+        scheduler.resume(std::move(it->second.writer));
+    }
+    watches.erase(it);
+}
+
+bool EventLoop::update(int fd) {
+#ifdef __linux__
+    auto it = watches.find(fd);
+    if (it == watches.end() || (!it->second.reader && !it->second.writer)) {
+        if (it != watches.end()) {
+            watches.erase(it);
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return true;
+    }
+
+    epoll_event event{};
+    event.events = (it->second.reader ? static_cast<uint32_t>(EPOLLIN) : 0u) |
+                   (it->second.writer ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) == 0) {
+        return true;
+    }
+    return errno == ENOENT && epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+#else
+    return false;
+#endif
+}
+
+void EventLoop::poll(bool block) {
+    // Time to wait for the next timer, in milliseconds, or -1 to wait for file descriptors alone
+    int timeout = 0;
+    if (block) {
+        timeout = -1;
+        if (!timers.empty()) {
+            auto remaining = timers.top().deadline - Clock::now();
+            long long milliseconds = std::chrono::ceil<std::chrono::milliseconds>(remaining).count();
+            timeout = static_cast<int>(std::clamp<long long>(milliseconds, 0, std::numeric_limits<int>::max()));
+        }
+    }
+
+#ifdef __linux__
+    if (!watches.empty()) {
+        epoll_event events[64];
+        int count = epoll_wait(epollFd, events, 64, timeout);
+
+        for (int i = 0; i < count; ++i) {
+            auto it = watches.find(events[i].data.fd);
+            if (it == watches.end()) {
+                continue;
+            }
+
+            // Errors and hangups wake both sides, which then see them when reading or writing
+            uint32_t ready = events[i].events;
+            if (it->second.reader && (ready & (EPOLLIN | EPOLLERR | EPOLLHUP))) {
+                scheduler.resume(std::move(it->second.reader));
+            }
+            if (it->second.writer && (ready & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+                scheduler.resume(std::move(it->second.writer));
+            }
+            update(events[i].data.fd);
+        }
+
+        expireTimers();
+        return;
+    }
+#endif
+
+    // Only timers are pending
+    if (timeout > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeout));
+    }
+    expireTimers();
+}
+
+void EventLoop::expireTimers() {
+    auto now = Clock::now();
+    while (!timers.empty() && timers.top().deadline <= now) {
+        // The queue only offers const access, so the task is copied out before the timer is dropped
+        scheduler.resume(timers.top().task);
+        timers.pop();
+    }
+}
+
+std::vector<std::shared_ptr<LoxTask>> EventLoop::clear() {
+    std::vector<std::shared_ptr<LoxTask>> waiting;
+    for (auto& [fd, watch] : watches) {
+#ifdef __linux__
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+        for (auto* task : {&watch.reader, &watch.writer}) {
+            if (*task) {
+                waiting.push_back(std::move(*task));
+            }
+        }
+    }
+    watches.clear();
+    for (; !timers.empty(); timers.pop()) {
+        waiting.push_back(timers.top().task);
+    }
+    return waiting;
+}
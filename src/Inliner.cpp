@@ -0,0 +1,213 @@
+#include "../include/Inliner.hpp"
+
+#include <cstdint>
+
+void Inliner::inlineCalls(const std::vector<std::shared_ptr<Stmt>>& statements) {
+    for (const auto& stmt : statements) {
+        if (auto function = std::dynamic_pointer_cast<Function>(stmt)) {
+            addCandidate(functions, function, false);
+        }
+        else if (auto klass = std::dynamic_pointer_cast<Class>(stmt)) {
+            for (const auto& method : klass->methods) {
+                addCandidate(methods, method, true);
+            }
+        }
+    }
+
+    resolve(statements);
+}
+
+void Inliner::visitAssignExpr(std::shared_ptr<Assign> expr) {
+    resolve(expr->value);
+}
+
+void Inliner::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+    resolve(expr->left);
+    resolve(expr->right);
+}
+
+void Inliner::visitCallExpr(std::shared_ptr<Call> expr) {
+    resolve(expr->callee);
+    for (const auto& arg : expr->arguments) {
+        resolve(arg);
+    }
+
+    std::shared_ptr<InlineSite> site;
+    if (auto variable = std::dynamic_pointer_cast<Variable>(expr->callee)) {
+        // Only globals refer to top-level functions
+        auto it = functions.find(variable->name.lexeme);
+        if (it != functions.end() && !locals.contains(variable)) {
+            site = it->second;
+        }
+    }
+    else if (auto get = std::dynamic_pointer_cast<Get>(expr->callee)) {
+        auto it = methods.find(get->name.lexeme);
+        if (it != methods.end()) {
+            site = it->second;
+        }
+    }
+
+    if (site != nullptr && site->target->params.size() == expr->arguments.size()) {
+        expr->inlined = site;
+    }
+}
+
+void Inliner::visitGetExpr(std::shared_ptr<Get> expr) {
+    resolve(expr->object);
+}
+
+void Inliner::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+    resolve(expr->expression);
+}
+
+void Inliner::visitLiteralExpr(std::shared_ptr<Literal>) {}
+
+void Inliner::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+    resolve(expr->left);
+    resolve(expr->right);
+}
+
+void Inliner::visitSetExpr(std::shared_ptr<Set> expr) {
+    resolve(expr->object);
+    resolve(expr->value);
+}
+
+void Inliner::visitSuperExpr(std::shared_ptr<Super>) {}
+
+void Inliner::visitThisExpr(std::shared_ptr<This>) {}
+
+void Inliner::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+    resolve(expr->right);
+}
+
+void Inliner::visitVariableExpr(std::shared_ptr<Variable>) {}
+
+void Inliner::visitBlockStmt(std::shared_ptr<Block> stmt) {
+    resolve(stmt->statements);
+}
+
+void Inliner::visitClassStmt(std::shared_ptr<Class> stmt) {
+    for (const auto& method : stmt->methods) {
+        resolve(method->body);
+    }
+}
+
+void Inliner::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+    resolve(stmt->expression);
+}
+
+void Inliner::visitForStmt(std::shared_ptr<For> stmt) {
+    if (stmt->initializer != nullptr) {
+        resolve(stmt->initializer);
+    }
+    if (stmt->condition != nullptr) {
+        resolve(stmt->condition);
+    }
+    resolve(stmt->body);
+    if (stmt->increment != nullptr) {
+        resolve(stmt->increment);
+    }
+}
+
+void Inliner::visitFunctionStmt(std::shared_ptr<Function> stmt) {
+    resolve(stmt->body);
+}
+
+void Inliner::visitIfStmt(std::shared_ptr<If> stmt) {
+    resolve(stmt->condition);
+    resolve(stmt->thenBranch);
+    if (stmt->elseBranch != nullptr) {
+        resolve(stmt->elseBranch);
+    }
+}
+
+void Inliner::visitImportStmt(std::shared_ptr<Import>) {}
+
+void Inliner::visitPrintStmt(std::shared_ptr<Print> stmt) {
+    resolve(stmt->expression);
+}
+
+void Inliner::visitReturnStmt(std::shared_ptr<Return> stmt) {
+    if (stmt->value != nullptr) {
+        resolve(stmt->value);
+    }
+}
+
+void Inliner::visitVarStmt(std::shared_ptr<Var> stmt) {
+    if (stmt->initializer != nullptr) {
+        resolve(stmt->initializer);
+    }
+}
+
+void Inliner::visitWhileStmt(std::shared_ptr<While> stmt) {
+    resolve(stmt->condition);
+    resolve(stmt->body);
+}
+
+void Inliner::resolve(const std::vector<std::shared_ptr<Stmt>>& stmts) {
+    for (const auto& stmt : stmts) {
+        stmt->accept(*this);
+    }
+}
+
+void Inliner::resolve(const std::shared_ptr<Stmt>& stmt) { stmt->accept(*this); }
+
+void Inliner::resolve(const std::shared_ptr<Expr>& expr) { expr->accept(*this); }
+
+void Inliner::addCandidate(std::map<std::string, std::shared_ptr<InlineSite>>& candidates,
+                           const std::shared_ptr<Function>& function, bool method) {
+    const std::string& name = function->name.lexeme;
+    if (candidates.contains(name)) {
+        candidates[name] = nullptr;
+        return;
+    }
+
+    std::shared_ptr<Expr> body = inlinableBody(function);
+    if (method && name == "init") {
+        body = nullptr;
+    }
+    candidates[name] = body != nullptr ? std::make_shared<InlineSite>(InlineSite{function.get(), body, method}) : nullptr;
+}
+
+std::shared_ptr<Expr> Inliner::inlinableBody(const std::shared_ptr<Function>& function) {
+    if (function->body.size() != 1) {
+        return nullptr;
+    }
+
+    auto returnStmt = std::dynamic_pointer_cast<Return>(function->body[0]);
+    if (returnStmt == nullptr || returnStmt->value == nullptr || bodySize(returnStmt->value) > maxBodySize) {
+        return nullptr;
+    }
+    return returnStmt->value;
+}
+
+size_t Inliner::bodySize(const std::shared_ptr<Expr>& expr) {
+    auto add = [](size_t a, size_t b) { return a == SIZE_MAX || b == SIZE_MAX ? SIZE_MAX : a + b; };
+
+    if (std::dynamic_pointer_cast<Call>(expr)) {
+        return SIZE_MAX;
+    }
+    else if (auto assign = std::dynamic_pointer_cast<Assign>(expr)) {
+        return add(1, bodySize(assign->value));
+    }
+    else if (auto binary = std::dynamic_pointer_cast<Binary>(expr)) {
+        return add(1, add(bodySize(binary->left), bodySize(binary->right)));
+    }
+    else if (auto get = std::dynamic_pointer_cast<Get>(expr)) {
+        return add(1, bodySize(get->object));
+    }
+    else if (auto grouping = std::dynamic_pointer_cast<Grouping>(expr)) {
+        return bodySize(grouping->expression);
+    }
+    else if (auto logical = std::dynamic_pointer_cast<Logical>(expr)) {
+        return add(1, add(bodySize(logical->left), bodySize(logical->right)));
+    }
+    else if (auto set = std::dynamic_pointer_cast<Set>(expr)) {
+        return add(1, add(bodySize(set->object), bodySize(set->value)));
+    }
+    else if (auto unary = std::dynamic_pointer_cast<Unary>(expr)) {
+        return add(1, bodySize(unary->right));
+    }
+    // Literal, Super, This and Variable
+    return 1;
+}
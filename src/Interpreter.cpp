@@ -1,16 +1,51 @@
 #include "../include/Interpreter.hpp"
 
 #include "../include/Error.hpp"
+#include "../include/EscapeAnalysis.hpp"
+#include "../include/Inliner.hpp"
+#include "../include/IrBuilder.hpp"
+#include "../include/IrPasses.hpp"
+#include "../include/LoopAnalysis.hpp"
 #include "../include/LoxCallable.hpp"
 #include "../include/LoxClass.hpp"
 #include "../include/LoxFunction.hpp"
 #include "../include/LoxInstance.hpp"
 #include "../include/LoxReturn.hpp"
 #include "../include/NativeFunctions.hpp"
+#include "../include/NativeObject.hpp"
+#include "../include/Pool.hpp"
+#include "../include/RegisterVm.hpp"
+#include "../include/Resolver.hpp"
 #include "../include/Util.hpp"
 
 Interpreter::Interpreter() {
-    globals->define("clock", std::make_shared<NativeClock>());
+    using Signature = std::vector<ValueType>;
+
+    defineNative(std::make_shared<NativeFunction>("clock", Signature{}, nativeClock));
+    defineNative(std::make_shared<NativeFunction>("str", Signature{ValueType::ANY}, nativeStr));
+    defineNative(std::make_shared<NativeFunction>("len", Signature{ValueType::STRING}, nativeLen));
+    defineNative(std::make_shared<NativeFunction>("sqrt", Signature{ValueType::NUMBER}, nativeSqrt));
+    defineNative(std::make_shared<NativeFunction>("floor", Signature{ValueType::NUMBER}, nativeFloor));
+    defineNative(std::make_shared<NativeFunction>("abs", Signature{ValueType::NUMBER}, nativeAbs));
+    defineNative(std::make_shared<NativeFunction>("StringBuilder", Signature{}, nativeStringBuilder));
+    defineNative(std::make_shared<NativeFunction>("List", Signature{}, nativeList));
+    defineNative(std::make_shared<NativeFunction>("Map", Signature{}, nativeMap));
+    defineNative(std::make_shared<NativeFunction>("NumberArray", Signature{ValueType::NUMBER}, nativeNumberArray));
+    defineNative(std::make_shared<NativeFunction>("toNumberArray", Signature{ValueType::ANY}, nativeToNumberArray));
+    defineNative(std::make_shared<NativeFunction>("spawn", Signature{ValueType::ANY}, nativeSpawn));
+    defineNative(std::make_shared<NativeFunction>("yield", Signature{}, nativeYield));
+    defineNative(std::make_shared<NativeFunction>("await", Signature{ValueType::ANY}, nativeAwait));
+    defineNative(std::make_shared<NativeFunction>("sleep", Signature{ValueType::NUMBER}, nativeSleep));
+#ifdef __linux__
+    defineNative(std::make_shared<NativeFunction>("openFile", Signature{ValueType::STRING, ValueType::STRING}, nativeOpenFile));
+    defineNative(std::make_shared<NativeFunction>("pipe", Signature{}, nativePipe));
+    defineNative(std::make_shared<NativeFunction>("listen", Signature{ValueType::ANY}, nativeListen));
+    defineNative(std::make_shared<NativeFunction>("connect", Signature{ValueType::ANY}, nativeConnect));
+#endif
+}
+
+void Interpreter::defineNative(std::shared_ptr<NativeFunction> native) {
+    globals->define(native->name, std::shared_ptr<LoxCallable>(native));
 }
 
 void Interpreter::interpret(std::vector<std::shared_ptr<Stmt>> stmts) {
@@ -18,8 +53,15 @@ void Interpreter::interpret(std::vector<std::shared_ptr<Stmt>> stmts) {
         for (auto stmt : stmts) {
             execute(stmt);
         }
+
+        // Let spawned tasks run to completion
+        scheduler.finishAll();
     }
     catch (RuntimeError& error) {
+        scheduler.abandon();
+
+        // Keep program output ordered before the error message
+        output.flush();
         runtimeError(error);
     }
 }
@@ -41,6 +83,39 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     std::any left = evaluate(expr->left);
     std::any right = evaluate(expr->right);
 
+    // Skip the checks when both operands are proven to be numbers
+    if (expr->left->type == StaticType::NUMBER && expr->right->type == StaticType::NUMBER) {
+        double l = *std::any_cast<double>(&left);
+        double r = *std::any_cast<double>(&right);
+        switch (expr->oper.type) {
+            case TokenType::GREATER:
+                return l > r;
+            case TokenType::GREATER_EQUAL:
+                return l >= r;
+            case TokenType::LESS:
+                return l < r;
+            case TokenType::LESS_EQUAL:
+                return l <= r;
+            case TokenType::EQUAL_EQUAL:
+                return l == r;
+            case TokenType::BANG_EQUAL:
+                return l != r;
+            case TokenType::PLUS:
+                return l + r;
+            case TokenType::MINUS:
+                return l - r;
+            case TokenType::STAR:
+                return l * r;
+            case TokenType::SLASH:
+                if (r == 0) {
+                    throw RuntimeError(expr->oper, "Cannot divide by zero.");
+                }
+                return l / r;
+            default:
+                break;
+        }
+    }
+
     switch (expr->oper.type) {
         // Comparison operators
         case TokenType::GREATER:
@@ -98,34 +173,25 @@ std::any Interpreter::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     return nullptr;
 }
 std::any Interpreter::visitCallExpr(std::shared_ptr<Call> expr) {
-    std::any callee = evaluate(expr->callee);
-
-    std::vector<std::any> arguments;
-    for (auto arg : expr->arguments) {
-        arguments.push_back(evaluate(arg));
-    }
-
-    // Check that callee is a callable
-    std::shared_ptr<LoxCallable> function;
-    if (!(function = ptrAnyCast<NativeClock>(callee)) && !(function = ptrAnyCast<LoxFunction>(callee)) &&
-        !(function = ptrAnyCast<LoxClass>(callee))) {
-        throw RuntimeError(expr->paren, "Can only call functions and classes.");
-    }
-
-    if (arguments.size() != function->arity()) {
-        throw RuntimeError(expr->paren, "Expected " + std::to_string(function->arity()) + " arguments but got " +
-                                            std::to_string(arguments.size()) + ".");
+    if (expr->inlined != nullptr && optimizationLevel > 0) {
+        return callInlined(expr);
     }
-
-    return function->call(*this, arguments);
+    return callValue(evaluate(expr->callee), expr);
 }
 std::any Interpreter::visitGetExpr(std::shared_ptr<Get> expr) {
-    std::any obj = evaluate(expr->object);
-    if (auto instance = ptrAnyCast<LoxInstance>(obj)) {
-        return instance->get(expr->name);
+    if (expr->scalar != nullptr) {
+        auto& values = environment->ancestor(expr->scalar->depth)->values;
+        const std::any& object = values[expr->scalar->variable];
+        if (object.type() == typeid(ScalarReplaced)) {
+            auto field = values.find(expr->scalar->key);
+            if (field == values.end()) {
+                throw RuntimeError(expr->name, "Undefined property '" + expr->name.lexeme + "'.");
+            }
+            return field->second;
+        }
+        return getProperty(object, expr->name, expr->cache.get());
     }
-
-    throw RuntimeError(expr->name, "Only instances have properties.");
+    return getProperty(evaluate(expr->object), expr->name, expr->cache.get());
 }
 std::any Interpreter::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
     return evaluate(expr->expression);
@@ -144,6 +210,15 @@ std::any Interpreter::visitLogicalExpr(std::shared_ptr<Logical> expr) {
     return evaluate(expr->right);
 }
 std::any Interpreter::visitSetExpr(std::shared_ptr<Set> expr) {
+    if (expr->scalar != nullptr) {
+        auto env = environment->ancestor(expr->scalar->depth);
+        if (env->values[expr->scalar->variable].type() == typeid(ScalarReplaced)) {
+            std::any value = evaluate(expr->value);
+            env->values[expr->scalar->key] = value;
+            return value;
+        }
+    }
+
     std::any obj = evaluate(expr->object);
 
     std::shared_ptr<LoxInstance> instance;
@@ -152,19 +227,20 @@ std::any Interpreter::visitSetExpr(std::shared_ptr<Set> expr) {
     }
 
     std::any value = evaluate(expr->value);
-    instance->set(expr->name, value);
+    instance->set(expr->name, value, expr->cache.get());
     return value;
 }
 std::any Interpreter::visitSuperExpr(std::shared_ptr<Super> expr) {
     size_t distance = locals[expr];
-    auto superclass = ptrAnyCast<LoxClass>(environment->getAt(distance, "super"));
+    const auto& superMethods = std::any_cast<const SuperMethodTable&>(
+        environment->ancestor(distance)->values.find(superMethodsKey)->second);
     auto object = ptrAnyCast<LoxInstance>(environment->getAt(distance - 1, "this"));
 
-    auto method = superclass->findMethod(expr->method.lexeme);
+    const auto& method = superMethods[expr->site->index];
     if (method == nullptr) {
         throw RuntimeError(expr->method, "Undefined property '" + expr->method.lexeme + "'.");
     }
-    return method->bind(object);
+    return std::shared_ptr<LoxCallable>(method->bind(object));
 }
 std::any Interpreter::visitThisExpr(std::shared_ptr<This> expr) {
     return lookUpVariable(expr->keyword, expr);
@@ -174,6 +250,9 @@ std::any Interpreter::visitUnaryExpr(std::shared_ptr<Unary> expr) {
 
     switch (expr->oper.type) {
         case TokenType::MINUS:
+            if (expr->right->type == StaticType::NUMBER) {
+                return -*std::any_cast<double>(&right);
+            }
             checkNumberOperand(expr->oper, right);
             return -std::any_cast<double>(right);
         case TokenType::BANG:
@@ -187,64 +266,97 @@ std::any Interpreter::visitVariableExpr(std::shared_ptr<Variable> expr) {
     return lookUpVariable(expr->name, expr);
 }
 
-std::any Interpreter::visitBlockStmt(std::shared_ptr<Block> stmt) {
-    executeBlock(stmt->statements, std::make_shared<Environment>(environment));
-    return nullptr;
+void Interpreter::visitBlockStmt(std::shared_ptr<Block> stmt) {
+    executeBlock(stmt->statements, makePooled<Environment>(environment));
 }
-std::any Interpreter::visitClassStmt(std::shared_ptr<Class> stmt) {
+void Interpreter::visitClassStmt(std::shared_ptr<Class> stmt) {
     environment->define(stmt->name.lexeme, nullptr);
 
     std::any superclassVal = nullptr;
     std::shared_ptr<LoxClass> superclass;
     if (stmt->superclass != nullptr) {
         superclassVal = evaluate(stmt->superclass);
-        if (!(superclass = ptrAnyCast<LoxClass>(superclassVal))) {
+        if (!(superclass = callableAnyCast<LoxClass>(superclassVal))) {
             error(stmt->superclass->name, "Superclass must be a class.");
         }
 
-        environment = std::make_shared<Environment>(environment);
+        environment = makePooled<Environment>(environment);
         environment->define("super", superclassVal);
+
+        // The superclass's method table never changes, so super expressions are looked up once for the class
+        SuperMethodTable superMethods;
+        for (const auto& name : stmt->superMethods->names) {
+            superMethods.push_back(superclass != nullptr ? superclass->findMethod(name) : nullptr);
+        }
+        environment->define(superMethodsKey, std::move(superMethods));
     }
 
-    std::map<std::string, std::shared_ptr<LoxFunction>> methods;
+    LoxClass::MethodTable methods;
     for (auto method : stmt->methods) {
-        methods[method->name.lexeme] = std::make_shared<LoxFunction>(method, environment, method->name.lexeme == "init");
+        methods[method->name.lexeme] = makePooled<LoxFunction>(method, environment, method->name.lexeme == "init");
     }
 
-    auto loxClass = std::make_shared<LoxClass>(stmt->name.lexeme, superclass, std::move(methods));
+    auto loxClass = std::make_shared<LoxClass>(stmt->name.lexeme, superclass, std::move(methods), stmt.get());
 
     if (stmt->superclass != nullptr) {
         environment = environment->enclosing;
     }
 
-    environment->assign(stmt->name, loxClass);
-    return nullptr;
+    environment->assign(stmt->name, std::shared_ptr<LoxCallable>(loxClass));
 }
-std::any Interpreter::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+void Interpreter::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
     evaluate(stmt->expression);
-    return nullptr;
 }
-std::any Interpreter::visitFunctionStmt(std::shared_ptr<Function> stmt) {
-    auto function = std::make_shared<LoxFunction>(stmt, environment, false);
-    environment->define(stmt->name.lexeme, function);
-    return nullptr;
+void Interpreter::visitForStmt(std::shared_ptr<For> stmt) {
+    if (stmt->initializer == nullptr) {
+        runLoop(*stmt);
+        return;
+    }
+
+    // The initializer's variable lives in a scope around the loop, shared by every iteration
+    auto previous = environment;
+    try {
+        environment = makePooled<Environment>(environment);
+        execute(stmt->initializer);
+        runLoop(*stmt);
+    }
+    catch (...) {
+        environment = previous;
+        throw;
+    }
+
+    environment = previous;
+}
+void Interpreter::visitFunctionStmt(std::shared_ptr<Function> stmt) {
+    auto function = makePooled<LoxFunction>(stmt, environment, false);
+    environment->define(stmt->name.lexeme, std::shared_ptr<LoxCallable>(function));
 }
-std::any Interpreter::visitIfStmt(std::shared_ptr<If> stmt) {
+void Interpreter::visitIfStmt(std::shared_ptr<If> stmt) {
     if (isTruthy(evaluate(stmt->condition))) {
         execute(stmt->thenBranch);
     }
     else if (stmt->elseBranch) {
         execute(stmt->elseBranch);
     }
+}
+void Interpreter::visitImportStmt(std::shared_ptr<Import> stmt) {
+    auto path = imports.find(stmt);
+    auto module = path != imports.end() ? modules.find(path->second) : modules.end();
+    if (module == modules.end()) {
+        throw RuntimeError(stmt->path, "Module was not loaded.");
+    }
 
-    return nullptr;
+    // Each module runs once, in the global scope, the first time it is imported
+    if (importedModules.insert(module->first).second) {
+        executeBlock(module->second->statements, globals);
+    }
 }
-std::any Interpreter::visitPrintStmt(std::shared_ptr<Print> stmt) {
+void Interpreter::visitPrintStmt(std::shared_ptr<Print> stmt) {
     std::any obj = evaluate(stmt->expression);
-    std::cout << stringify(obj) << std::endl;
-    return nullptr;
+    output.write(stringify(obj));
+    output.write("\n");
 }
-std::any Interpreter::visitReturnStmt(std::shared_ptr<Return> stmt) {
+void Interpreter::visitReturnStmt(std::shared_ptr<Return> stmt) {
     std::any value = nullptr;
     if (stmt->value != nullptr) {
         value = evaluate(stmt->value);
@@ -252,25 +364,65 @@ std::any Interpreter::visitReturnStmt(std::shared_ptr<Return> stmt) {
 
     throw LoxReturn{value};
 }
-std::any Interpreter::visitVarStmt(std::shared_ptr<Var> stmt) {
+void Interpreter::visitVarStmt(std::shared_ptr<Var> stmt) {
+    if (stmt->scalar != nullptr && optimizationLevel > 0) {
+        defineScalar(stmt);
+        return;
+    }
+
     std::any value = nullptr;
     if (stmt->initializer != nullptr) {
         value = evaluate(stmt->initializer);
     }
 
     environment->define(stmt->name.lexeme, value);
-    return nullptr;
 }
-std::any Interpreter::visitWhileStmt(std::shared_ptr<While> stmt) {
+void Interpreter::visitWhileStmt(std::shared_ptr<While> stmt) {
     while (isTruthy(evaluate(stmt->condition))) {
         execute(stmt->body);
     }
+}
 
-    return nullptr;
+void Interpreter::addLocals(const ResolvedLocals& resolved) {
+    locals.insert(resolved.begin(), resolved.end());
+}
+void Interpreter::addImports(const ResolvedImports& resolved) {
+    imports.insert(resolved.begin(), resolved.end());
+}
+void Interpreter::removeProgram(const Program& program) {
+    for (const auto& [expr, depth] : program.locals) {
+        locals.erase(expr);
+    }
+    for (const auto& [import, path] : program.imports) {
+        imports.erase(import);
+    }
+    std::erase_if(registerCode, [](const auto& entry) { return entry.first.expired(); });
+}
+void Interpreter::addModule(const std::string& path, std::shared_ptr<const Program> module) {
+    auto& current = modules[path];
+    if (current != module) {
+        current = module;
+        addLocals(module->locals);
+        addImports(module->imports);
+    }
+}
+void Interpreter::markImported(const std::string& path) {
+    importedModules.insert(path);
 }
 
-void Interpreter::resolve(std::shared_ptr<Expr> expr, size_t depth) {
-    locals[expr] = depth;
+std::optional<std::any> Interpreter::getGlobal(const std::string& name) {
+    auto it = globals->values.find(name);
+    if (it == globals->values.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+void Interpreter::defineGlobal(const std::string& name, const std::any& value) {
+    globals->define(name, value);
+}
+std::any* Interpreter::findGlobal(const std::string& name) {
+    auto it = globals->values.find(name);
+    return it != globals->values.end() ? &it->second : nullptr;
 }
 
 std::any Interpreter::evaluate(std::shared_ptr<Expr> expr) {
@@ -320,17 +472,11 @@ void Interpreter::checkNumberOperands(const Token& op, const std::any& left, con
 }
 
 std::string Interpreter::stringify(std::any obj) {
-    std::shared_ptr<LoxCallable> callable;
-
     if (obj.type() == typeid(nullptr)) {
         return "nil";
     }
     else if (obj.type() == typeid(double)) {
-        std::string text = std::to_string(std::any_cast<double>(obj));
-        if (text.size() >= 8 && text.substr(text.size() - 7, 7) == ".000000") {
-            text = text.substr(0, text.size() - 7);
-        }
-        return text;
+        return numberToString(std::any_cast<double>(obj));
     }
     else if (obj.type() == typeid(bool)) {
         return boolToString(obj);
@@ -338,12 +484,15 @@ std::string Interpreter::stringify(std::any obj) {
     else if (obj.type() == typeid(std::string)) {
         return std::any_cast<std::string>(obj);
     }
-    else if ((callable = ptrAnyCast<LoxFunction>(obj)) || (callable = ptrAnyCast<LoxClass>(obj))) {
+    else if (auto callable = ptrAnyCast<LoxCallable>(obj)) {
         return callable->toString();
     }
     else if (std::shared_ptr<LoxInstance> inst = ptrAnyCast<LoxInstance>(obj)) {
         return inst->toString();
     }
+    else if (auto native = ptrAnyCast<NativeObject>(obj)) {
+        return native->toString(*this);
+    }
 
     return "Unrecognized type in Interpreter::stringify(): " + std::string(obj.type().name());
 }
@@ -351,6 +500,179 @@ std::string Interpreter::stringify(std::any obj) {
 void Interpreter::execute(std::shared_ptr<Stmt> stmt) {
     stmt->accept(*this);
 }
+void Interpreter::runLoop(const For& stmt) {
+    const LoopPlan* plan = optimizationLevel > 0 ? stmt.plan.get() : nullptr;
+
+    // A body that declares nothing outliving its iteration runs in one environment, emptied every time
+    const Block* block = nullptr;
+    std::shared_ptr<Environment> bodyEnvironment;
+    if (plan != nullptr && plan->reuseBody) {
+        block = static_cast<const Block*>(stmt.body.get());
+        bodyEnvironment = makePooled<Environment>(environment);
+    }
+    auto runBody = [&]() {
+        if (block == nullptr) {
+            execute(stmt.body);
+            return;
+        }
+        bodyEnvironment->values.clear();
+        executeBlock(block->statements, bodyEnvironment);
+    };
+
+    // Step a counter holding a number in place, for as long as the limit is a number too. Only the increment
+    // assigns the counter, so its storage stays put.
+    double* counter = nullptr;
+    if (plan != nullptr && plan->counted) {
+        counter = std::any_cast<double>(&environment->values.at(plan->counter));
+    }
+    while (counter != nullptr) {
+        std::any limit = evaluate(plan->limit);
+        const double* bound = std::any_cast<double>(&limit);
+        if (bound == nullptr) {
+            // Leave any error to the condition
+            break;
+        }
+
+        bool inRange = false;
+        switch (plan->comparison) {
+            case TokenType::GREATER:
+                inRange = *counter > *bound;
+                break;
+            case TokenType::GREATER_EQUAL:
+                inRange = *counter >= *bound;
+                break;
+            case TokenType::LESS:
+                inRange = *counter < *bound;
+                break;
+            case TokenType::LESS_EQUAL:
+                inRange = *counter <= *bound;
+                break;
+            default:
+                // LoopAnalysis only plans loops bounded by one of the comparisons above
+                break;
+        }
+        if (!inRange) {
+            return;
+        }
+
+        runBody();
+        *counter += plan->step;
+    }
+
+    while (stmt.condition == nullptr || isTruthy(evaluate(stmt.condition))) {
+        runBody();
+        if (stmt.increment != nullptr) {
+            evaluate(stmt.increment);
+        }
+    }
+}
+std::any Interpreter::callValue(const std::any& callee, const std::shared_ptr<Call>& expr) {
+    std::vector<std::any> arguments;
+    for (auto arg : expr->arguments) {
+        arguments.push_back(evaluate(arg));
+    }
+
+    // Check that callee is a callable
+    std::shared_ptr<LoxCallable> function = ptrAnyCast<LoxCallable>(callee);
+    if (!function) {
+        throw RuntimeError(expr->paren, "Can only call functions and classes.");
+    }
+
+    if (arguments.size() != function->arity()) {
+        throw RuntimeError(expr->paren, "Expected " + std::to_string(function->arity()) + " arguments but got " +
+                                            std::to_string(arguments.size()) + ".");
+    }
+
+    try {
+        return function->call(*this, arguments);
+    }
+    catch (NativeError& error) {
+        throw RuntimeError(expr->paren, error.what());
+    }
+}
+std::any Interpreter::callInlined(const std::shared_ptr<Call>& expr) {
+    const InlineSite& site = *expr->inlined;
+
+    // Guard against the global or field having been rebound, calling whatever it holds now instead
+    std::shared_ptr<LoxFunction> function;
+    std::shared_ptr<LoxInstance> instance;
+    if (site.method) {
+        auto get = std::static_pointer_cast<Get>(expr->callee);
+        std::any object = evaluate(get->object);
+        instance = ptrAnyCast<LoxInstance>(object);
+        if (instance != nullptr) {
+            function = instance->findMethod(get->name.lexeme);
+        }
+        if (function == nullptr || function->declaration.get() != site.target) {
+            return callValue(getProperty(object, get->name, get->cache.get()), expr);
+        }
+    }
+    else {
+        std::any callee = evaluate(expr->callee);
+        auto callable = ptrAnyCast<LoxCallable>(callee);
+        function = std::dynamic_pointer_cast<LoxFunction>(callable);
+        if (function == nullptr || function->declaration.get() != site.target) {
+            return callValue(callee, expr);
+        }
+    }
+
+    // Bind the arguments, and "this" for a method, as calling the function would, but evaluate the returned
+    // expression directly instead of running the body
+    std::shared_ptr<Environment> closure = function->closure;
+    if (instance != nullptr) {
+        closure = makePooled<Environment>(closure);
+        closure->define("this", instance);
+    }
+    auto env = makePooled<Environment>(closure);
+    for (size_t i = 0, len = expr->arguments.size(); i < len; ++i) {
+        env->define(site.target->params[i].lexeme, evaluate(expr->arguments[i]));
+    }
+
+    auto previous = environment;
+    environment = env;
+    try {
+        std::any result = evaluate(site.body);
+        environment = previous;
+        return result;
+    }
+    catch (...) {
+        environment = previous;
+        throw;
+    }
+}
+void Interpreter::defineScalar(const std::shared_ptr<Var>& stmt) {
+    const ScalarSite& site = *stmt->scalar;
+    auto call = std::static_pointer_cast<Call>(stmt->initializer);
+
+    // Guard against the global having been rebound, defining whatever calling it returns instead
+    std::any callee = evaluate(call->callee);
+    auto loxClass = callableAnyCast<LoxClass>(callee);
+    if (loxClass == nullptr || loxClass->declaration != site.klass) {
+        environment->define(stmt->name.lexeme, callValue(callee, call));
+        return;
+    }
+
+    std::vector<std::any> arguments;
+    for (const auto& arg : call->arguments) {
+        arguments.push_back(evaluate(arg));
+    }
+
+    // Set the fields as the initializer would, but as variables of the scope rather than of a new instance
+    environment->define(stmt->name.lexeme, ScalarReplaced{});
+    for (const auto& field : site.fields) {
+        environment->define(field.key, field.argument != ScalarSite::noArgument ? arguments[field.argument] : field.constant);
+    }
+}
+std::any Interpreter::getProperty(const std::any& obj, const Token& name, PropertyCache* cache) {
+    if (auto instance = ptrAnyCast<LoxInstance>(obj)) {
+        return instance->get(name, cache);
+    }
+    else if (auto native = ptrAnyCast<NativeObject>(obj)) {
+        return native->get(name);
+    }
+
+    throw RuntimeError(name, "Only instances have properties.");
+}
 void Interpreter::executeBlock(const std::vector<std::shared_ptr<Stmt>>& statements, std::shared_ptr<Environment> env) {
     auto previous = environment;
 
@@ -368,6 +690,22 @@ void Interpreter::executeBlock(const std::vector<std::shared_ptr<Stmt>>& stateme
 
     environment = previous;
 }
+const RegisterVm* Interpreter::registerCodeFor(const std::shared_ptr<Function>& function) {
+    if (!useRegisterVm) {
+        return nullptr;
+    }
+
+    auto it = registerCode.find(function);
+    if (it == registerCode.end()) {
+        std::shared_ptr<const RegisterVm> code;
+        if (auto ir = IrBuilder(locals).build(function)) {
+            IrPassManager::standard().run(*ir);
+            code = std::make_shared<RegisterVm>(*ir);
+        }
+        it = registerCode.emplace(function, std::move(code)).first;
+    }
+    return it->second.get();
+}
 std::any Interpreter::lookUpVariable(const Token& name, std::shared_ptr<Expr> expr) {
     auto it = locals.find(expr);
     if (it != locals.end()) {
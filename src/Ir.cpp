@@ -0,0 +1,321 @@
+#include "../include/Ir.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <set>
+#include <sstream>
+
+#include "../include/Util.hpp"
+
+namespace {
+const char* opName(IrOp op) {
+    switch (op) {
+        case IrOp::CONST:
+            return "const";
+        case IrOp::PARAM:
+            return "param";
+        case IrOp::COPY:
+            return "copy";
+        case IrOp::PHI:
+            return "phi";
+        case IrOp::LOAD_GLOBAL:
+            return "load.global";
+        case IrOp::STORE_GLOBAL:
+            return "store.global";
+        case IrOp::LOAD_ENV:
+            return "load.env";
+        case IrOp::STORE_ENV:
+            return "store.env";
+        case IrOp::CHECK_NUMBER:
+            return "check.number";
+        case IrOp::ADD:
+            return "add";
+        case IrOp::SUBTRACT:
+            return "sub";
+        case IrOp::MULTIPLY:
+            return "mul";
+        case IrOp::DIVIDE:
+            return "div";
+        case IrOp::NEGATE:
+            return "neg";
+        case IrOp::NOT:
+            return "not";
+        case IrOp::EQUAL:
+            return "eq";
+        case IrOp::NOT_EQUAL:
+            return "ne";
+        case IrOp::GREATER:
+            return "gt";
+        case IrOp::GREATER_EQUAL:
+            return "ge";
+        case IrOp::LESS:
+            return "lt";
+        case IrOp::LESS_EQUAL:
+            return "le";
+        case IrOp::CALL:
+            return "call";
+        case IrOp::GET:
+            return "get";
+        case IrOp::FIELD_TARGET:
+            return "field.target";
+        case IrOp::SET:
+            return "set";
+        case IrOp::SUPER:
+            return "super";
+        case IrOp::PRINT:
+            return "print";
+        case IrOp::JUMP:
+            return "jump";
+        case IrOp::BRANCH:
+            return "branch";
+        case IrOp::RETURN:
+            return "return";
+    }
+    return "?";
+}
+
+bool isTerminator(IrOp op) {
+    return op == IrOp::JUMP || op == IrOp::BRANCH || op == IrOp::RETURN;
+}
+}  // namespace
+
+bool IrInstruction::hasSideEffects() const {
+    switch (op) {
+        case IrOp::STORE_GLOBAL:
+        case IrOp::STORE_ENV:
+        case IrOp::CALL:
+        case IrOp::SET:
+        case IrOp::PRINT:
+        case IrOp::JUMP:
+        case IrOp::BRANCH:
+        case IrOp::RETURN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool IrInstruction::mayThrow() const {
+    switch (op) {
+        case IrOp::LOAD_GLOBAL:
+        case IrOp::STORE_GLOBAL:
+        case IrOp::CHECK_NUMBER:
+        case IrOp::CALL:
+        case IrOp::GET:
+        case IrOp::FIELD_TARGET:
+        case IrOp::SUPER:
+            return true;
+        case IrOp::ADD:
+        case IrOp::GREATER:
+        case IrOp::GREATER_EQUAL:
+        case IrOp::LESS:
+        case IrOp::LESS_EQUAL:
+            return !numeric;
+        case IrOp::DIVIDE:
+            // Only division by zero is left to check
+            return !(operands[1]->op == IrOp::CONST && std::any_cast<double>(operands[1]->constant) != 0);
+        default:
+            return false;
+    }
+}
+
+bool IrInstruction::isPure() const {
+    switch (op) {
+        case IrOp::CONST:
+        case IrOp::COPY:
+        case IrOp::CHECK_NUMBER:
+        case IrOp::ADD:
+        case IrOp::SUBTRACT:
+        case IrOp::MULTIPLY:
+        case IrOp::DIVIDE:
+        case IrOp::NEGATE:
+        case IrOp::NOT:
+        case IrOp::EQUAL:
+        case IrOp::NOT_EQUAL:
+        case IrOp::GREATER:
+        case IrOp::GREATER_EQUAL:
+        case IrOp::LESS:
+        case IrOp::LESS_EQUAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool IrInstruction::yieldsNumber() const {
+    switch (op) {
+        case IrOp::CONST:
+            return constant.type() == typeid(double);
+        case IrOp::CHECK_NUMBER:
+        case IrOp::SUBTRACT:
+        case IrOp::MULTIPLY:
+        case IrOp::DIVIDE:
+        case IrOp::NEGATE:
+            return true;
+        case IrOp::ADD:
+            return numeric;
+        default:
+            return false;
+    }
+}
+
+std::string IrInstruction::toString() const {
+    std::ostringstream out;
+    if (!hasSideEffects() || op == IrOp::CALL) {
+        out << "v" << id << " = ";
+    }
+    out << opName(op);
+    if (numeric && (op == IrOp::ADD || op == IrOp::GREATER || op == IrOp::GREATER_EQUAL || op == IrOp::LESS ||
+                    op == IrOp::LESS_EQUAL)) {
+        out << ".num";
+    }
+
+    if (op == IrOp::CONST) {
+        if (constant.type() == typeid(double)) {
+            out << ' ' << numberToString(std::any_cast<double>(constant));
+        }
+        else if (constant.type() == typeid(std::string)) {
+            out << " \"" << std::any_cast<std::string>(constant) << '"';
+        }
+        else if (constant.type() == typeid(bool)) {
+            out << ' ' << boolToString(constant);
+        }
+        else {
+            out << " nil";
+        }
+    }
+    if (op == IrOp::PARAM || op == IrOp::LOAD_ENV || op == IrOp::STORE_ENV) {
+        out << ' ' << index;
+    }
+    if (token != nullptr && (op == IrOp::LOAD_GLOBAL || op == IrOp::STORE_GLOBAL || op == IrOp::LOAD_ENV ||
+                             op == IrOp::STORE_ENV || op == IrOp::GET || op == IrOp::FIELD_TARGET || op == IrOp::SET ||
+                             op == IrOp::SUPER)) {
+        out << ' ' << token->lexeme;
+    }
+    for (size_t i = 0; i < operands.size(); ++i) {
+        out << (i == 0 ? " " : ", ") << 'v' << operands[i]->id;
+        if (op == IrOp::PHI) {
+            out << " [b" << block->predecessors[i]->id << ']';
+        }
+    }
+    for (size_t i = 0; i < targets.size(); ++i) {
+        out << (i == 0 && operands.empty() ? " " : ", ") << 'b' << targets[i]->id;
+    }
+    return out.str();
+}
+
+IrInstruction* IrBlock::terminator() const {
+    if (instructions.empty() || !isTerminator(instructions.back()->op)) {
+        return nullptr;
+    }
+    return instructions.back().get();
+}
+
+std::vector<IrBlock*> IrBlock::successors() const {
+    IrInstruction* last = terminator();
+    return last != nullptr ? last->targets : std::vector<IrBlock*>{};
+}
+
+IrBlock* IrFunction::addBlock() {
+    blocks.push_back(std::make_unique<IrBlock>(blocks.size()));
+    return blocks.back().get();
+}
+
+void IrFunction::renumber() {
+    size_t value = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        blocks[i]->id = i;
+        for (auto& instruction : blocks[i]->instructions) {
+            instruction->id = value++;
+        }
+    }
+    valueCount = value;
+}
+
+std::vector<IrBlock*> IrFunction::reversePostOrder() const {
+    std::vector<IrBlock*> order;
+    std::set<IrBlock*> visited;
+
+    // Iterative depth-first search, since loops can nest deeply
+    std::vector<std::pair<IrBlock*, size_t>> stack{{blocks.front().get(), 0}};
+    visited.insert(blocks.front().get());
+    while (!stack.empty()) {
+        auto& [block, next] = stack.back();
+        std::vector<IrBlock*> successors = block->successors();
+        if (next < successors.size()) {
+            IrBlock* successor = successors[next++];
+            if (visited.insert(successor).second) {
+                stack.emplace_back(successor, 0);
+            }
+        }
+        else {
+            order.push_back(block);
+            stack.pop_back();
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+void IrFunction::removeUnreachableBlocks() {
+    std::vector<IrBlock*> order = reversePostOrder();
+    std::set<IrBlock*> reachable(order.begin(), order.end());
+
+    for (IrBlock* block : order) {
+        // Drop the phi operands coming from unreachable predecessors
+        for (size_t i = block->predecessors.size(); i-- > 0;) {
+            if (reachable.contains(block->predecessors[i])) {
+                continue;
+            }
+            for (auto& instruction : block->instructions) {
+                if (instruction->op == IrOp::PHI) {
+                    instruction->operands.erase(instruction->operands.begin() + i);
+                }
+            }
+            block->predecessors.erase(block->predecessors.begin() + i);
+        }
+    }
+
+    // Keep the remaining blocks in their original order, so listings follow the source
+    std::erase_if(blocks, [&](const std::unique_ptr<IrBlock>& block) { return !reachable.contains(block.get()); });
+}
+
+void IrFunction::replaceUses(const std::vector<std::pair<IrInstruction*, IrInstruction*>>& replacements) {
+    std::map<IrInstruction*, IrInstruction*> map(replacements.begin(), replacements.end());
+    std::function<IrInstruction*(IrInstruction*)> resolve = [&](IrInstruction* value) {
+        auto it = map.find(value);
+        if (it == map.end()) {
+            return value;
+        }
+        return it->second = resolve(it->second);
+    };
+
+    for (auto& block : blocks) {
+        for (auto& instruction : block->instructions) {
+            for (IrInstruction*& operand : instruction->operands) {
+                operand = resolve(operand);
+            }
+        }
+    }
+}
+
+std::string IrFunction::toString() const {
+    std::ostringstream out;
+    out << "function " << name << '/' << arity << '\n';
+    for (const auto& block : blocks) {
+        out << "b" << block->id << ':';
+        if (!block->predecessors.empty()) {
+            out << "  ; preds";
+            for (IrBlock* predecessor : block->predecessors) {
+                out << " b" << predecessor->id;
+            }
+        }
+        out << '\n';
+        for (const auto& instruction : block->instructions) {
+            out << "    " << instruction->toString() << '\n';
+        }
+    }
+    return out.str();
+}
@@ -0,0 +1,400 @@
+#include "../include/IrBuilder.hpp"
+
+namespace {
+/// @brief Thrown while lowering a construct the IR doesn't support.
+struct Unsupported {};
+
+void collectFunctions(const std::shared_ptr<Stmt>& stmt, std::vector<std::shared_ptr<Function>>& functions) {
+    if (auto function = std::dynamic_pointer_cast<Function>(stmt)) {
+        functions.push_back(function);
+        for (const auto& inner : function->body) {
+            collectFunctions(inner, functions);
+        }
+    }
+    else if (auto loxClass = std::dynamic_pointer_cast<Class>(stmt)) {
+        for (const auto& method : loxClass->methods) {
+            collectFunctions(method, functions);
+        }
+    }
+    else if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+        for (const auto& inner : block->statements) {
+            collectFunctions(inner, functions);
+        }
+    }
+    else if (auto ifStmt = std::dynamic_pointer_cast<If>(stmt)) {
+        collectFunctions(ifStmt->thenBranch, functions);
+        if (ifStmt->elseBranch != nullptr) {
+            collectFunctions(ifStmt->elseBranch, functions);
+        }
+    }
+    else if (auto whileStmt = std::dynamic_pointer_cast<While>(stmt)) {
+        collectFunctions(whileStmt->body, functions);
+    }
+    else if (auto forStmt = std::dynamic_pointer_cast<For>(stmt)) {
+        collectFunctions(forStmt->body, functions);
+    }
+}
+}  // namespace
+
+std::unique_ptr<IrFunction> IrBuilder::build(const std::shared_ptr<Function>& declaration) {
+    auto result = std::make_unique<IrFunction>(declaration->name.lexeme, declaration->params.size());
+    function = result.get();
+    scopes.clear();
+    definitions.clear();
+    incompletePhis.clear();
+    sealed.clear();
+    variableCount = 0;
+
+    block = function->addBlock();
+    seal(block);
+
+    try {
+        // Parameters and the body share one scope, as in the Resolver
+        scopes.emplace_back();
+        for (size_t i = 0; i < declaration->params.size(); ++i) {
+            IrInstruction* param = emit(IrOp::PARAM);
+            param->index = i;
+            writeVariable(declare(declaration->params[i].lexeme), block, param);
+        }
+        for (const auto& stmt : declaration->body) {
+            execute(stmt);
+        }
+        emit(IrOp::RETURN, {constant(nullptr)});
+    }
+    catch (Unsupported&) {
+        return nullptr;
+    }
+
+    function->removeUnreachableBlocks();
+    function->renumber();
+    return result;
+}
+
+std::vector<std::shared_ptr<Function>> IrBuilder::functionsIn(const std::vector<std::shared_ptr<Stmt>>& statements) {
+    std::vector<std::shared_ptr<Function>> functions;
+    for (const auto& stmt : statements) {
+        collectFunctions(stmt, functions);
+    }
+    return functions;
+}
+
+IrInstruction* IrBuilder::visitAssignExpr(std::shared_ptr<Assign> expr) {
+    IrInstruction* value = evaluate(expr->value);
+    write(expr, expr->name, value);
+    return value;
+}
+IrInstruction* IrBuilder::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+    IrInstruction* left = evaluate(expr->left);
+    IrInstruction* right = evaluate(expr->right);
+    const Token* op = &expr->oper;
+
+    // Checks the Interpreter makes before an operation become explicit, so they can be proven redundant
+    switch (expr->oper.type) {
+        case TokenType::GREATER:
+            return emit(IrOp::GREATER, {emit(IrOp::CHECK_NUMBER, {left}, op), right}, op);
+        case TokenType::GREATER_EQUAL:
+            return emit(IrOp::GREATER_EQUAL, {left, right}, op);
+        case TokenType::LESS:
+            return emit(IrOp::LESS, {left, right}, op);
+        case TokenType::LESS_EQUAL:
+            return emit(IrOp::LESS_EQUAL, {left, right}, op);
+        case TokenType::EQUAL_EQUAL:
+            return emit(IrOp::EQUAL, {left, right}, op);
+        case TokenType::BANG_EQUAL:
+            return emit(IrOp::NOT_EQUAL, {left, right}, op);
+        case TokenType::PLUS:
+            return emit(IrOp::ADD, {left, right}, op);
+        case TokenType::MINUS:
+            return emit(IrOp::SUBTRACT, {emit(IrOp::CHECK_NUMBER, {left}, op), emit(IrOp::CHECK_NUMBER, {right}, op)}, op);
+        case TokenType::STAR:
+            return emit(IrOp::MULTIPLY, {emit(IrOp::CHECK_NUMBER, {left}, op), emit(IrOp::CHECK_NUMBER, {right}, op)}, op);
+        case TokenType::SLASH:
+            return emit(IrOp::DIVIDE, {emit(IrOp::CHECK_NUMBER, {left}, op), emit(IrOp::CHECK_NUMBER, {right}, op)}, op);
+        default:
+            throw Unsupported{};
+    }
+}
+IrInstruction* IrBuilder::visitCallExpr(std::shared_ptr<Call> expr) {
+    std::vector<IrInstruction*> operands{evaluate(expr->callee)};
+    for (const auto& arg : expr->arguments) {
+        operands.push_back(evaluate(arg));
+    }
+    return emit(IrOp::CALL, operands, &expr->paren);
+}
+IrInstruction* IrBuilder::visitGetExpr(std::shared_ptr<Get> expr) {
+    return emit(IrOp::GET, {evaluate(expr->object)}, &expr->name);
+}
+IrInstruction* IrBuilder::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+    return evaluate(expr->expression);
+}
+IrInstruction* IrBuilder::visitLiteralExpr(std::shared_ptr<Literal> expr) {
+    return constant(expr->value);
+}
+IrInstruction* IrBuilder::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+    IrInstruction* left = evaluate(expr->left);
+    IrBlock* right = function->addBlock();
+    IrBlock* join = function->addBlock();
+
+    if (expr->oper.type == TokenType::OR) {
+        branch(left, join, right);
+    }
+    else {
+        branch(left, right, join);
+    }
+    seal(right);
+
+    block = right;
+    IrInstruction* value = evaluate(expr->right);
+    jump(join);
+    seal(join);
+
+    block = join;
+    IrInstruction* phi = addPhi(join);
+    phi->operands = {left, value};
+    return phi;
+}
+IrInstruction* IrBuilder::visitSetExpr(std::shared_ptr<Set> expr) {
+    IrInstruction* instance = emit(IrOp::FIELD_TARGET, {evaluate(expr->object)}, &expr->name);
+    IrInstruction* value = evaluate(expr->value);
+    emit(IrOp::SET, {instance, value}, &expr->name);
+    return value;
+}
+IrInstruction* IrBuilder::visitSuperExpr(std::shared_ptr<Super> expr) {
+    // "this" is bound in the environment just inside the one holding "super"
+    static const Token thisToken(TokenType::THIS, "this", nullptr, 0);
+    size_t depth = locals.at(expr) - scopes.size();
+
+    IrInstruction* superclass = emit(IrOp::LOAD_ENV, {}, &expr->keyword);
+    superclass->index = depth;
+    IrInstruction* object = emit(IrOp::LOAD_ENV, {}, &thisToken);
+    object->index = depth - 1;
+    return emit(IrOp::SUPER, {superclass, object}, &expr->method);
+}
+IrInstruction* IrBuilder::visitThisExpr(std::shared_ptr<This> expr) {
+    return read(expr, expr->keyword);
+}
+IrInstruction* IrBuilder::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+    IrInstruction* right = evaluate(expr->right);
+    if (expr->oper.type == TokenType::MINUS) {
+        return emit(IrOp::NEGATE, {emit(IrOp::CHECK_NUMBER, {right}, &expr->oper)}, &expr->oper);
+    }
+    return emit(IrOp::NOT, {right}, &expr->oper);
+}
+IrInstruction* IrBuilder::visitVariableExpr(std::shared_ptr<Variable> expr) {
+    return read(expr, expr->name);
+}
+
+void IrBuilder::visitBlockStmt(std::shared_ptr<Block> stmt) {
+    scopes.emplace_back();
+    for (const auto& inner : stmt->statements) {
+        execute(inner);
+    }
+    scopes.pop_back();
+}
+void IrBuilder::visitClassStmt(std::shared_ptr<Class>) {
+    throw Unsupported{};
+}
+void IrBuilder::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+    evaluate(stmt->expression);
+}
+void IrBuilder::visitForStmt(std::shared_ptr<For> stmt) {
+    // The initializer's scope encloses the whole loop, as in the Resolver
+    if (stmt->initializer != nullptr) {
+        scopes.emplace_back();
+        execute(stmt->initializer);
+    }
+    loop(stmt->condition, stmt->body, stmt->increment);
+    if (stmt->initializer != nullptr) {
+        scopes.pop_back();
+    }
+}
+void IrBuilder::visitFunctionStmt(std::shared_ptr<Function>) {
+    throw Unsupported{};
+}
+void IrBuilder::visitIfStmt(std::shared_ptr<If> stmt) {
+    IrInstruction* condition = evaluate(stmt->condition);
+    IrBlock* thenBlock = function->addBlock();
+    IrBlock* elseBlock = stmt->elseBranch != nullptr ? function->addBlock() : nullptr;
+    IrBlock* join = function->addBlock();
+
+    branch(condition, thenBlock, elseBlock != nullptr ? elseBlock : join);
+    seal(thenBlock);
+
+    block = thenBlock;
+    execute(stmt->thenBranch);
+    jump(join);
+
+    if (elseBlock != nullptr) {
+        seal(elseBlock);
+        block = elseBlock;
+        execute(stmt->elseBranch);
+        jump(join);
+    }
+
+    seal(join);
+    block = join;
+}
+void IrBuilder::visitImportStmt(std::shared_ptr<Import>) {
+    throw Unsupported{};
+}
+void IrBuilder::visitPrintStmt(std::shared_ptr<Print> stmt) {
+    emit(IrOp::PRINT, {evaluate(stmt->expression)});
+}
+void IrBuilder::visitReturnStmt(std::shared_ptr<Return> stmt) {
+    IrInstruction* value = stmt->value != nullptr ? evaluate(stmt->value) : constant(nullptr);
+    emit(IrOp::RETURN, {value});
+
+    // Anything after the return is unreachable, and removed once the function is built
+    block = function->addBlock();
+    seal(block);
+}
+void IrBuilder::visitVarStmt(std::shared_ptr<Var> stmt) {
+    IrInstruction* value = stmt->initializer != nullptr ? evaluate(stmt->initializer) : constant(nullptr);
+    writeVariable(declare(stmt->name.lexeme), block, value);
+}
+void IrBuilder::visitWhileStmt(std::shared_ptr<While> stmt) {
+    loop(stmt->condition, stmt->body, nullptr);
+}
+
+void IrBuilder::loop(const std::shared_ptr<Expr>& condition, const std::shared_ptr<Stmt>& body,
+                     const std::shared_ptr<Expr>& increment) {
+    // The header isn't sealed until the back edge from the end of the body exists
+    IrBlock* header = function->addBlock();
+    jump(header);
+    block = header;
+
+    IrInstruction* test = condition != nullptr ? evaluate(condition) : constant(true);
+    IrBlock* bodyBlock = function->addBlock();
+    IrBlock* exit = function->addBlock();
+    branch(test, bodyBlock, exit);
+    seal(bodyBlock);
+
+    block = bodyBlock;
+    execute(body);
+    if (increment != nullptr) {
+        evaluate(increment);
+    }
+    jump(header);
+    seal(header);
+    seal(exit);
+
+    block = exit;
+}
+IrInstruction* IrBuilder::evaluate(const std::shared_ptr<Expr>& expr) {
+    return expr->accept(*this);
+}
+void IrBuilder::execute(const std::shared_ptr<Stmt>& stmt) {
+    stmt->accept(*this);
+}
+
+IrInstruction* IrBuilder::emit(IrOp op, std::vector<IrInstruction*> operands, const Token* token) {
+    auto instruction = std::make_unique<IrInstruction>(op, block);
+    instruction->operands = std::move(operands);
+    instruction->token = token;
+    block->instructions.push_back(std::move(instruction));
+    return block->instructions.back().get();
+}
+IrInstruction* IrBuilder::constant(const std::any& value) {
+    IrInstruction* instruction = emit(IrOp::CONST);
+    instruction->constant = value;
+    return instruction;
+}
+void IrBuilder::jump(IrBlock* target) {
+    emit(IrOp::JUMP)->targets = {target};
+    target->predecessors.push_back(block);
+}
+void IrBuilder::branch(IrInstruction* condition, IrBlock* ifTrue, IrBlock* ifFalse) {
+    emit(IrOp::BRANCH, {condition})->targets = {ifTrue, ifFalse};
+    ifTrue->predecessors.push_back(block);
+    ifFalse->predecessors.push_back(block);
+}
+
+size_t IrBuilder::declare(const std::string& name) {
+    return scopes.back()[name] = variableCount++;
+}
+IrInstruction* IrBuilder::read(const std::shared_ptr<Expr>& expr, const Token& name) {
+    auto it = locals.find(expr);
+    if (it == locals.end()) {
+        return emit(IrOp::LOAD_GLOBAL, {}, &name);
+    }
+
+    // Scopes within the function hold SSA values; the rest are environments of the closure
+    size_t depth = it->second;
+    if (depth < scopes.size()) {
+        return readVariable(scopes[scopes.size() - 1 - depth].at(name.lexeme), block);
+    }
+    IrInstruction* load = emit(IrOp::LOAD_ENV, {}, &name);
+    load->index = depth - scopes.size();
+    return load;
+}
+void IrBuilder::write(const std::shared_ptr<Expr>& expr, const Token& name, IrInstruction* value) {
+    auto it = locals.find(expr);
+    if (it == locals.end()) {
+        emit(IrOp::STORE_GLOBAL, {value}, &name);
+        return;
+    }
+
+    size_t depth = it->second;
+    if (depth < scopes.size()) {
+        writeVariable(scopes[scopes.size() - 1 - depth].at(name.lexeme), block, value);
+        return;
+    }
+    emit(IrOp::STORE_ENV, {value}, &name)->index = depth - scopes.size();
+}
+
+void IrBuilder::writeVariable(size_t variable, IrBlock* target, IrInstruction* value) {
+    definitions[target][variable] = value;
+}
+IrInstruction* IrBuilder::readVariable(size_t variable, IrBlock* target) {
+    auto& defined = definitions[target];
+    auto it = defined.find(variable);
+    if (it != defined.end()) {
+        return it->second;
+    }
+    return readVariableRecursive(variable, target);
+}
+IrInstruction* IrBuilder::readVariableRecursive(size_t variable, IrBlock* target) {
+    IrInstruction* value;
+    if (!sealed.contains(target)) {
+        value = addPhi(target);
+        incompletePhis[target].emplace_back(variable, value);
+    }
+    else if (target->predecessors.empty()) {
+        // Only in unreachable code, which is removed
+        IrBlock* current = block;
+        block = target;
+        value = constant(nullptr);
+        block = current;
+    }
+    else if (target->predecessors.size() == 1) {
+        value = readVariable(variable, target->predecessors.front());
+    }
+    else {
+        // Written before the operands are read, so loops find the phi instead of recursing forever
+        value = addPhi(target);
+        writeVariable(variable, target, value);
+        addPhiOperands(variable, value);
+    }
+    writeVariable(variable, target, value);
+    return value;
+}
+IrInstruction* IrBuilder::addPhi(IrBlock* target) {
+    auto phi = std::make_unique<IrInstruction>(IrOp::PHI, target);
+    auto position = target->instructions.begin();
+    while (position != target->instructions.end() && (*position)->op == IrOp::PHI) {
+        ++position;
+    }
+    return target->instructions.insert(position, std::move(phi))->get();
+}
+void IrBuilder::addPhiOperands(size_t variable, IrInstruction* phi) {
+    for (IrBlock* predecessor : phi->block->predecessors) {
+        phi->operands.push_back(readVariable(variable, predecessor));
+    }
+}
+void IrBuilder::seal(IrBlock* target) {
+    for (auto& [variable, phi] : incompletePhis[target]) {
+        addPhiOperands(variable, phi);
+    }
+    incompletePhis.erase(target);
+    sealed.insert(target);
+}
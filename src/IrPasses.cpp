@@ -0,0 +1,422 @@
+#include "../include/IrPasses.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace {
+/// @brief Immediate dominators, computed with the algorithm of Cooper, Harvey and Kennedy.
+class Dominators {
+   public:
+    explicit Dominators(const IrFunction& function) : order(function.reversePostOrder()) {
+        for (size_t i = 0; i < order.size(); ++i) {
+            position[order[i]] = i;
+        }
+
+        IrBlock* entry = order.front();
+        idom[entry] = entry;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t i = 1; i < order.size(); ++i) {
+                IrBlock* block = order[i];
+                IrBlock* dominator = nullptr;
+                for (IrBlock* predecessor : block->predecessors) {
+                    if (idom.contains(predecessor)) {
+                        dominator = dominator == nullptr ? predecessor : intersect(predecessor, dominator);
+                    }
+                }
+                if (idom[block] != dominator) {
+                    idom[block] = dominator;
+                    changed = true;
+                }
+            }
+        }
+
+        for (IrBlock* block : order) {
+            if (block != entry) {
+                children[idom[block]].push_back(block);
+            }
+        }
+    }
+
+    bool dominates(IrBlock* a, IrBlock* b) const {
+        while (true) {
+            if (a == b) {
+                return true;
+            }
+            IrBlock* parent = idom.at(b);
+            if (parent == b) {
+                return false;
+            }
+            b = parent;
+        }
+    }
+
+    // Blocks in reverse post-order
+    std::vector<IrBlock*> order;
+    std::map<IrBlock*, std::vector<IrBlock*>> children;
+
+   private:
+    std::map<IrBlock*, size_t> position;
+    std::map<IrBlock*, IrBlock*> idom;
+
+    IrBlock* intersect(IrBlock* a, IrBlock* b) {
+        while (a != b) {
+            while (position[a] > position[b]) {
+                a = idom[a];
+            }
+            while (position[b] > position[a]) {
+                b = idom[b];
+            }
+        }
+        return a;
+    }
+};
+
+/// @brief Removes the given instructions from their blocks.
+void erase(IrFunction& function, const std::set<IrInstruction*>& removed) {
+    for (auto& block : function.blocks) {
+        std::erase_if(block->instructions, [&](const std::unique_ptr<IrInstruction>& i) { return removed.contains(i.get()); });
+    }
+}
+
+bool isComparison(IrOp op) {
+    return op == IrOp::GREATER || op == IrOp::GREATER_EQUAL || op == IrOp::LESS || op == IrOp::LESS_EQUAL;
+}
+}  // namespace
+
+bool CopyPropagation::run(IrFunction& function) {
+    bool changed = false;
+    while (true) {
+        std::vector<std::pair<IrInstruction*, IrInstruction*>> replacements;
+        std::set<IrInstruction*> removed;
+
+        for (auto& block : function.blocks) {
+            for (auto& instruction : block->instructions) {
+                IrInstruction* value = nullptr;
+                if (instruction->op == IrOp::COPY) {
+                    value = instruction->operands.front();
+                }
+                else if (instruction->op == IrOp::PHI) {
+                    // Trivial if every operand is either one other value or the phi itself
+                    for (IrInstruction* operand : instruction->operands) {
+                        if (operand == instruction.get() || operand == value) {
+                            continue;
+                        }
+                        if (value != nullptr) {
+                            value = nullptr;
+                            break;
+                        }
+                        value = operand;
+                    }
+                }
+
+                if (value != nullptr) {
+                    replacements.emplace_back(instruction.get(), value);
+                    removed.insert(instruction.get());
+                }
+            }
+        }
+
+        if (replacements.empty()) {
+            return changed;
+        }
+        function.replaceUses(replacements);
+        erase(function, removed);
+        changed = true;
+    }
+}
+
+bool TypeCheckElimination::run(IrFunction& function) {
+    bool changed = false;
+
+    // Past a check, a value is known to be a number, so uses the check dominates can use its result instead
+    Dominators dominators(function);
+    std::map<const IrInstruction*, size_t> positions;
+    std::vector<IrInstruction*> checks;
+    for (auto& block : function.blocks) {
+        for (size_t i = 0; i < block->instructions.size(); ++i) {
+            positions[block->instructions[i].get()] = i;
+            if (block->instructions[i]->op == IrOp::CHECK_NUMBER) {
+                checks.push_back(block->instructions[i].get());
+            }
+        }
+    }
+    auto dominatesUse = [&](const IrInstruction* check, const IrInstruction* user, size_t operand) {
+        // A phi uses its operand at the end of the corresponding predecessor
+        IrBlock* block = user->op == IrOp::PHI ? user->block->predecessors[operand] : user->block;
+        if (block == check->block) {
+            return user->op == IrOp::PHI || positions.at(check) < positions.at(user);
+        }
+        return dominators.dominates(check->block, block);
+    };
+    for (IrInstruction* check : checks) {
+        IrInstruction* value = check->operands.front();
+        for (auto& block : function.blocks) {
+            for (auto& user : block->instructions) {
+                for (size_t i = 0; i < user->operands.size(); ++i) {
+                    if (user->operands[i] == value && user.get() != check && dominatesUse(check, user.get(), i)) {
+                        user->operands[i] = check;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Start from every value that may be a number and remove those that turn out not to be
+    std::set<IrInstruction*> numbers;
+    for (auto& block : function.blocks) {
+        for (auto& instruction : block->instructions) {
+            IrOp op = instruction->op;
+            if (instruction->yieldsNumber() || op == IrOp::ADD || op == IrOp::PHI || op == IrOp::COPY) {
+                numbers.insert(instruction.get());
+            }
+        }
+    }
+
+    auto allNumbers = [&](const IrInstruction* instruction) {
+        return std::all_of(instruction->operands.begin(), instruction->operands.end(),
+                           [&](IrInstruction* operand) { return numbers.contains(operand); });
+    };
+
+    bool shrinking = true;
+    while (shrinking) {
+        shrinking = false;
+        for (auto& block : function.blocks) {
+            for (auto& instruction : block->instructions) {
+                IrOp op = instruction->op;
+                bool derived = op == IrOp::ADD || op == IrOp::PHI || op == IrOp::COPY;
+                if (derived && !instruction->yieldsNumber() && numbers.contains(instruction.get()) && !allNumbers(instruction.get())) {
+                    numbers.erase(instruction.get());
+                    shrinking = true;
+                }
+            }
+        }
+    }
+
+    for (auto& block : function.blocks) {
+        for (auto& instruction : block->instructions) {
+            if (instruction->op == IrOp::CHECK_NUMBER && numbers.contains(instruction->operands.front())) {
+                instruction->op = IrOp::COPY;
+                changed = true;
+            }
+            else if ((instruction->op == IrOp::ADD || isComparison(instruction->op)) && !instruction->numeric &&
+                     allNumbers(instruction.get())) {
+                instruction->numeric = true;
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+bool CommonSubexpressionElimination::run(IrFunction& function) {
+    Dominators dominators(function);
+    std::map<IrInstruction*, IrInstruction*> replacements;
+    std::set<IrInstruction*> removed;
+
+    auto resolve = [&](IrInstruction* value) {
+        auto it = replacements.find(value);
+        return it != replacements.end() ? it->second : value;
+    };
+    auto key = [&](const IrInstruction* instruction) {
+        std::ostringstream out;
+        out << static_cast<int>(instruction->op) << ' ' << instruction->numeric;
+        for (IrInstruction* operand : instruction->operands) {
+            out << ' ' << resolve(operand);
+        }
+        const std::any& constant = instruction->constant;
+        if (constant.type() == typeid(double)) {
+            // Bit patterns, so 0 and -0 stay apart
+            double number = std::any_cast<double>(constant);
+            uint64_t bits;
+            std::memcpy(&bits, &number, sizeof(bits));
+            out << " n" << bits;
+        }
+        else if (constant.type() == typeid(std::string)) {
+            out << " s" << std::any_cast<const std::string&>(constant);
+        }
+        else if (constant.type() == typeid(bool)) {
+            out << " b" << std::any_cast<bool>(constant);
+        }
+        return out.str();
+    };
+
+    // Walk the dominator tree, so only available values are reused; each scope ends with its subtree
+    std::map<std::string, IrInstruction*> available;
+    std::vector<std::pair<IrBlock*, std::vector<std::string>>> stack{{dominators.order.front(), {}}};
+    std::vector<size_t> childIndex{0};
+    bool entered = false;
+    while (!stack.empty()) {
+        auto& [block, added] = stack.back();
+        if (!entered) {
+            for (auto& instruction : block->instructions) {
+                if (!instruction->isPure() || instruction->op == IrOp::COPY) {
+                    continue;
+                }
+                std::string k = key(instruction.get());
+                auto [it, inserted] = available.emplace(k, instruction.get());
+                if (inserted) {
+                    added.push_back(k);
+                }
+                else {
+                    replacements[instruction.get()] = it->second;
+                    removed.insert(instruction.get());
+                }
+            }
+        }
+
+        const auto& children = dominators.children[block];
+        if (childIndex.back() < children.size()) {
+            IrBlock* child = children[childIndex.back()++];
+            stack.emplace_back(child, std::vector<std::string>{});
+            childIndex.push_back(0);
+            entered = false;
+        }
+        else {
+            for (const auto& k : added) {
+                available.erase(k);
+            }
+            stack.pop_back();
+            childIndex.pop_back();
+            entered = true;
+        }
+    }
+
+    if (replacements.empty()) {
+        return false;
+    }
+    function.replaceUses({replacements.begin(), replacements.end()});
+    erase(function, removed);
+    return true;
+}
+
+bool LoopInvariantCodeMotion::run(IrFunction& function) {
+    Dominators dominators(function);
+    bool changed = false;
+
+    // Inner loops come later in reverse post-order, so visiting headers backwards lets code hoisted out of an inner
+    // loop be hoisted out of the outer one too
+    for (auto it = dominators.order.rbegin(); it != dominators.order.rend(); ++it) {
+        IrBlock* header = *it;
+
+        // A loop is a header plus every block that reaches one of its back edges without passing the header
+        std::set<IrBlock*> loop{header};
+        std::vector<IrBlock*> work;
+        bool hasBackEdge = false;
+        for (IrBlock* predecessor : header->predecessors) {
+            if (dominators.dominates(header, predecessor)) {
+                hasBackEdge = true;
+                if (loop.insert(predecessor).second) {
+                    work.push_back(predecessor);
+                }
+            }
+        }
+        if (!hasBackEdge) {
+            continue;
+        }
+        while (!work.empty()) {
+            IrBlock* block = work.back();
+            work.pop_back();
+            for (IrBlock* predecessor : block->predecessors) {
+                if (loop.insert(predecessor).second) {
+                    work.push_back(predecessor);
+                }
+            }
+        }
+
+        // Code can only be hoisted into a single entry whose only successor is the header
+        IrBlock* preheader = nullptr;
+        size_t entries = 0;
+        for (IrBlock* predecessor : header->predecessors) {
+            if (!loop.contains(predecessor)) {
+                preheader = predecessor;
+                ++entries;
+            }
+        }
+        if (entries != 1 || preheader->successors().size() != 1) {
+            continue;
+        }
+
+        for (IrBlock* block : dominators.order) {
+            if (!loop.contains(block)) {
+                continue;
+            }
+
+            auto& instructions = block->instructions;
+            for (size_t i = 0; i < instructions.size();) {
+                IrInstruction* instruction = instructions[i].get();
+                bool invariant = instruction->isPure() && !instruction->mayThrow() && instruction->op != IrOp::PHI &&
+                                 std::none_of(instruction->operands.begin(), instruction->operands.end(),
+                                              [&](IrInstruction* operand) { return loop.contains(operand->block); });
+                if (!invariant) {
+                    ++i;
+                    continue;
+                }
+
+                instruction->block = preheader;
+                auto& target = preheader->instructions;
+                target.insert(target.end() - 1, std::move(instructions[i]));
+                instructions.erase(instructions.begin() + i);
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+bool DeadCodeElimination::run(IrFunction& function) {
+    std::set<IrInstruction*> live;
+    std::vector<IrInstruction*> work;
+    for (auto& block : function.blocks) {
+        for (auto& instruction : block->instructions) {
+            if (instruction->hasSideEffects() || instruction->mayThrow()) {
+                live.insert(instruction.get());
+                work.push_back(instruction.get());
+            }
+        }
+    }
+    while (!work.empty()) {
+        IrInstruction* instruction = work.back();
+        work.pop_back();
+        for (IrInstruction* operand : instruction->operands) {
+            if (live.insert(operand).second) {
+                work.push_back(operand);
+            }
+        }
+    }
+
+    std::set<IrInstruction*> dead;
+    for (auto& block : function.blocks) {
+        for (auto& instruction : block->instructions) {
+            if (!live.contains(instruction.get())) {
+                dead.insert(instruction.get());
+            }
+        }
+    }
+    erase(function, dead);
+    return !dead.empty();
+}
+
+void IrPassManager::run(IrFunction& function) {
+    for (const auto& pass : passes) {
+        pass->run(function);
+    }
+    function.renumber();
+}
+
+IrPassManager IrPassManager::standard() {
+    IrPassManager manager;
+    manager.add(std::make_unique<CopyPropagation>());
+    manager.add(std::make_unique<TypeCheckElimination>());
+    manager.add(std::make_unique<CopyPropagation>());
+    manager.add(std::make_unique<CommonSubexpressionElimination>());
+    manager.add(std::make_unique<LoopInvariantCodeMotion>());
+    manager.add(std::make_unique<DeadCodeElimination>());
+    return manager;
+}
@@ -0,0 +1,90 @@
+#include "../include/Isolate.hpp"
+
+#include "../include/LoxCallable.hpp"
+#include "../include/ModuleLoader.hpp"
+
+#define DEBUG_PRINT 0
+
+std::shared_ptr<const Program> Isolate::compile(const std::string& source, const std::string& path) {
+    ErrorScope scope(state);
+    bool hadErrorBefore = state.hadError;
+    state.hadError = false;
+
+    ModuleLoader loader(path);
+    std::shared_ptr<const Program> program = loader.load(source);
+    if (!program) {
+        return nullptr;
+    }
+#if DEBUG_PRINT != 0
+    std::cout << "Compilation completed" << std::endl;
+#endif
+
+    state.hadError = hadErrorBefore;
+    return program;
+}
+
+void Isolate::run(std::shared_ptr<const Program> program) {
+    ErrorScope scope(state);
+
+    if (loaded.insert(program).second) {
+        interpreter.addLocals(program->locals);
+        interpreter.addImports(program->imports);
+        for (const auto& [path, module] : program->modules) {
+            interpreter.addModule(path, module);
+        }
+    }
+
+    // A cycle of imports leading back to the program must not run it a second time
+    if (!program->path.empty()) {
+        interpreter.markImported(program->path);
+    }
+    interpreter.interpret(program->statements);
+#if DEBUG_PRINT != 0
+    std::cout << "Interpreting completed" << std::endl;
+#endif
+}
+
+void Isolate::run(const std::string& source, const std::string& path) {
+    if (auto program = compile(source, path)) {
+        run(program);
+    }
+}
+
+void Isolate::unload(std::shared_ptr<const Program> program) {
+    if (loaded.erase(program)) {
+        interpreter.removeProgram(*program);
+    }
+}
+
+std::any Isolate::call(const std::string& name, const std::vector<std::any>& arguments) {
+    ErrorScope scope(state);
+    Token token(TokenType::IDENTIFIER, name, nullptr, 0);
+
+    try {
+        auto function = ptrAnyCast<LoxCallable>(interpreter.getGlobal(name).value_or(nullptr));
+        if (!function) {
+            throw RuntimeError(token, "'" + name + "' is not a function or class.");
+        }
+        if (arguments.size() != function->arity()) {
+            throw RuntimeError(token, "Expected " + std::to_string(function->arity()) + " arguments but got " +
+                                          std::to_string(arguments.size()) + ".");
+        }
+
+        try {
+            return function->call(interpreter, arguments);
+        }
+        catch (NativeError& error) {
+            throw RuntimeError(token, error.what());
+        }
+    }
+    catch (RuntimeError& error) {
+        interpreter.getOutput().flush();
+        runtimeError(error);
+    }
+
+    return nullptr;
+}
+
+void Isolate::defineNative(const std::string& name, const std::vector<ValueType>& signature, NativeFunction::Fn function) {
+    interpreter.defineNative(std::make_shared<NativeFunction>(name, signature, std::move(function)));
+}
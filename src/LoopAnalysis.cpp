@@ -0,0 +1,135 @@
+#include "../include/LoopAnalysis.hpp"
+
+void LoopAnalysis::analyze(const std::vector<std::shared_ptr<Stmt>>& statements) {
+    ClosureAnalysis(locals, closures).analyze(&statements, statements);
+    for (const auto& [expr, slot] : closures.references) {
+        if (dynamic_cast<const Assign*>(expr) != nullptr) {
+            ++assignments[slot];
+        }
+    }
+
+    for (const auto& stmt : statements) {
+        analyze(stmt);
+    }
+}
+
+void LoopAnalysis::analyze(const std::shared_ptr<Stmt>& stmt) {
+    if (auto function = std::dynamic_pointer_cast<Function>(stmt)) {
+        for (const auto& inner : function->body) {
+            analyze(inner);
+        }
+    }
+    else if (auto loxClass = std::dynamic_pointer_cast<Class>(stmt)) {
+        for (const auto& method : loxClass->methods) {
+            analyze(method);
+        }
+    }
+    else if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+        for (const auto& inner : block->statements) {
+            analyze(inner);
+        }
+    }
+    else if (auto ifStmt = std::dynamic_pointer_cast<If>(stmt)) {
+        analyze(ifStmt->thenBranch);
+        if (ifStmt->elseBranch != nullptr) {
+            analyze(ifStmt->elseBranch);
+        }
+    }
+    else if (auto whileStmt = std::dynamic_pointer_cast<While>(stmt)) {
+        analyze(whileStmt->body);
+    }
+    else if (auto forStmt = std::dynamic_pointer_cast<For>(stmt)) {
+        forStmt->plan = plan(*forStmt);
+        analyze(forStmt->body);
+    }
+}
+
+std::shared_ptr<LoopPlan> LoopAnalysis::plan(const For& loop) const {
+    auto result = std::make_shared<LoopPlan>();
+    result->reuseBody = std::dynamic_pointer_cast<Block>(loop.body) != nullptr && !declaresClosures(loop.body);
+    result->counted = planCounter(loop, *result);
+    return result->reuseBody || result->counted ? result : nullptr;
+}
+
+bool LoopAnalysis::planCounter(const For& loop, LoopPlan& result) const {
+    auto var = std::dynamic_pointer_cast<Var>(loop.initializer);
+    auto condition = std::dynamic_pointer_cast<Binary>(loop.condition);
+    auto assign = std::dynamic_pointer_cast<Assign>(loop.increment);
+    if (var == nullptr || condition == nullptr || assign == nullptr) {
+        return false;
+    }
+
+    // A captured counter could be read or assigned by any call
+    auto declaration = closures.declarations.find(var.get());
+    if (declaration == closures.declarations.end() || declaration->second->captured) {
+        return false;
+    }
+    const ClosureAnalysis::Slot* counter = declaration->second;
+    auto refersToCounter = [&](const std::shared_ptr<Expr>& expr) {
+        auto it = closures.references.find(expr.get());
+        return it != closures.references.end() && it->second == counter;
+    };
+
+    // counter <comparison> <literal or variable>
+    switch (condition->oper.type) {
+        case TokenType::GREATER:
+        case TokenType::GREATER_EQUAL:
+        case TokenType::LESS:
+        case TokenType::LESS_EQUAL:
+            break;
+        default:
+            return false;
+    }
+    if (std::dynamic_pointer_cast<Variable>(condition->left) == nullptr || !refersToCounter(condition->left) ||
+        (std::dynamic_pointer_cast<Literal>(condition->right) == nullptr &&
+         std::dynamic_pointer_cast<Variable>(condition->right) == nullptr)) {
+        return false;
+    }
+
+    // counter = counter +|- <number>
+    auto sum = std::dynamic_pointer_cast<Binary>(assign->value);
+    auto step = sum != nullptr ? std::dynamic_pointer_cast<Literal>(sum->right) : nullptr;
+    if (!refersToCounter(assign) || step == nullptr || step->value.type() != typeid(double) ||
+        (sum->oper.type != TokenType::PLUS && sum->oper.type != TokenType::MINUS) ||
+        std::dynamic_pointer_cast<Variable>(sum->left) == nullptr || !refersToCounter(sum->left)) {
+        return false;
+    }
+
+    // Only the increment may assign the counter
+    if (assignments.at(counter) != 1) {
+        return false;
+    }
+
+    result.counter = var->name.lexeme;
+    result.comparison = condition->oper.type;
+    result.limit = condition->right;
+    result.step = std::any_cast<double>(step->value);
+    if (sum->oper.type == TokenType::MINUS) {
+        result.step = -result.step;
+    }
+    return true;
+}
+
+bool LoopAnalysis::declaresClosures(const std::shared_ptr<Stmt>& stmt) {
+    if (std::dynamic_pointer_cast<Function>(stmt) || std::dynamic_pointer_cast<Class>(stmt)) {
+        return true;
+    }
+    else if (auto block = std::dynamic_pointer_cast<Block>(stmt)) {
+        for (const auto& inner : block->statements) {
+            if (declaresClosures(inner)) {
+                return true;
+            }
+        }
+    }
+    else if (auto ifStmt = std::dynamic_pointer_cast<If>(stmt)) {
+        return declaresClosures(ifStmt->thenBranch) ||
+               (ifStmt->elseBranch != nullptr && declaresClosures(ifStmt->elseBranch));
+    }
+    else if (auto whileStmt = std::dynamic_pointer_cast<While>(stmt)) {
+        return declaresClosures(whileStmt->body);
+    }
+    else if (auto forStmt = std::dynamic_pointer_cast<For>(stmt)) {
+        return declaresClosures(forStmt->body);
+    }
+    return false;
+}
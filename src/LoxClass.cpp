@@ -1,8 +1,30 @@
 #include "../include/LoxClass.hpp"
 #include "../include/LoxInstance.hpp"
+#include "../include/Pool.hpp"
+
+namespace {
+/// @brief Returns the given methods merged over the superclass's (already flattened) methods.
+LoxClass::MethodTable flatten(const std::shared_ptr<LoxClass>& superclass, LoxClass::MethodTable&& methods) {
+    if (superclass != nullptr) {
+        // insert() keeps the subclass's override when a name already exists
+        methods.insert(superclass->methods.begin(), superclass->methods.end());
+    }
+    return std::move(methods);
+}
+
+// Ids start at 1, since an empty PropertyCache holds 0
+std::atomic<uint32_t> nextClassId{1};
+}  // namespace
+
+LoxClass::LoxClass(const std::string& s, std::shared_ptr<LoxClass> super, MethodTable&& methds, const Class* decl)
+    : name(s),
+      id(nextClassId.fetch_add(1, std::memory_order_relaxed)),
+      superclass(super),
+      declaration(decl),
+      methods(flatten(super, std::move(methds))),
+      initializer(findMethod("init")) {}
 
 size_t LoxClass::arity() {
-    auto initializer = findMethod("init");
     if (initializer) {
         return initializer->arity();
     }
@@ -10,8 +32,7 @@ size_t LoxClass::arity() {
     return 0;
 }
 std::any LoxClass::call(Interpreter& interpreter, const std::vector<std::any>& arguments) {
-    auto loxInstance = std::make_shared<LoxInstance>(shared_from_this());
-    auto initializer = findMethod("init");
+    auto loxInstance = makePooled<LoxInstance>(shared_from_this());
     if (initializer != nullptr) {
         initializer->bind(loxInstance)->call(interpreter, arguments);
     }
@@ -22,13 +43,51 @@ std::string LoxClass::toString() const {
     return name;
 }
 
-std::shared_ptr<LoxFunction> LoxClass::findMethod(const std::string& name) const {
-    if (methods.contains(name)) {
-        return methods.at(name);
+size_t LoxClass::findFieldSlot(const std::string& name) const {
+    auto it = fieldSlots.find(name);
+    return it != fieldSlots.end() ? it->second : noSlot;
+}
+size_t LoxClass::addFieldSlot(const std::string& name) {
+    auto it = fieldSlots.find(name);
+    if (it != fieldSlots.end()) {
+        return it->second;
     }
-    if (superclass != nullptr) {
-        return superclass->findMethod(name);
+    if (fieldSlots.size() >= maxFieldSlots) {
+        return noSlot;
+    }
+
+    size_t slot = fieldSlots.size();
+    fieldSlots.emplace(name, slot);
+    return slot;
+}
+size_t LoxClass::findFieldSlot(const std::string& name, PropertyCache& cache) const {
+    size_t slot = cachedSlot(cache);
+    if (slot == noSlot) {
+        slot = findFieldSlot(name);
+        cacheSlot(cache, slot);
+    }
+    return slot;
+}
+size_t LoxClass::addFieldSlot(const std::string& name, PropertyCache& cache) {
+    size_t slot = cachedSlot(cache);
+    if (slot == noSlot) {
+        slot = addFieldSlot(name);
+        cacheSlot(cache, slot);
+    }
+    return slot;
+}
+
+size_t LoxClass::cachedSlot(const PropertyCache& cache) const {
+    uint64_t entry = cache.entry.load(std::memory_order_relaxed);
+    return entry >> 32 == id ? static_cast<size_t>(entry & 0xffffffff) : noSlot;
+}
+void LoxClass::cacheSlot(PropertyCache& cache, size_t slot) const {
+    if (slot != noSlot) {
+        cache.entry.store(static_cast<uint64_t>(id) << 32 | slot, std::memory_order_relaxed);
     }
+}
 
-    return nullptr;
+std::shared_ptr<LoxFunction> LoxClass::findMethod(const std::string& name) const {
+    auto it = methods.find(name);
+    return it != methods.end() ? it->second : nullptr;
 }
\ No newline at end of file
@@ -1,9 +1,16 @@
 #include "../include/LoxFunction.hpp"
 
 #include "../include/LoxReturn.hpp"
+#include "../include/Pool.hpp"
+#include "../include/RegisterVm.hpp"
 
 std::any LoxFunction::call(Interpreter& interpreter, const std::vector<std::any>& arguments) {
-    std::shared_ptr<Environment> environment = std::make_shared<Environment>(closure);
+    if (const RegisterVm* code = interpreter.registerCodeFor(declaration)) {
+        std::any result = code->execute(interpreter, closure, arguments);
+        return isInitializer ? closure->getAt(0, "this") : result;
+    }
+
+    std::shared_ptr<Environment> environment = makePooled<Environment>(closure);
 
     for (size_t i = 0, len = declaration->params.size(); i < len; ++i) {
         environment->define(declaration->params[i].lexeme, arguments[i]);
@@ -26,7 +33,7 @@ std::any LoxFunction::call(Interpreter& interpreter, const std::vector<std::any>
 }
 
 std::shared_ptr<LoxFunction> LoxFunction::bind(std::shared_ptr<LoxInstance> instance) {
-    auto environment = std::make_shared<Environment>(closure);
+    auto environment = makePooled<Environment>(closure);
     environment->define("this", instance);
-    return std::make_shared<LoxFunction>(declaration, environment, isInitializer);
+    return makePooled<LoxFunction>(declaration, environment, isInitializer);
 }
\ No newline at end of file
@@ -3,21 +3,48 @@
 
 #include "../include/Error.hpp"
 
-std::any LoxInstance::get(const Token& name) {
-    if (fields.contains(name.lexeme)) {
-        return fields[name.lexeme];
+std::any LoxInstance::get(const Token& name, PropertyCache* cache) {
+    size_t slot = cache != nullptr ? loxClass->findFieldSlot(name.lexeme, *cache) : loxClass->findFieldSlot(name.lexeme);
+    if (slot < slots.size() && slots[slot].has_value()) {
+        return slots[slot];
     }
-    else if (auto method = loxClass->findMethod(name.lexeme)) {
-        return method->bind(shared_from_this());
+    else if (dictionary) {
+        auto it = dictionary->find(name.lexeme);
+        if (it != dictionary->end()) {
+            return it->second;
+        }
+    }
+
+    if (auto method = loxClass->findMethod(name.lexeme)) {
+        return std::shared_ptr<LoxCallable>(method->bind(shared_from_this()));
     }
 
     throw RuntimeError(name, "Undefined property '" + name.lexeme + "'.");
 }
 
-void LoxInstance::set(const Token& name, const std::any& value) {
-    fields[name.lexeme] = value;
+std::shared_ptr<LoxFunction> LoxInstance::findMethod(const std::string& name) const {
+    size_t slot = loxClass->findFieldSlot(name);
+    if ((slot < slots.size() && slots[slot].has_value()) || (dictionary && dictionary->contains(name))) {
+        return nullptr;
+    }
+    return loxClass->findMethod(name);
+}
+void LoxInstance::set(const Token& name, const std::any& value, PropertyCache* cache) {
+    size_t slot = cache != nullptr ? loxClass->addFieldSlot(name.lexeme, *cache) : loxClass->addFieldSlot(name.lexeme);
+    if (slot == LoxClass::noSlot) {
+        if (!dictionary) {
+            dictionary = std::make_unique<std::unordered_map<std::string, std::any>>();
+        }
+        (*dictionary)[name.lexeme] = value;
+        return;
+    }
+
+    if (slot >= slots.size()) {
+        slots.resize(slot + 1);
+    }
+    slots[slot] = value;
 }
 
 std::string LoxInstance::toString() {
     return loxClass->name + " instance";
-}
\ No newline at end of file
+}
@@ -0,0 +1,64 @@
+#include "../include/LoxList.hpp"
+
+#include "../include/Error.hpp"
+
+std::string LoxList::toString(Interpreter& interpreter) {
+    if (printing) {
+        return "[...]";
+    }
+
+    printing = true;
+    std::string text = "[";
+    for (size_t i = 0, len = elements.size(); i < len; ++i) {
+        if (i > 0) {
+            text += ", ";
+        }
+        text += interpreter.stringify(elements[i]);
+    }
+    text += "]";
+    printing = false;
+
+    return text;
+}
+
+const NativeMethodTable& LoxList::methods() const {
+    static const NativeMethodTable table{
+        {"get", {{ValueType::NUMBER}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             auto& elements = static_cast<LoxList&>(self).elements;
+             return elements[toIndex(arguments[0], elements.size())];
+         }}},
+        {"set", {{ValueType::NUMBER, ValueType::ANY}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             auto& elements = static_cast<LoxList&>(self).elements;
+             elements[toIndex(arguments[0], elements.size())] = arguments[1];
+             return arguments[1];
+         }}},
+        {"push", {{ValueType::ANY}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             static_cast<LoxList&>(self).elements.push_back(arguments[0]);
+             return std::any(nullptr);
+         }}},
+        {"pop", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             auto& elements = static_cast<LoxList&>(self).elements;
+             if (elements.empty()) {
+                 throw NativeError("Can't pop from an empty list.");
+             }
+             std::any value = std::move(elements.back());
+             elements.pop_back();
+             return value;
+         }}},
+        {"length", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(static_cast<double>(static_cast<LoxList&>(self).elements.size()));
+         }}},
+        {"slice", {{ValueType::NUMBER, ValueType::NUMBER}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             auto& elements = static_cast<LoxList&>(self).elements;
+             // Both bounds may equal the length, since the end is exclusive
+             size_t start = toIndex(arguments[0], elements.size() + 1);
+             size_t end = toIndex(arguments[1], elements.size() + 1);
+             if (start > end) {
+                 throw NativeError("Slice start must not be after its end.");
+             }
+             std::vector<std::any> slice(elements.begin() + start, elements.begin() + end);
+             return std::any(std::shared_ptr<NativeObject>(std::make_shared<LoxList>(std::move(slice))));
+         }}},
+    };
+    return table;
+}
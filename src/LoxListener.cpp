@@ -0,0 +1,92 @@
+#include "../include/LoxListener.hpp"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "../include/Error.hpp"
+#include "../include/Interpreter.hpp"
+#include "../include/LoxStream.hpp"
+
+namespace {
+/// @brief Throws a NativeError describing errno, prefixed with the given message.
+[[noreturn]] void throwErrno(const std::string& message) {
+    throw NativeError(message + ": " + std::strerror(errno) + ".");
+}
+}  // namespace
+
+LoxListener::~LoxListener() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+std::shared_ptr<LoxListener> LoxListener::listen(const std::any& address) {
+    sockaddr_storage storage;
+    socklen_t length = toSocketAddress(address, storage);
+
+    int socketFd = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFd < 0) {
+        throwErrno("Could not create socket");
+    }
+    auto listener = std::make_shared<LoxListener>(socketFd);
+
+    if (storage.ss_family == AF_INET) {
+        int reuse = 1;
+        setsockopt(socketFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+    if (bind(socketFd, reinterpret_cast<sockaddr*>(&storage), length) < 0 || ::listen(socketFd, SOMAXCONN) < 0) {
+        throwErrno("Could not listen");
+    }
+    return listener;
+}
+
+const NativeMethodTable& LoxListener::methods() const {
+    static const NativeMethodTable table{
+        {"accept", {{}, [](Interpreter& interpreter, NativeObject& self, std::span<const std::any>) {
+             auto& listener = static_cast<LoxListener&>(self);
+
+             while (true) {
+                 if (listener.fd < 0) {
+                     throw NativeError("Listener is closed.");
+                 }
+                 int client = accept4(listener.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                 if (client >= 0) {
+                     return std::any(std::shared_ptr<NativeObject>(std::make_shared<LoxStream>(client)));
+                 }
+                 else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                     interpreter.getScheduler().getEvents().waitReadable(listener.fd);
+                 }
+                 else if (errno != EINTR && errno != ECONNABORTED) {
+                     throwErrno("Could not accept");
+                 }
+             }
+         }}},
+        {"port", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             sockaddr_storage storage{};
+             socklen_t length = sizeof(storage);
+             getsockname(static_cast<LoxListener&>(self).fd, reinterpret_cast<sockaddr*>(&storage), &length);
+             if (storage.ss_family != AF_INET) {
+                 return std::any(nullptr);
+             }
+             return std::any(static_cast<double>(ntohs(reinterpret_cast<sockaddr_in&>(storage).sin_port)));
+         }}},
+        {"close", {{}, [](Interpreter& interpreter, NativeObject& self, std::span<const std::any>) {
+             auto& listener = static_cast<LoxListener&>(self);
+             if (listener.fd >= 0) {
+                 interpreter.getScheduler().getEvents().forget(listener.fd);
+                 close(listener.fd);
+                 listener.fd = -1;
+             }
+             return std::any(nullptr);
+         }}},
+    };
+    return table;
+}
+
+#endif
@@ -0,0 +1,201 @@
+#include "../include/LoxMap.hpp"
+
+#include <functional>
+#include <string>
+
+#include "../include/Error.hpp"
+#include "../include/LoxList.hpp"
+
+std::any* LoxMap::find(const std::any& key) {
+    checkKey(key);
+    if (count == 0) {
+        return nullptr;
+    }
+
+    Slot& slot = probe(key, hashKey(key));
+    return slot.state == SlotState::FULL ? &slot.value : nullptr;
+}
+
+void LoxMap::insert(const std::any& key, const std::any& value) {
+    checkKey(key);
+
+    // Keep the load factor, counting tombstones, at or below 3/4
+    if ((used + 1) * 4 > slots.size() * 3) {
+        rehash(std::max(minCapacity, count * 4 > slots.size() ? slots.size() * 2 : slots.size()));
+    }
+
+    size_t hash = hashKey(key);
+    Slot& slot = probe(key, hash);
+    if (slot.state != SlotState::FULL) {
+        if (slot.state == SlotState::EMPTY) {
+            ++used;
+        }
+        ++count;
+        slot.state = SlotState::FULL;
+        slot.hash = hash;
+        slot.key = key;
+    }
+    slot.value = value;
+}
+
+bool LoxMap::erase(const std::any& key) {
+    checkKey(key);
+    if (count == 0) {
+        return false;
+    }
+
+    Slot& slot = probe(key, hashKey(key));
+    if (slot.state != SlotState::FULL) {
+        return false;
+    }
+
+    slot.state = SlotState::TOMBSTONE;
+    slot.key.reset();
+    slot.value.reset();
+    --count;
+    return true;
+}
+
+LoxMap::Slot& LoxMap::probe(const std::any& key, size_t hash) {
+    size_t mask = slots.size() - 1;
+    Slot* tombstone = nullptr;
+
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if (slot.state == SlotState::EMPTY) {
+            // Reuse the first tombstone passed, if any
+            return tombstone ? *tombstone : slot;
+        }
+        else if (slot.state == SlotState::TOMBSTONE) {
+            if (!tombstone) {
+                tombstone = &slot;
+            }
+        }
+        else if (slot.hash == hash && keysEqual(slot.key, key)) {
+            return slot;
+        }
+    }
+}
+
+void LoxMap::rehash(size_t capacity) {
+    std::vector<Slot> old = std::move(slots);
+    slots = std::vector<Slot>(capacity);
+    used = count;
+
+    size_t mask = capacity - 1;
+    for (Slot& entry : old) {
+        if (entry.state != SlotState::FULL) {
+            continue;
+        }
+        size_t i = entry.hash & mask;
+        while (slots[i].state != SlotState::EMPTY) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = std::move(entry);
+    }
+}
+
+void LoxMap::checkKey(const std::any& key) {
+    if (key.type() != typeid(double) && key.type() != typeid(std::string) && key.type() != typeid(bool)) {
+        throw NativeError("Map keys must be numbers, strings or booleans.");
+    }
+}
+
+size_t LoxMap::hashKey(const std::any& key) {
+    size_t hash;
+    if (key.type() == typeid(double)) {
+        double d = std::any_cast<double>(key);
+        // 0 and -0 are equal, so they must hash the same
+        hash = std::hash<double>{}(d == 0 ? 0.0 : d);
+    }
+    else if (key.type() == typeid(std::string)) {
+        hash = std::hash<std::string>{}(std::any_cast<const std::string&>(key));
+    }
+    else {
+        hash = std::any_cast<bool>(key);
+    }
+
+    // Mix the bits, since std::hash may be the identity and probing only looks at the low bits
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+bool LoxMap::keysEqual(const std::any& left, const std::any& right) {
+    if (left.type() != right.type()) {
+        return false;
+    }
+    if (left.type() == typeid(double)) {
+        return std::any_cast<double>(left) == std::any_cast<double>(right);
+    }
+    else if (left.type() == typeid(std::string)) {
+        return std::any_cast<const std::string&>(left) == std::any_cast<const std::string&>(right);
+    }
+    return std::any_cast<bool>(left) == std::any_cast<bool>(right);
+}
+
+std::string LoxMap::toString(Interpreter& interpreter) {
+    if (printing) {
+        return "{...}";
+    }
+
+    printing = true;
+    std::string text = "{";
+    bool first = true;
+    for (const Slot& slot : slots) {
+        if (slot.state != SlotState::FULL) {
+            continue;
+        }
+        if (!first) {
+            text += ", ";
+        }
+        first = false;
+        text += interpreter.stringify(slot.key) + ": " + interpreter.stringify(slot.value);
+    }
+    text += "}";
+    printing = false;
+
+    return text;
+}
+
+const NativeMethodTable& LoxMap::methods() const {
+    static const NativeMethodTable table{
+        {"get", {{ValueType::ANY}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             std::any* value = static_cast<LoxMap&>(self).find(arguments[0]);
+             return value ? *value : std::any(nullptr);
+         }}},
+        {"set", {{ValueType::ANY, ValueType::ANY}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             static_cast<LoxMap&>(self).insert(arguments[0], arguments[1]);
+             return arguments[1];
+         }}},
+        {"has", {{ValueType::ANY}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             return std::any(static_cast<LoxMap&>(self).find(arguments[0]) != nullptr);
+         }}},
+        {"delete", {{ValueType::ANY}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             return std::any(static_cast<LoxMap&>(self).erase(arguments[0]));
+         }}},
+        {"length", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(static_cast<double>(static_cast<LoxMap&>(self).size()));
+         }}},
+        {"keys", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             std::vector<std::any> keys;
+             for (const Slot& slot : static_cast<LoxMap&>(self).slots) {
+                 if (slot.state == SlotState::FULL) {
+                     keys.push_back(slot.key);
+                 }
+             }
+             return std::any(std::shared_ptr<NativeObject>(std::make_shared<LoxList>(std::move(keys))));
+         }}},
+        {"values", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             std::vector<std::any> values;
+             for (const Slot& slot : static_cast<LoxMap&>(self).slots) {
+                 if (slot.state == SlotState::FULL) {
+                     values.push_back(slot.value);
+                 }
+             }
+             return std::any(std::shared_ptr<NativeObject>(std::make_shared<LoxList>(std::move(values))));
+         }}},
+    };
+    return table;
+}
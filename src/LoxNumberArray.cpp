@@ -0,0 +1,135 @@
+#include "../include/LoxNumberArray.hpp"
+
+#include "../include/Error.hpp"
+#include "../include/LoxList.hpp"
+#include "../include/NumericKernels.hpp"
+#include "../include/Util.hpp"
+
+namespace {
+/// @brief Wraps the given numbers in a new LoxNumberArray.
+std::any makeArray(std::vector<double>&& elements) {
+    return std::shared_ptr<NativeObject>(std::make_shared<LoxNumberArray>(std::move(elements)));
+}
+
+/// @brief Returns the elements of the LoxNumberArray held by the given value, which must be as long as the given size.
+const std::vector<double>& otherArray(const std::any& value, size_t size) {
+    auto other = nativeAnyCast<LoxNumberArray>(value);
+    if (!other) {
+        throw NativeError("Operand must be a NumberArray.");
+    }
+    if (other->elements.size() != size) {
+        throw NativeError("NumberArrays must have the same length.");
+    }
+    return other->elements;
+}
+
+/// @brief Returns the elements of the given object, which must not be empty.
+const std::vector<double>& nonEmpty(NativeObject& self) {
+    const auto& elements = static_cast<LoxNumberArray&>(self).elements;
+    if (elements.empty()) {
+        throw NativeError("NumberArray is empty.");
+    }
+    return elements;
+}
+}  // namespace
+
+std::string LoxNumberArray::toString(Interpreter&) {
+    std::string text = "[";
+    for (size_t i = 0, len = elements.size(); i < len; ++i) {
+        if (i > 0) {
+            text += ", ";
+        }
+        text += numberToString(elements[i]);
+    }
+    text += "]";
+
+    return text;
+}
+
+const NativeMethodTable& LoxNumberArray::methods() const {
+    static const NativeMethodTable table{
+        {"get", {{ValueType::NUMBER}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             auto& elements = static_cast<LoxNumberArray&>(self).elements;
+             return std::any(elements[toIndex(arguments[0], elements.size())]);
+         }}},
+        {"set", {{ValueType::NUMBER, ValueType::NUMBER}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             auto& elements = static_cast<LoxNumberArray&>(self).elements;
+             elements[toIndex(arguments[0], elements.size())] = std::any_cast<double>(arguments[1]);
+             return arguments[1];
+         }}},
+        {"push", {{ValueType::NUMBER}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             static_cast<LoxNumberArray&>(self).elements.push_back(std::any_cast<double>(arguments[0]));
+             return std::any(nullptr);
+         }}},
+        {"length", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(static_cast<double>(static_cast<LoxNumberArray&>(self).elements.size()));
+         }}},
+        {"toList", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             const auto& elements = static_cast<LoxNumberArray&>(self).elements;
+             return std::any(std::shared_ptr<NativeObject>(std::make_shared<LoxList>(std::vector<std::any>(elements.begin(), elements.end()))));
+         }}},
+        {"sum", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(kernelSum(static_cast<LoxNumberArray&>(self).elements));
+         }}},
+        {"dot", {{ValueType::ANY}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             const auto& elements = static_cast<LoxNumberArray&>(self).elements;
+             return std::any(kernelDot(elements, otherArray(arguments[0], elements.size())));
+         }}},
+        {"min", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(kernelMin(nonEmpty(self)));
+         }}},
+        {"max", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(kernelMax(nonEmpty(self)));
+         }}},
+        {"scale", {{ValueType::NUMBER}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             const auto& elements = static_cast<LoxNumberArray&>(self).elements;
+             std::vector<double> result(elements.size());
+             kernelScale(elements, std::any_cast<double>(arguments[0]), result);
+             return makeArray(std::move(result));
+         }}},
+        {"add", {{ValueType::ANY}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             const auto& elements = static_cast<LoxNumberArray&>(self).elements;
+             std::vector<double> result(elements.size());
+             kernelAdd(elements, otherArray(arguments[0], elements.size()), result);
+             return makeArray(std::move(result));
+         }}},
+        {"apply", {{ValueType::STRING, ValueType::NUMBER}, [](Interpreter&, NativeObject& self, std::span<const std::any> arguments) {
+             const auto& elements = static_cast<LoxNumberArray&>(self).elements;
+             const auto& op = std::any_cast<const std::string&>(arguments[0]);
+             double operand = std::any_cast<double>(arguments[1]);
+             std::vector<double> result(elements.size());
+
+             if (op == "+") {
+                 kernelAddScalar(elements, operand, result);
+             }
+             else if (op == "-") {
+                 kernelSubScalar(elements, operand, result);
+             }
+             else if (op == "*") {
+                 kernelScale(elements, operand, result);
+             }
+             else if (op == "/") {
+                 // Same rule as the '/' operator
+                 if (operand == 0) {
+                     throw NativeError("Cannot divide by zero.");
+                 }
+                 kernelDivScalar(elements, operand, result);
+             }
+             else {
+                 throw NativeError("Operator must be one of \"+\", \"-\", \"*\" or \"/\".");
+             }
+             return makeArray(std::move(result));
+         }}},
+        {"prefixSum", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             const auto& elements = static_cast<LoxNumberArray&>(self).elements;
+             std::vector<double> result(elements.size());
+             kernelPrefixSum(elements, result);
+             return makeArray(std::move(result));
+         }}},
+        {"sort", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             kernelSort(static_cast<LoxNumberArray&>(self).elements);
+             return std::any(nullptr);
+         }}},
+    };
+    return table;
+}
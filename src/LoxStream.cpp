@@ -0,0 +1,153 @@
+#include "../include/LoxStream.hpp"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+
+#include <netinet/in.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../include/Error.hpp"
+#include "../include/Interpreter.hpp"
+
+namespace {
+constexpr size_t readChunkSize = 64 * 1024;
+
+/// @brief Throws a NativeError describing errno, prefixed with the given message.
+[[noreturn]] void throwErrno(const std::string& message) {
+    throw NativeError(message + ": " + std::strerror(errno) + ".");
+}
+}  // namespace
+
+socklen_t toSocketAddress(const std::any& address, sockaddr_storage& storage) {
+    storage = {};
+
+    if (address.type() == typeid(std::string)) {
+        const auto& path = std::any_cast<const std::string&>(address);
+        auto& unixAddress = reinterpret_cast<sockaddr_un&>(storage);
+        if (path.empty() || path.size() >= sizeof(unixAddress.sun_path)) {
+            throw NativeError("Socket path must be between 1 and " + std::to_string(sizeof(unixAddress.sun_path) - 1) +
+                              " characters long.");
+        }
+        unixAddress.sun_family = AF_UNIX;
+        std::memcpy(unixAddress.sun_path, path.data(), path.size());
+        return sizeof(sockaddr_un);
+    }
+    else if (address.type() == typeid(double)) {
+        double port = std::any_cast<double>(address);
+        if (port < 0 || port > 65535 || port != static_cast<int>(port)) {
+            throw NativeError("Port must be an integer between 0 and 65535.");
+        }
+        auto& inetAddress = reinterpret_cast<sockaddr_in&>(storage);
+        inetAddress.sin_family = AF_INET;
+        inetAddress.sin_port = htons(static_cast<uint16_t>(port));
+        inetAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return sizeof(sockaddr_in);
+    }
+    throw NativeError("Address must be a socket path or a port number.");
+}
+
+LoxStream::~LoxStream() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+std::shared_ptr<LoxStream> LoxStream::connect(Interpreter& interpreter, const std::any& address) {
+    sockaddr_storage storage;
+    socklen_t length = toSocketAddress(address, storage);
+
+    int socketFd = socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFd < 0) {
+        throwErrno("Could not create socket");
+    }
+    // Owns the descriptor from here on, closing it if connecting fails
+    auto stream = std::make_shared<LoxStream>(socketFd);
+
+    if (::connect(socketFd, reinterpret_cast<sockaddr*>(&storage), length) < 0) {
+        if (errno != EINPROGRESS && errno != EAGAIN) {
+            throwErrno("Could not connect");
+        }
+
+        interpreter.getScheduler().getEvents().waitWritable(socketFd);
+        int error = 0;
+        socklen_t errorLength = sizeof(error);
+        getsockopt(socketFd, SOL_SOCKET, SO_ERROR, &error, &errorLength);
+        if (error != 0) {
+            errno = error;
+            throwErrno("Could not connect");
+        }
+    }
+    return stream;
+}
+
+int LoxStream::checkOpen() const {
+    if (fd < 0) {
+        throw NativeError("Stream is closed.");
+    }
+    return fd;
+}
+
+const NativeMethodTable& LoxStream::methods() const {
+    static const NativeMethodTable table{
+        {"read", {{}, [](Interpreter& interpreter, NativeObject& self, std::span<const std::any>) {
+             auto& stream = static_cast<LoxStream&>(self);
+             std::string buffer(readChunkSize, '\0');
+
+             while (true) {
+                 ssize_t count = read(stream.checkOpen(), buffer.data(), buffer.size());
+                 if (count > 0) {
+                     buffer.resize(count);
+                     return std::any(std::move(buffer));
+                 }
+                 else if (count == 0) {
+                     return std::any(nullptr);
+                 }
+                 else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                     interpreter.getScheduler().getEvents().waitReadable(stream.fd);
+                 }
+                 else if (errno != EINTR) {
+                     throwErrno("Could not read");
+                 }
+             }
+         }}},
+        {"write", {{ValueType::STRING}, [](Interpreter& interpreter, NativeObject& self, std::span<const std::any> arguments) {
+             auto& stream = static_cast<LoxStream&>(self);
+             const auto& data = std::any_cast<const std::string&>(arguments[0]);
+
+             size_t written = 0;
+             while (written < data.size()) {
+                 // send() avoids SIGPIPE on sockets; anything else falls back to write()
+                 ssize_t count = send(stream.checkOpen(), data.data() + written, data.size() - written, MSG_NOSIGNAL);
+                 if (count < 0 && errno == ENOTSOCK) {
+                     count = write(stream.fd, data.data() + written, data.size() - written);
+                 }
+
+                 if (count >= 0) {
+                     written += count;
+                 }
+                 else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                     interpreter.getScheduler().getEvents().waitWritable(stream.fd);
+                 }
+                 else if (errno != EINTR) {
+                     throwErrno("Could not write");
+                 }
+             }
+             return std::any(nullptr);
+         }}},
+        {"close", {{}, [](Interpreter& interpreter, NativeObject& self, std::span<const std::any>) {
+             auto& stream = static_cast<LoxStream&>(self);
+             if (stream.fd >= 0) {
+                 interpreter.getScheduler().getEvents().forget(stream.fd);
+                 close(stream.fd);
+                 stream.fd = -1;
+             }
+             return std::any(nullptr);
+         }}},
+    };
+    return table;
+}
+
+#endif
@@ -0,0 +1,21 @@
+#include "../include/LoxStringBuilder.hpp"
+
+const NativeMethodTable& LoxStringBuilder::methods() const {
+    static const NativeMethodTable table{
+        {"append", {{ValueType::ANY}, [](Interpreter& interpreter, NativeObject& self, std::span<const std::any> arguments) {
+             static_cast<LoxStringBuilder&>(self).buffer += interpreter.stringify(arguments[0]);
+             return std::any(self.shared_from_this());
+         }}},
+        {"toString", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(static_cast<LoxStringBuilder&>(self).buffer);
+         }}},
+        {"length", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(static_cast<double>(static_cast<LoxStringBuilder&>(self).buffer.size()));
+         }}},
+        {"clear", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             static_cast<LoxStringBuilder&>(self).buffer.clear();
+             return std::any(nullptr);
+         }}},
+    };
+    return table;
+}
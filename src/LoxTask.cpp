@@ -0,0 +1,17 @@
+#include "../include/LoxTask.hpp"
+
+#include "../include/Interpreter.hpp"
+#include "../include/Scheduler.hpp"
+
+const NativeMethodTable& LoxTask::methods() const {
+    static const NativeMethodTable table{
+        {"done", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             return std::any(static_cast<LoxTask&>(self).finished);
+         }}},
+        {"await", {{}, [](Interpreter&, NativeObject& self, std::span<const std::any>) {
+             auto& task = static_cast<LoxTask&>(self);
+             return task.scheduler.await(task);
+         }}},
+    };
+    return table;
+}
@@ -0,0 +1,213 @@
+#include "../include/ModuleLoader.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+#include "../include/Error.hpp"
+#include "../include/EscapeAnalysis.hpp"
+#include "../include/Inliner.hpp"
+#include "../include/LoopAnalysis.hpp"
+#include "../include/Parser.hpp"
+#include "../include/Resolver.hpp"
+#include "../include/Scanner.hpp"
+#include "../include/ThreadPool.hpp"
+#include "../include/TypeInference.hpp"
+
+namespace {
+struct CacheEntry {
+    size_t hash;
+    std::shared_ptr<const Program> program;
+};
+
+std::mutex cacheMutex;
+// Compiled modules of this process, by canonical path
+std::unordered_map<std::string, CacheEntry> cache;
+
+/// @brief Returns the pool shared by every loader in the process.
+ThreadPool& frontEndPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+/// @brief Fills in the canonical path of every import in the given program, relative to the given directory.
+void resolveImports(Program& program, const std::filesystem::path& directory) {
+    // The resolver only allows imports at the top level
+    for (const auto& stmt : program.statements) {
+        if (auto import = std::dynamic_pointer_cast<Import>(stmt)) {
+            std::filesystem::path path = directory / std::any_cast<const std::string&>(import->path.literal);
+
+            // A path that can't be canonicalized can't be read either, which is reported once loading finishes
+            std::error_code error;
+            std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+            program.imports[import] = (error ? path.lexically_normal() : canonical).string();
+        }
+    }
+}
+}  // namespace
+
+ModuleLoader::ModuleLoader(const std::string& path) {
+    std::error_code error;
+    directory = std::filesystem::absolute(std::filesystem::path(path).parent_path(), error);
+    if (error) {
+        directory = std::filesystem::current_path(error);
+    }
+
+    // Canonicalized the way imports are, so a module importing this file back names the same path
+    if (!path.empty()) {
+        std::filesystem::path file = directory / std::filesystem::path(path).filename();
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(file, error);
+        entryPath = (error ? file.lexically_normal() : canonical).string();
+    }
+}
+
+std::shared_ptr<Program> ModuleLoader::compile(const std::string& source) {
+    Scanner scanner(source);
+    std::vector<Token> tokens = scanner.scanTokens();
+
+    auto program = std::make_shared<Program>();
+    Parser parser(tokens);
+    program->statements = parser.parse();
+    // Check for syntax error
+    if (errorState().hadError) {
+        return nullptr;
+    }
+
+    Resolver resolver(program->locals);
+    resolver.resolve(program->statements);
+    // Check for resolution error
+    if (errorState().hadError) {
+        return nullptr;
+    }
+
+    TypeInference(program->locals).infer(program->statements);
+    Inliner(program->locals).inlineCalls(program->statements);
+    EscapeAnalysis(program->locals).analyze(program->statements);
+    LoopAnalysis(program->locals).analyze(program->statements);
+
+    return program;
+}
+
+std::shared_ptr<const Program> ModuleLoader::load(const std::string& source) {
+    std::shared_ptr<Program> program = compile(source);
+    if (!program) {
+        return nullptr;
+    }
+    return load(program);
+}
+
+std::shared_ptr<const Program> ModuleLoader::load(std::shared_ptr<Program> program) {
+    resolveImports(*program, directory);
+    program->path = entryPath;
+    if (program->imports.empty()) {
+        return program;
+    }
+
+    {
+        std::unique_lock lock(mutex);
+        discover(*program);
+        finished.wait(lock, [this] { return pending == 0; });
+    }
+
+    std::map<std::string, bool> visited;
+    if (!collect(*program, *program, visited)) {
+        return nullptr;
+    }
+    return program;
+}
+
+void ModuleLoader::discover(const Program& program) {
+    for (const auto& [import, path] : program.imports) {
+        auto [it, inserted] = modules.try_emplace(path);
+        if (inserted) {
+            ++pending;
+            frontEndPool().submit([this, &path = it->first, &module = it->second] { loadModule(path, module); });
+        }
+    }
+}
+
+void ModuleLoader::loadModule(const std::string& path, Module& module) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        module.unreadable = true;
+    }
+    else {
+        std::string source(std::istreambuf_iterator<char>(file), {});
+        size_t hash = std::hash<std::string>{}(source);
+
+        {
+            std::lock_guard lock(cacheMutex);
+            auto it = cache.find(path);
+            if (it != cache.end() && it->second.hash == hash) {
+                module.program = it->second.program;
+            }
+        }
+
+        if (!module.program) {
+            // Report into the module's own buffer, to be shown in a deterministic order once everything has loaded
+            std::ostringstream errors;
+            ErrorState state;
+            state.stream = &errors;
+            std::shared_ptr<Program> program;
+            {
+                ErrorScope scope(state);
+                program = compile(source);
+            }
+
+            if (program) {
+                resolveImports(*program, std::filesystem::path(path).parent_path());
+                module.program = program;
+
+                std::lock_guard lock(cacheMutex);
+                cache[path] = {hash, program};
+            }
+            module.errors = std::move(errors).str();
+        }
+    }
+
+    std::lock_guard lock(mutex);
+    if (module.program) {
+        discover(*module.program);
+    }
+    if (--pending == 0) {
+        finished.notify_all();
+    }
+}
+
+bool ModuleLoader::collect(const Program& importer, Program& root, std::map<std::string, bool>& visited) {
+    bool succeeded = true;
+
+    // Imports are keyed by pointer, so visit them in source order instead
+    for (const auto& stmt : importer.statements) {
+        auto import = std::dynamic_pointer_cast<Import>(stmt);
+        if (!import) {
+            continue;
+        }
+
+        const std::string& path = importer.imports.at(import);
+        auto [it, firstVisit] = visited.try_emplace(path, true);
+        if (!firstVisit) {
+            succeeded = succeeded && it->second;
+            continue;
+        }
+
+        Module& module = modules.at(path);
+        if (module.unreadable) {
+            error(import->path, "Could not read module '" + path + "'.");
+            it->second = false;
+        }
+        else if (!module.program) {
+            ErrorState& state = errorState();
+            *state.stream << "In module '" << path << "':\n" << module.errors << std::flush;
+            state.hadError = true;
+            it->second = false;
+        }
+        else {
+            root.modules[path] = module.program;
+            it->second = collect(*module.program, root, visited);
+        }
+        succeeded = succeeded && it->second;
+    }
+
+    return succeeded;
+}
@@ -1,8 +1,205 @@
 #include "../include/NativeFunctions.hpp"
 
+#include <cerrno>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <new>
 
-// NativeClock
-std::any NativeClock::call(Interpreter& interpreter, const std::vector<std::any>& arguments) {
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "../include/Error.hpp"
+#include "../include/LoxCallable.hpp"
+#include "../include/LoxList.hpp"
+#include "../include/LoxListener.hpp"
+#include "../include/LoxMap.hpp"
+#include "../include/LoxNumberArray.hpp"
+#include "../include/LoxStream.hpp"
+#include "../include/LoxStringBuilder.hpp"
+#include "../include/LoxTask.hpp"
+#include "../include/Scheduler.hpp"
+
+namespace {
+/// @brief The longest sleep, about 30 years, which leaves the clock's nanosecond ticks ample headroom.
+constexpr double maxSleepMilliseconds = 1e12;
+
+/// @brief Checks whether the given value is of the given ValueType.
+bool matches(ValueType type, const std::any& value) {
+    switch (type) {
+        case ValueType::NUMBER:
+            return value.type() == typeid(double);
+        case ValueType::STRING:
+            return value.type() == typeid(std::string);
+        case ValueType::BOOL:
+            return value.type() == typeid(bool);
+        default:
+            return true;
+    }
+}
+
+/// @brief Returns the name of the given ValueType, with an article, for use in error messages.
+std::string typeName(ValueType type) {
+    switch (type) {
+        case ValueType::NUMBER:
+            return "a number";
+        case ValueType::STRING:
+            return "a string";
+        case ValueType::BOOL:
+            return "a boolean";
+        default:
+            return "a value";
+    }
+}
+}  // namespace
+
+void checkArguments(std::string_view name, const std::vector<ValueType>& signature, std::span<const std::any> arguments) {
+    for (size_t i = 0, len = signature.size(); i < len; ++i) {
+        if (!matches(signature[i], arguments[i])) {
+            throw NativeError("Argument " + std::to_string(i + 1) + " of '" + std::string(name) + "' must be " +
+                              typeName(signature[i]) + ".");
+        }
+    }
+}
+
+// NativeFunction
+std::any NativeFunction::call(Interpreter& interpreter, const std::vector<std::any>& arguments) {
+    checkArguments(name, signature, arguments);
+    return function(interpreter, arguments);
+}
+
+std::any nativeClock(Interpreter& interpreter, std::span<const std::any> arguments) {
     return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
+std::any nativeStr(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return interpreter.stringify(arguments[0]);
+}
+std::any nativeLen(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return static_cast<double>(std::any_cast<const std::string&>(arguments[0]).size());
+}
+std::any nativeSqrt(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return std::sqrt(std::any_cast<double>(arguments[0]));
+}
+std::any nativeFloor(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return std::floor(std::any_cast<double>(arguments[0]));
+}
+std::any nativeAbs(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return std::abs(std::any_cast<double>(arguments[0]));
+}
+std::any nativeStringBuilder(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return std::shared_ptr<NativeObject>(std::make_shared<LoxStringBuilder>());
+}
+std::any nativeList(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return std::shared_ptr<NativeObject>(std::make_shared<LoxList>());
+}
+std::any nativeMap(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return std::shared_ptr<NativeObject>(std::make_shared<LoxMap>());
+}
+std::any nativeNumberArray(Interpreter& interpreter, std::span<const std::any> arguments) {
+    double size = std::any_cast<double>(arguments[0]);
+    if (size < 0 || size != std::trunc(size)) {
+        throw NativeError("NumberArray size must be a non-negative integer.");
+    }
+    // Also rejects infinity, which no size_t can hold
+    if (!(size <= static_cast<double>(LoxNumberArray::maxSize))) {
+        throw NativeError("NumberArray size must be at most " + std::to_string(LoxNumberArray::maxSize) + ".");
+    }
+
+    try {
+        return std::shared_ptr<NativeObject>(std::make_shared<LoxNumberArray>(static_cast<size_t>(size)));
+    }
+    catch (const std::bad_alloc&) {
+        throw NativeError("Not enough memory for a NumberArray of size " + std::to_string(static_cast<size_t>(size)) + ".");
+    }
+}
+std::any nativeToNumberArray(Interpreter& interpreter, std::span<const std::any> arguments) {
+    auto list = nativeAnyCast<LoxList>(arguments[0]);
+    if (!list) {
+        throw NativeError("Argument 1 of 'toNumberArray' must be a List.");
+    }
+
+    std::vector<double> elements;
+    elements.reserve(list->elements.size());
+    for (const auto& element : list->elements) {
+        if (element.type() != typeid(double)) {
+            throw NativeError("List must only contain numbers.");
+        }
+        elements.push_back(std::any_cast<double>(element));
+    }
+    return std::shared_ptr<NativeObject>(std::make_shared<LoxNumberArray>(std::move(elements)));
+}
+std::any nativeSpawn(Interpreter& interpreter, std::span<const std::any> arguments) {
+    auto function = ptrAnyCast<LoxCallable>(arguments[0]);
+    if (!function) {
+        throw NativeError("Can only spawn functions and classes.");
+    }
+    if (function->arity() != 0) {
+        throw NativeError("Spawned function must take no arguments.");
+    }
+    return std::shared_ptr<NativeObject>(interpreter.getScheduler().spawn(function));
+}
+std::any nativeYield(Interpreter& interpreter, std::span<const std::any> arguments) {
+    interpreter.getScheduler().yield();
+    return nullptr;
+}
+std::any nativeAwait(Interpreter& interpreter, std::span<const std::any> arguments) {
+    auto task = nativeAnyCast<LoxTask>(arguments[0]);
+    if (!task) {
+        throw NativeError("Can only await tasks.");
+    }
+    return interpreter.getScheduler().await(*task);
+}
+std::any nativeSleep(Interpreter& interpreter, std::span<const std::any> arguments) {
+    // Converting to the clock's integer ticks is only defined for values the clock can represent
+    double milliseconds = std::any_cast<double>(arguments[0]);
+    if (std::isnan(milliseconds) || milliseconds > maxSleepMilliseconds) {
+        throw NativeError("Sleep time must be a number of milliseconds up to 1e12.");
+    }
+    interpreter.getScheduler().getEvents().sleep(milliseconds);
+    return nullptr;
+}
+
+#ifdef __linux__
+std::any nativeOpenFile(Interpreter& interpreter, std::span<const std::any> arguments) {
+    const auto& path = std::any_cast<const std::string&>(arguments[0]);
+    const auto& mode = std::any_cast<const std::string&>(arguments[1]);
+
+    int flags = O_NONBLOCK | O_CLOEXEC;
+    if (mode == "r") {
+        flags |= O_RDONLY;
+    }
+    else if (mode == "w") {
+        flags |= O_WRONLY | O_CREAT | O_TRUNC;
+    }
+    else if (mode == "a") {
+        flags |= O_WRONLY | O_CREAT | O_APPEND;
+    }
+    else {
+        throw NativeError("File mode must be \"r\", \"w\" or \"a\".");
+    }
+
+    int fd = open(path.c_str(), flags, 0666);
+    if (fd < 0) {
+        throw NativeError("Could not open '" + path + "': " + std::strerror(errno) + ".");
+    }
+    return std::shared_ptr<NativeObject>(std::make_shared<LoxStream>(fd));
+}
+std::any nativePipe(Interpreter& interpreter, std::span<const std::any> arguments) {
+    int fds[2];
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0) {
+        throw NativeError(std::string("Could not create pipe: ") + std::strerror(errno) + ".");
+    }
+
+    std::vector<std::any> ends{std::shared_ptr<NativeObject>(std::make_shared<LoxStream>(fds[0])),
+                               std::shared_ptr<NativeObject>(std::make_shared<LoxStream>(fds[1]))};
+    return std::shared_ptr<NativeObject>(std::make_shared<LoxList>(std::move(ends)));
+}
+std::any nativeListen(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return std::shared_ptr<NativeObject>(LoxListener::listen(arguments[0]));
+}
+std::any nativeConnect(Interpreter& interpreter, std::span<const std::any> arguments) {
+    return std::shared_ptr<NativeObject>(LoxStream::connect(interpreter, arguments[0]));
+}
+#endif
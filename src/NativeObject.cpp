@@ -0,0 +1,32 @@
+#include "../include/NativeObject.hpp"
+
+#include <cmath>
+
+#include "../include/Error.hpp"
+
+size_t toIndex(const std::any& value, size_t size) {
+    double index = std::any_cast<double>(value);
+    if (index != std::trunc(index)) {
+        throw NativeError("Index must be an integer.");
+    }
+    if (index < 0 || index >= size) {
+        throw NativeError("Index out of range.");
+    }
+    return static_cast<size_t>(index);
+}
+
+std::any NativeObject::get(const Token& name) {
+    const NativeMethodTable& table = methods();
+
+    auto it = table.find(name.lexeme);
+    if (it != table.end()) {
+        return std::shared_ptr<LoxCallable>(std::make_shared<NativeMethod>(it->first, it->second, shared_from_this()));
+    }
+
+    throw RuntimeError(name, "Undefined property '" + name.lexeme + "'.");
+}
+
+std::any NativeMethod::call(Interpreter& interpreter, const std::vector<std::any>& arguments) {
+    checkArguments(name, info.signature, arguments);
+    return info.function(interpreter, *receiver, arguments);
+}
@@ -0,0 +1,181 @@
+#include "../include/NumericKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#if defined(__AVX2__)
+#define CPPLOX_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPPLOX_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+// min and max propagate NaN, like the other reductions, whichever operand it is. The SIMD instructions return their
+// second operand when either is NaN, so a NaN in the first is put back explicitly.
+inline double scalarMin(double a, double b) { return std::isnan(b) || b < a ? b : a; }
+inline double scalarMax(double a, double b) { return std::isnan(b) || b > a ? b : a; }
+
+// Thin wrappers over one SIMD register of doubles, so each kernel is written once for every instruction set
+#if defined(CPPLOX_SIMD_AVX2)
+using Vec = __m256d;
+constexpr size_t lanes = 4;
+inline Vec load(const double* p) { return _mm256_loadu_pd(p); }
+inline void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+inline Vec broadcast(double d) { return _mm256_set1_pd(d); }
+inline Vec vadd(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+inline Vec vsub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+inline Vec vmul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+inline Vec vdiv(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+inline Vec keepNan(Vec a, Vec result) { return _mm256_blendv_pd(result, a, _mm256_cmp_pd(a, a, _CMP_UNORD_Q)); }
+inline Vec vmin(Vec a, Vec b) { return keepNan(a, _mm256_min_pd(a, b)); }
+inline Vec vmax(Vec a, Vec b) { return keepNan(a, _mm256_max_pd(a, b)); }
+#elif defined(CPPLOX_SIMD_SSE2)
+using Vec = __m128d;
+constexpr size_t lanes = 2;
+inline Vec load(const double* p) { return _mm_loadu_pd(p); }
+inline void store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+inline Vec broadcast(double d) { return _mm_set1_pd(d); }
+inline Vec vadd(Vec a, Vec b) { return _mm_add_pd(a, b); }
+inline Vec vsub(Vec a, Vec b) { return _mm_sub_pd(a, b); }
+inline Vec vmul(Vec a, Vec b) { return _mm_mul_pd(a, b); }
+inline Vec vdiv(Vec a, Vec b) { return _mm_div_pd(a, b); }
+inline Vec keepNan(Vec a, Vec result) {
+    Vec nan = _mm_cmpunord_pd(a, a);
+    return _mm_or_pd(_mm_and_pd(nan, a), _mm_andnot_pd(nan, result));
+}
+inline Vec vmin(Vec a, Vec b) { return keepNan(a, _mm_min_pd(a, b)); }
+inline Vec vmax(Vec a, Vec b) { return keepNan(a, _mm_max_pd(a, b)); }
+#else
+using Vec = double;
+constexpr size_t lanes = 1;
+inline Vec load(const double* p) { return *p; }
+inline void store(double* p, Vec v) { *p = v; }
+inline Vec broadcast(double d) { return d; }
+inline Vec vadd(Vec a, Vec b) { return a + b; }
+inline Vec vsub(Vec a, Vec b) { return a - b; }
+inline Vec vmul(Vec a, Vec b) { return a * b; }
+inline Vec vdiv(Vec a, Vec b) { return a / b; }
+inline Vec vmin(Vec a, Vec b) { return scalarMin(a, b); }
+inline Vec vmax(Vec a, Vec b) { return scalarMax(a, b); }
+#endif
+
+/// @brief Folds the lanes of a register into one double with the given binary operation.
+template <typename Op>
+double horizontal(Vec v, Op op) {
+    double parts[lanes];
+    store(parts, v);
+    double result = parts[0];
+    for (size_t i = 1; i < lanes; ++i) {
+        result = op(result, parts[i]);
+    }
+    return result;
+}
+
+/// @brief out[i] = op(in[i], operand), vectorized.
+template <typename VecOp, typename ScalarOp>
+void mapLanes(std::span<const double> in, double operand, std::span<double> out, VecOp vecOp, ScalarOp scalarOp) {
+    size_t n = in.size();
+    size_t i = 0;
+    Vec factor = broadcast(operand);
+    for (; i + lanes <= n; i += lanes) {
+        store(&out[i], vecOp(load(&in[i]), factor));
+    }
+    for (; i < n; ++i) {
+        out[i] = scalarOp(in[i], operand);
+    }
+}
+
+/// @brief Reduces a non-empty span with the given operation, vectorized.
+template <typename VecOp, typename ScalarOp>
+double reduceLanes(std::span<const double> in, VecOp vecOp, ScalarOp scalarOp) {
+    size_t n = in.size();
+    if (n < lanes) {
+        return std::accumulate(in.begin() + 1, in.end(), in[0], scalarOp);
+    }
+
+    Vec acc = load(&in[0]);
+    size_t i = lanes;
+    for (; i + lanes <= n; i += lanes) {
+        acc = vecOp(acc, load(&in[i]));
+    }
+    double result = horizontal(acc, scalarOp);
+    for (; i < n; ++i) {
+        result = scalarOp(result, in[i]);
+    }
+    return result;
+}
+}  // namespace
+
+double kernelSum(std::span<const double> in) {
+    if (in.empty()) {
+        return 0;
+    }
+    return reduceLanes(in, vadd, [](double a, double b) { return a + b; });
+}
+
+double kernelDot(std::span<const double> left, std::span<const double> right) {
+    size_t n = left.size();
+    size_t i = 0;
+    Vec acc = broadcast(0);
+    for (; i + lanes <= n; i += lanes) {
+        acc = vadd(acc, vmul(load(&left[i]), load(&right[i])));
+    }
+    double result = horizontal(acc, [](double a, double b) { return a + b; });
+    for (; i < n; ++i) {
+        result += left[i] * right[i];
+    }
+    return result;
+}
+
+double kernelMin(std::span<const double> in) {
+    return reduceLanes(in, vmin, scalarMin);
+}
+
+double kernelMax(std::span<const double> in) {
+    return reduceLanes(in, vmax, scalarMax);
+}
+
+void kernelScale(std::span<const double> in, double factor, std::span<double> out) {
+    mapLanes(in, factor, out, vmul, [](double a, double b) { return a * b; });
+}
+
+void kernelAdd(std::span<const double> left, std::span<const double> right, std::span<double> out) {
+    size_t n = left.size();
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        store(&out[i], vadd(load(&left[i]), load(&right[i])));
+    }
+    for (; i < n; ++i) {
+        out[i] = left[i] + right[i];
+    }
+}
+
+void kernelAddScalar(std::span<const double> in, double operand, std::span<double> out) {
+    mapLanes(in, operand, out, vadd, [](double a, double b) { return a + b; });
+}
+
+void kernelSubScalar(std::span<const double> in, double operand, std::span<double> out) {
+    mapLanes(in, operand, out, vsub, [](double a, double b) { return a - b; });
+}
+
+void kernelDivScalar(std::span<const double> in, double operand, std::span<double> out) {
+    mapLanes(in, operand, out, vdiv, [](double a, double b) { return a / b; });
+}
+
+void kernelPrefixSum(std::span<const double> in, std::span<double> out) {
+    // Each element depends on the previous one, so this stays scalar
+    double running = 0;
+    for (size_t i = 0, n = in.size(); i < n; ++i) {
+        running += in[i];
+        out[i] = running;
+    }
+}
+
+void kernelSort(std::span<double> data) {
+    // NaN compares false with everything, which std::sort's ordering can't allow, so set NaNs aside first
+    auto numbers = std::partition(data.begin(), data.end(), [](double d) { return !std::isnan(d); });
+    std::sort(data.begin(), numbers);
+}
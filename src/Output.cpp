@@ -0,0 +1,115 @@
+#include "../include/Output.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr int stdoutFd = 1;
+
+/// @brief Writes up to the given number of bytes to a file descriptor. Returns the number written, or -1 on error.
+long long writeFd(int fd, const char* data, size_t len) {
+#ifdef _WIN32
+    return _write(fd, data, static_cast<unsigned int>(std::min<size_t>(len, 1 << 30)));
+#else
+    return ::write(fd, data, len);
+#endif
+}
+
+/// @brief Checks whether the given file descriptor refers to a terminal.
+bool isTerminal(int fd) {
+#ifdef _WIN32
+    return _isatty(fd);
+#else
+    return isatty(fd);
+#endif
+}
+}  // namespace
+
+Output::Output() : Output(stdoutFd, isTerminal(stdoutFd) ? FlushMode::LINE : FlushMode::BLOCK) {}
+
+Output::Output(int f, FlushMode m) : fd(f), mode(m) {
+    buffer.reserve(bufferSize);
+}
+
+Output::~Output() {
+    flush();
+}
+
+void Output::write(std::string_view text) {
+    if (mode != FlushMode::EXIT && buffer.size() + text.size() > bufferSize) {
+        flush();
+
+        // Text that wouldn't fit in an empty buffer bypasses it
+        if (text.size() > bufferSize) {
+            writeAll(text.data(), text.size());
+            return;
+        }
+    }
+
+    buffer.append(text);
+
+    if (mode == FlushMode::LINE && text.find('\n') != std::string_view::npos) {
+        flush();
+    }
+}
+
+void Output::flush() {
+    if (!buffer.empty()) {
+        writeAll(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+void Output::setMode(FlushMode m) {
+    flush();
+    mode = m;
+}
+
+void Output::setFd(int f) {
+    flush();
+    fd = f;
+}
+
+void Output::setCapture(std::string* c) {
+    flush();
+    capture = c;
+}
+
+std::optional<Output::FlushMode> Output::parseMode(std::string_view name) {
+    if (name == "line") {
+        return FlushMode::LINE;
+    }
+    else if (name == "block") {
+        return FlushMode::BLOCK;
+    }
+    else if (name == "exit") {
+        return FlushMode::EXIT;
+    }
+    return std::nullopt;
+}
+
+void Output::writeAll(const char* data, size_t len) {
+    if (capture) {
+        capture->append(data, len);
+        return;
+    }
+
+    while (len > 0) {
+        long long written = writeFd(fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // Nowhere left to report to, so drop the output
+            return;
+        }
+        data += written;
+        len -= written;
+    }
+}
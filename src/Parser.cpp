@@ -1,6 +1,8 @@
 #include "../include/Parser.hpp"
 
+#include <array>
 #include <iostream>
+#include <utility>
 
 constexpr size_t maxArguments = 255;
 
@@ -24,6 +26,9 @@ std::shared_ptr<Stmt> Parser::declaration() {
         else if (match(TokenType::CLASS)) {
             return classDeclaration();
         }
+        else if (match(TokenType::IMPORT)) {
+            return importDeclaration();
+        }
         return statement();
     }
     catch (ParseError& error) {
@@ -90,7 +95,7 @@ std::shared_ptr<While> Parser::whileStatement() {
     return std::make_shared<While>(condition, body);
 }
 
-std::shared_ptr<Stmt> Parser::forStatement() {
+std::shared_ptr<For> Parser::forStatement() {
     consume(TokenType::LEFT_PAREN, "Expect '(' after 'for'.");
 
     // Initializer
@@ -125,24 +130,7 @@ std::shared_ptr<Stmt> Parser::forStatement() {
     // Body
     std::shared_ptr<Stmt> body = statement();
 
-    // Add increment to end of body if one is given
-    if (increment != nullptr) {
-        body = std::make_shared<Block>(std::vector<std::shared_ptr<Stmt>>{body, std::make_shared<Expression>(increment)});
-    }
-
-    // Substitute true for condition if one isn't given
-    if (condition == nullptr) {
-        condition = std::make_shared<Literal>(true);
-    }
-
-    body = std::make_shared<While>(condition, body);
-
-    // Add initializer before everything if one is given
-    if (initializer != nullptr) {
-        body = std::make_shared<Block>(std::vector<std::shared_ptr<Stmt>>{initializer, body});
-    }
-
-    return body;
+    return std::make_shared<For>(initializer, condition, increment, body);
 }
 
 std::shared_ptr<Stmt> Parser::returnStatement() {
@@ -222,130 +210,160 @@ std::shared_ptr<Class> Parser::classDeclaration() {
 
     return std::make_shared<Class>(name, superclass, methods);
 }
+std::shared_ptr<Import> Parser::importDeclaration() {
+    Token keyword = previous();
+    Token path = consume(TokenType::STRING, "Expect module path after 'import'.");
+    consume(TokenType::SEMICOLON, "Expect ';' after module path.");
 
-std::shared_ptr<Expr> Parser::expression() {
-    return assignment();
-}
-std::shared_ptr<Expr> Parser::assignment() {
-    auto expr = logicalOr();
-
-    if (match(TokenType::EQUAL)) {
-        Token equals = previous();
-        std::shared_ptr<Expr> value = assignment();
-
-        std::shared_ptr<Variable> var = std::dynamic_pointer_cast<Variable>(expr);
-        if (var) {
-            return std::make_shared<Assign>(var->name, value);
-        }
-        else if (auto get = std::dynamic_pointer_cast<Get>(expr)) {
-            return std::make_shared<Set>(get->object, get->name, value);
-        }
-
-        error(equals, "Invalid assignment target.");
-    }
-
-    return expr;
-}
-std::shared_ptr<Expr> Parser::logicalOr() {
-    return binaryExpression<Logical>(&Parser::logicalAnd, TokenType::OR);
-}
-std::shared_ptr<Expr> Parser::logicalAnd() {
-    return binaryExpression<Logical>(&Parser::equality, TokenType::AND);
+    return std::make_shared<Import>(keyword, path);
 }
 
-std::shared_ptr<Expr> Parser::equality() {
-    return binaryExpression(&Parser::comparison, TokenType::BANG_EQUAL, TokenType::EQUAL_EQUAL);
-}
-std::shared_ptr<Expr> Parser::comparison() {
-    return binaryExpression(&Parser::term, TokenType::LESS, TokenType::LESS_EQUAL, TokenType::GREATER, TokenType::GREATER_EQUAL);
-}
-std::shared_ptr<Expr> Parser::term() {
-    return binaryExpression(&Parser::factor, TokenType::PLUS, TokenType::MINUS);
-}
-std::shared_ptr<Expr> Parser::factor() {
-    return binaryExpression(&Parser::unary, TokenType::SLASH, TokenType::STAR);
-}
-std::shared_ptr<Expr> Parser::unary() {
+std::shared_ptr<Expr> Parser::expression() {
+    return parsePrecedence(Precedence::ASSIGNMENT);
+}
+
+namespace {
+/// @brief What an operator builds from the expression on its left.
+enum class Infix { NONE, ASSIGN, LOGICAL, BINARY, CALL, GET };
+
+struct InfixRule {
+    Precedence precedence = Precedence::NONE;
+    Infix infix = Infix::NONE;
+};
+
+// Indexed by TokenType. Tokens without a rule end the expression, since NONE binds looser than anything parsed.
+constexpr auto infixRules = [] {
+    std::array<InfixRule, static_cast<size_t>(TokenType::LOX_EOF) + 1> rules{};
+    auto rule = [&rules](TokenType type, Precedence precedence, Infix infix) {
+        rules[static_cast<size_t>(type)] = InfixRule{precedence, infix};
+    };
+
+    rule(TokenType::EQUAL, Precedence::ASSIGNMENT, Infix::ASSIGN);
+    rule(TokenType::OR, Precedence::OR, Infix::LOGICAL);
+    rule(TokenType::AND, Precedence::AND, Infix::LOGICAL);
+    rule(TokenType::BANG_EQUAL, Precedence::EQUALITY, Infix::BINARY);
+    rule(TokenType::EQUAL_EQUAL, Precedence::EQUALITY, Infix::BINARY);
+    rule(TokenType::LESS, Precedence::COMPARISON, Infix::BINARY);
+    rule(TokenType::LESS_EQUAL, Precedence::COMPARISON, Infix::BINARY);
+    rule(TokenType::GREATER, Precedence::COMPARISON, Infix::BINARY);
+    rule(TokenType::GREATER_EQUAL, Precedence::COMPARISON, Infix::BINARY);
+    rule(TokenType::PLUS, Precedence::TERM, Infix::BINARY);
+    rule(TokenType::MINUS, Precedence::TERM, Infix::BINARY);
+    rule(TokenType::SLASH, Precedence::FACTOR, Infix::BINARY);
+    rule(TokenType::STAR, Precedence::FACTOR, Infix::BINARY);
+    rule(TokenType::LEFT_PAREN, Precedence::CALL, Infix::CALL);
+    rule(TokenType::DOT, Precedence::CALL, Infix::GET);
+    return rules;
+}();
+
+/// @brief Returns the precedence binding one step tighter than the given one.
+constexpr Precedence tighter(Precedence precedence) {
+    return static_cast<Precedence>(static_cast<int>(precedence) + 1);
+}
+}  // namespace
+
+std::shared_ptr<Expr> Parser::parsePrecedence(Precedence precedence) {
+    std::shared_ptr<Expr> expr;
     if (match(TokenType::BANG, TokenType::MINUS)) {
         Token op = previous();
-        auto rhs = unary();
-        return std::make_shared<Unary>(op, rhs);
+        auto rhs = parsePrecedence(Precedence::UNARY);
+        expr = std::make_shared<Unary>(op, rhs);
+    }
+    else {
+        expr = primary();
     }
-
-    return call();
-}
-std::shared_ptr<Expr> Parser::call() {
-    auto expr = primary();
 
     while (true) {
-        if (match(TokenType::LEFT_PAREN)) {
-            expr = finishCall(expr);
-        }
-        else if (match(TokenType::DOT)) {
-            Token name = consume(TokenType::IDENTIFIER, "Expect property name after '.'.");
-            expr = std::make_shared<Get>(expr, name);
-        }
-        else {
+        const InfixRule& rule = infixRules[static_cast<size_t>(peek().type)];
+        if (rule.precedence < precedence) {
             break;
         }
+        Token op = advance();
+
+        switch (rule.infix) {
+            case Infix::ASSIGN: {
+                // Right-associative, so the value may itself be an assignment
+                std::shared_ptr<Expr> value = parsePrecedence(Precedence::ASSIGNMENT);
+
+                if (auto var = std::dynamic_pointer_cast<Variable>(expr)) {
+                    expr = std::make_shared<Assign>(var->name, value);
+                }
+                else if (auto get = std::dynamic_pointer_cast<Get>(expr)) {
+                    expr = std::make_shared<Set>(get->object, get->name, value);
+                }
+                else {
+                    error(op, "Invalid assignment target.");
+                }
+                break;
+            }
+            case Infix::LOGICAL: {
+                auto rhs = parsePrecedence(tighter(rule.precedence));
+                expr = std::make_shared<Logical>(expr, op, rhs);
+                break;
+            }
+            case Infix::BINARY: {
+                auto rhs = parsePrecedence(tighter(rule.precedence));
+                expr = std::make_shared<Binary>(expr, op, rhs);
+                break;
+            }
+            case Infix::CALL:
+                expr = finishCall(expr);
+                break;
+            case Infix::GET: {
+                Token name = consume(TokenType::IDENTIFIER, "Expect property name after '.'.");
+                expr = std::make_shared<Get>(expr, name);
+                break;
+            }
+            case Infix::NONE:
+                std::unreachable();
+        }
     }
 
     return expr;
 }
-std::shared_ptr<Expr> Parser::primary() {
-    // Booleans and null
-    if (match(TokenType::FALSE)) {
-        return std::make_shared<Literal>(false);
-    }
-    if (match(TokenType::TRUE)) {
-        return std::make_shared<Literal>(true);
-    }
-    if (match(TokenType::NIL)) {
-        return std::make_shared<Literal>(nullptr);
-    }
-
-    // Number or string literal
-    if (match(TokenType::NUMBER, TokenType::STRING)) {
-        return std::make_shared<Literal>(previous().literal);
-    }
 
-    if (match(TokenType::THIS)) {
-        return std::make_shared<This>(previous());
-    }
-
-    if (match(TokenType::IDENTIFIER)) {
-        return std::make_shared<Variable>(previous());
-    }
-    
-    if (match(TokenType::SUPER)) {
-        Token keyword = previous();
-        consume(TokenType::DOT, "Expect '.' after 'super'.");
-        Token method = consume(TokenType::IDENTIFIER, "Expect superclass method name.");
-        return std::make_shared<Super>(keyword, method);
-    }
-    
-
-    // Parenthesized expression
-    if (match(TokenType::LEFT_PAREN)) {
-        std::shared_ptr<Expr> expr = expression();
-        consume(TokenType::RIGHT_PAREN, "Expect ')' after expression.");
-        return std::make_shared<Grouping>(expr);
-    }
-
-    throw error(peek(), "Expect expression.");
-}
+std::shared_ptr<Expr> Parser::primary() {
+    switch (peek().type) {
+        // Booleans and null
+        case TokenType::FALSE:
+            advance();
+            return std::make_shared<Literal>(false);
+        case TokenType::TRUE:
+            advance();
+            return std::make_shared<Literal>(true);
+        case TokenType::NIL:
+            advance();
+            return std::make_shared<Literal>(nullptr);
+
+        // Number or string literal
+        case TokenType::NUMBER:
+        case TokenType::STRING:
+            return std::make_shared<Literal>(advance().literal);
+
+        case TokenType::THIS:
+            return std::make_shared<This>(advance());
+
+        case TokenType::IDENTIFIER:
+            return std::make_shared<Variable>(advance());
+
+        case TokenType::SUPER: {
+            Token keyword = advance();
+            consume(TokenType::DOT, "Expect '.' after 'super'.");
+            Token method = consume(TokenType::IDENTIFIER, "Expect superclass method name.");
+            return std::make_shared<Super>(keyword, method);
+        }
 
-template <typename exprClass, typename... Args>
-std::shared_ptr<Expr> Parser::binaryExpression(std::shared_ptr<Expr> (Parser::*func)(), const Args... args) {
-    std::shared_ptr<Expr> expr = (this->*func)();
+        // Parenthesized expression
+        case TokenType::LEFT_PAREN: {
+            advance();
+            std::shared_ptr<Expr> expr = expression();
+            consume(TokenType::RIGHT_PAREN, "Expect ')' after expression.");
+            return std::make_shared<Grouping>(expr);
+        }
 
-    while (match(args...)) {
-        Token op = previous();
-        auto rhs = (this->*func)();
-        expr = std::make_shared<exprClass>(expr, op, rhs);
+        default:
+            throw error(peek(), "Expect expression.");
     }
-
-    return expr;
 }
 
 std::shared_ptr<Expr> Parser::finishCall(std::shared_ptr<Expr> callee) {
@@ -366,7 +384,7 @@ std::shared_ptr<Expr> Parser::finishCall(std::shared_ptr<Expr> callee) {
     return std::make_shared<Call>(callee, paren, arguments);
 }
 
-Token Parser::consume(TokenType type, std::string_view msg) {
+const Token& Parser::consume(TokenType type, std::string_view msg) {
     if (check(type)) {
         return advance();
     }
@@ -376,6 +394,7 @@ Token Parser::consume(TokenType type, std::string_view msg) {
 
 ParseError Parser::error(const Token& token, std::string_view msg) {
     ::error(token, msg);
+    incomplete = incomplete || token.type == TokenType::LOX_EOF;
     return ParseError("");
 }
 
@@ -419,18 +438,18 @@ bool Parser::check(TokenType type) {
     return peek().type == type;
 }
 
-Token Parser::advance() {
+const Token& Parser::advance() {
     if (!isAtEnd()) {
         ++current;
     }
     return previous();
 }
 
-inline Token Parser::peek() {
+inline const Token& Parser::peek() {
     return tokens[current];
 }
 
-inline Token Parser::previous() {
+inline const Token& Parser::previous() {
     return tokens[current - 1];
 }
 
@@ -0,0 +1,208 @@
+#include "../include/Pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+constexpr size_t sizeClasses = SlabPool::maxBlockSize / SlabPool::granularity;
+
+/// @brief A free block, linked to the next free block of the same size class.
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+/// @brief A singly linked list of free blocks of one size class, with its length.
+struct FreeList {
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+
+    void push(FreeBlock* block) {
+        block->next = head;
+        head = block;
+        ++count;
+    }
+
+    FreeBlock* pop() {
+        FreeBlock* block = head;
+        head = block->next;
+        --count;
+        return block;
+    }
+
+    /// @brief Moves up to the given number of blocks from the front of this list to the front of the other.
+    void moveTo(FreeList& other, size_t n) {
+        for (size_t i = 0; i < n && head != nullptr; ++i) {
+            other.push(pop());
+        }
+    }
+};
+
+/// @brief Free blocks handed back by threads with more than they need, or that exited, for any thread to reuse.
+struct Depot {
+    std::mutex mutex;
+    FreeList lists[sizeClasses];
+    // Length of each list at which its wholly free slabs are next released
+    size_t scavengeAt[sizeClasses] = {};
+};
+
+/// @brief One thread's free lists and statistics.
+struct SlabCache {
+    FreeList lists[sizeClasses];
+    SlabPool::Stats stats;
+    // Set once the thread has handed its free lists to the depot on exit; later frees go to the depot directly
+    bool released = false;
+};
+
+/// @brief Hands the thread's free lists to the depot when the thread exits. Kept apart from SlabCache so that the
+/// cache stays trivially destructible, which spares every allocation thread_local's initialization check.
+struct SlabCacheReleaser {
+    ~SlabCacheReleaser();
+};
+
+std::atomic<size_t> liveSlabCount{0};
+
+thread_local SlabCache cache;
+thread_local SlabCacheReleaser releaser;
+
+/// @brief Returns the process-wide depot. Never destroyed, so threads outliving static destruction can still use it.
+Depot& depot() {
+    static Depot* instance = new Depot;
+    return *instance;
+}
+
+/// @brief Returns the index of the size class that holds blocks of the given size.
+inline size_t sizeClass(size_t size) {
+    return (size - 1) / SlabPool::granularity;
+}
+
+/// @brief Returns how many blocks of the given size class one slab holds.
+inline size_t blocksPerSlab(size_t index) {
+    return SlabPool::slabSize / ((index + 1) * SlabPool::granularity);
+}
+
+/// @brief Returns the slab the given block was carved from. Slabs are aligned to their size.
+inline uintptr_t slabOf(const FreeBlock* block) {
+    return reinterpret_cast<uintptr_t>(block) & ~(uintptr_t(SlabPool::slabSize) - 1);
+}
+
+/// @brief Unlinks every slab of the given size class whose blocks are all in the depot and returns it to the
+/// system. The depot's mutex must be held.
+void scavenge(Depot& shared, size_t index) {
+    FreeList& list = shared.lists[index];
+    size_t perSlab = blocksPerSlab(index);
+
+    std::unordered_map<uintptr_t, size_t> freeBlocks;
+    for (FreeBlock* block = list.head; block != nullptr; block = block->next) {
+        ++freeBlocks[slabOf(block)];
+    }
+
+    for (FreeBlock** link = &list.head; *link != nullptr;) {
+        if (freeBlocks[slabOf(*link)] == perSlab) {
+            *link = (*link)->next;
+            --list.count;
+        }
+        else {
+            link = &(*link)->next;
+        }
+    }
+    for (const auto& [slab, count] : freeBlocks) {
+        if (count == perSlab) {
+            ::operator delete(reinterpret_cast<void*>(slab), std::align_val_t(SlabPool::slabSize));
+            liveSlabCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Doubling the threshold keeps the walks amortized constant time per freed block
+    shared.scavengeAt[index] = std::max(4 * perSlab, 2 * list.count);
+}
+
+/// @brief Moves up to the given number of blocks from the given list to the depot, releasing empty slabs if the
+/// depot has accumulated enough free blocks.
+void giveToDepot(size_t index, FreeList& list, size_t n) {
+    Depot& shared = depot();
+    std::lock_guard lock(shared.mutex);
+    list.moveTo(shared.lists[index], n);
+    if (shared.lists[index].count >= std::max(shared.scavengeAt[index], 4 * blocksPerSlab(index))) {
+        scavenge(shared, index);
+    }
+}
+
+SlabCacheReleaser::~SlabCacheReleaser() {
+    for (size_t index = 0; index < sizeClasses; ++index) {
+        if (cache.lists[index].count > 0) {
+            giveToDepot(index, cache.lists[index], cache.lists[index].count);
+        }
+    }
+    cache.released = true;
+}
+
+/// @brief Fills the given size class's free list with a slab's worth of blocks, from the depot if it has any and
+/// from a new slab otherwise.
+void refill(size_t index) {
+    // Only a thread that has taken blocks can have any to hand back, so the releaser is constructed here
+    static_cast<void>(&releaser);
+
+    size_t perSlab = blocksPerSlab(index);
+    {
+        Depot& shared = depot();
+        std::lock_guard lock(shared.mutex);
+        shared.lists[index].moveTo(cache.lists[index], perSlab);
+    }
+    if (cache.lists[index].count > 0) {
+        return;
+    }
+
+    size_t blockSize = (index + 1) * SlabPool::granularity;
+    char* slab = static_cast<char*>(::operator new(SlabPool::slabSize, std::align_val_t(SlabPool::slabSize)));
+    for (size_t i = perSlab; i-- > 0;) {
+        cache.lists[index].push(reinterpret_cast<FreeBlock*>(slab + i * blockSize));
+    }
+    liveSlabCount.fetch_add(1, std::memory_order_relaxed);
+    ++cache.stats.slabs;
+}
+}  // namespace
+
+void* SlabPool::allocate(size_t size) {
+    size_t index = sizeClass(size);
+    if (cache.lists[index].head == nullptr) {
+        if (cache.released) {
+            // Sized to the class, as the block may later be reused from the depot for any size in it
+            return ::operator new((index + 1) * granularity);
+        }
+        refill(index);
+    }
+
+    ++cache.stats.allocations;
+    return cache.lists[index].pop();
+}
+
+void SlabPool::deallocate(void* p, size_t size) {
+    size_t index = sizeClass(size);
+    auto block = static_cast<FreeBlock*>(p);
+    if (cache.released) {
+        FreeList list;
+        list.push(block);
+        giveToDepot(index, list, 1);
+        return;
+    }
+
+    FreeList& list = cache.lists[index];
+    list.push(block);
+    ++cache.stats.deallocations;
+
+    // Blocks freed here but allocated elsewhere, e.g. by a producer thread, flow back through the depot
+    if (list.count > 2 * blocksPerSlab(index)) {
+        giveToDepot(index, list, blocksPerSlab(index));
+    }
+}
+
+SlabPool::Stats SlabPool::stats() {
+    return cache.stats;
+}
+
+size_t SlabPool::liveSlabs() {
+    return liveSlabCount.load(std::memory_order_relaxed);
+}
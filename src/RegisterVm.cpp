@@ -0,0 +1,318 @@
+#include "../include/RegisterVm.hpp"
+
+#include <algorithm>
+#include <map>
+
+#include "../include/CompiledRuntime.hpp"
+
+namespace {
+/// @brief Returns the number held by a value that is proven to hold one.
+inline double number(const std::any& value) {
+    return *std::any_cast<double>(&value);
+}
+}  // namespace
+
+RegisterVm::RegisterVm(const IrFunction& function) {
+    // Registers: one per value, then one shadow register per phi
+    std::map<const IrInstruction*, uint32_t> shadows;
+    uint32_t next = static_cast<uint32_t>(function.valueCount);
+    for (const auto& block : function.blocks) {
+        for (const auto& instruction : block->instructions) {
+            if (instruction->op == IrOp::PHI) {
+                shadows[instruction.get()] = next++;
+            }
+        }
+    }
+    registerCount = next;
+
+    std::map<const IrBlock*, uint32_t> starts;
+    std::vector<std::pair<size_t, std::vector<const IrBlock*>>> jumps;
+
+    for (const auto& block : function.blocks) {
+        starts[block.get()] = static_cast<uint32_t>(code.size());
+
+        for (const auto& instruction : block->instructions) {
+            if (instruction->op == IrOp::PHI) {
+                code.push_back({Op::MOVE, static_cast<uint32_t>(instruction->id), shadows.at(instruction.get())});
+            }
+        }
+
+        for (const auto& instruction : block->instructions) {
+            const IrInstruction& ir = *instruction;
+            Instruction out{Op::MOVE, static_cast<uint32_t>(ir.id)};
+            out.token = ir.token;
+            if (!ir.operands.empty()) {
+                out.a = static_cast<uint32_t>(ir.operands[0]->id);
+            }
+            if (ir.operands.size() > 1) {
+                out.b = static_cast<uint32_t>(ir.operands[1]->id);
+            }
+
+            // Feed the phis of the successors before leaving the block
+            if (ir.op == IrOp::JUMP || ir.op == IrOp::BRANCH) {
+                for (IrBlock* successor : ir.targets) {
+                    auto position = std::find(successor->predecessors.begin(), successor->predecessors.end(), block.get());
+                    size_t edge = position - successor->predecessors.begin();
+                    for (const auto& phi : successor->instructions) {
+                        if (phi->op == IrOp::PHI) {
+                            code.push_back({Op::MOVE, shadows.at(phi.get()), static_cast<uint32_t>(phi->operands[edge]->id)});
+                        }
+                    }
+                }
+            }
+
+            switch (ir.op) {
+                case IrOp::PHI:
+                    continue;
+                case IrOp::COPY:
+                    out.op = Op::MOVE;
+                    break;
+                case IrOp::CONST:
+                    out.op = Op::CONST;
+                    out.index = static_cast<uint32_t>(constants.size());
+                    constants.push_back(ir.constant);
+                    break;
+                case IrOp::PARAM:
+                    out.op = Op::PARAM;
+                    out.index = static_cast<uint32_t>(ir.index);
+                    break;
+                case IrOp::LOAD_GLOBAL:
+                    out.op = Op::LOAD_GLOBAL;
+                    break;
+                case IrOp::STORE_GLOBAL:
+                    out.op = Op::STORE_GLOBAL;
+                    break;
+                case IrOp::LOAD_ENV:
+                    out.op = Op::LOAD_ENV;
+                    out.index = static_cast<uint32_t>(ir.index);
+                    break;
+                case IrOp::STORE_ENV:
+                    out.op = Op::STORE_ENV;
+                    out.index = static_cast<uint32_t>(ir.index);
+                    break;
+                case IrOp::CHECK_NUMBER:
+                    out.op = Op::CHECK_NUMBER;
+                    break;
+                case IrOp::ADD:
+                    out.op = ir.numeric ? Op::ADD_NUMBER : Op::ADD;
+                    break;
+                case IrOp::SUBTRACT:
+                    out.op = Op::SUBTRACT;
+                    break;
+                case IrOp::MULTIPLY:
+                    out.op = Op::MULTIPLY;
+                    break;
+                case IrOp::DIVIDE:
+                    out.op = Op::DIVIDE;
+                    break;
+                case IrOp::NEGATE:
+                    out.op = Op::NEGATE;
+                    break;
+                case IrOp::NOT:
+                    out.op = Op::NOT;
+                    break;
+                case IrOp::EQUAL:
+                    out.op = Op::EQUAL;
+                    break;
+                case IrOp::NOT_EQUAL:
+                    out.op = Op::NOT_EQUAL;
+                    break;
+                case IrOp::GREATER:
+                    out.op = ir.numeric ? Op::GREATER_NUMBER : Op::GREATER;
+                    break;
+                case IrOp::GREATER_EQUAL:
+                    out.op = ir.numeric ? Op::GREATER_EQUAL_NUMBER : Op::GREATER_EQUAL;
+                    break;
+                case IrOp::LESS:
+                    out.op = ir.numeric ? Op::LESS_NUMBER : Op::LESS;
+                    break;
+                case IrOp::LESS_EQUAL:
+                    out.op = ir.numeric ? Op::LESS_EQUAL_NUMBER : Op::LESS_EQUAL;
+                    break;
+                case IrOp::CALL:
+                    out.op = Op::CALL;
+                    out.index = static_cast<uint32_t>(arguments.size());
+                    out.b = static_cast<uint32_t>(ir.operands.size() - 1);
+                    for (size_t i = 1; i < ir.operands.size(); ++i) {
+                        arguments.push_back(static_cast<uint32_t>(ir.operands[i]->id));
+                    }
+                    break;
+                case IrOp::GET:
+                    out.op = Op::GET;
+                    break;
+                case IrOp::FIELD_TARGET:
+                    out.op = Op::FIELD_TARGET;
+                    break;
+                case IrOp::SET:
+                    out.op = Op::SET;
+                    break;
+                case IrOp::SUPER:
+                    out.op = Op::SUPER;
+                    break;
+                case IrOp::PRINT:
+                    out.op = Op::PRINT;
+                    break;
+                case IrOp::JUMP:
+                    out.op = Op::JUMP;
+                    jumps.emplace_back(code.size(), std::vector<const IrBlock*>{ir.targets[0]});
+                    break;
+                case IrOp::BRANCH:
+                    out.op = Op::BRANCH;
+                    jumps.emplace_back(code.size(), std::vector<const IrBlock*>{ir.targets[0], ir.targets[1]});
+                    break;
+                case IrOp::RETURN:
+                    out.op = Op::RETURN;
+                    break;
+            }
+            code.push_back(out);
+        }
+    }
+
+    for (const auto& [position, targets] : jumps) {
+        Instruction& jump = code[position];
+        if (jump.op == Op::JUMP) {
+            jump.target = starts.at(targets[0]);
+        }
+        else {
+            jump.target = starts.at(targets[0]);
+            jump.b = starts.at(targets[1]);
+        }
+    }
+}
+
+std::any RegisterVm::execute(Interpreter& interpreter, const std::shared_ptr<Environment>& closure,
+                             const std::vector<std::any>& args) const {
+    std::vector<std::any> registers(registerCount);
+    std::any* r = registers.data();
+    size_t pc = 0;
+
+    // Operands are looked up per operation, since jumps keep code positions where registers would be
+    while (true) {
+        const Instruction& in = code[pc++];
+
+        switch (in.op) {
+            case Op::MOVE:
+                r[in.target] = r[in.a];
+                break;
+            case Op::CONST:
+                r[in.target] = constants[in.index];
+                break;
+            case Op::PARAM:
+                r[in.target] = args[in.index];
+                break;
+            case Op::LOAD_GLOBAL: {
+                std::any* global = interpreter.findGlobal(in.token->lexeme);
+                if (global == nullptr) {
+                    throw RuntimeError(*in.token, "Undefined variable '" + in.token->lexeme + "'.");
+                }
+                r[in.target] = *global;
+                break;
+            }
+            case Op::STORE_GLOBAL: {
+                std::any* global = interpreter.findGlobal(in.token->lexeme);
+                if (global == nullptr) {
+                    throw RuntimeError(*in.token, "Undefined variable '" + in.token->lexeme + "'.");
+                }
+                *global = r[in.a];
+                break;
+            }
+            case Op::LOAD_ENV:
+                r[in.target] = closure->getAt(in.index, in.token->lexeme);
+                break;
+            case Op::STORE_ENV:
+                closure->assignAt(in.index, *in.token, r[in.a]);
+                break;
+            case Op::CHECK_NUMBER:
+                compiled::checkNumberOperand(*in.token, r[in.a]);
+                r[in.target] = r[in.a];
+                break;
+            case Op::ADD:
+                r[in.target] = compiled::add(interpreter, *in.token, r[in.a], r[in.b]);
+                break;
+            case Op::ADD_NUMBER:
+                r[in.target] = number(r[in.a]) + number(r[in.b]);
+                break;
+            case Op::SUBTRACT:
+                r[in.target] = number(r[in.a]) - number(r[in.b]);
+                break;
+            case Op::MULTIPLY:
+                r[in.target] = number(r[in.a]) * number(r[in.b]);
+                break;
+            case Op::DIVIDE:
+                if (number(r[in.b]) == 0) {
+                    throw RuntimeError(*in.token, "Cannot divide by zero.");
+                }
+                r[in.target] = number(r[in.a]) / number(r[in.b]);
+                break;
+            case Op::NEGATE:
+                r[in.target] = -number(r[in.a]);
+                break;
+            case Op::NOT:
+                r[in.target] = !Interpreter::isTruthy(r[in.a]);
+                break;
+            case Op::EQUAL:
+                r[in.target] = Interpreter::isEqual(r[in.a], r[in.b]);
+                break;
+            case Op::NOT_EQUAL:
+                r[in.target] = !Interpreter::isEqual(r[in.a], r[in.b]);
+                break;
+            case Op::GREATER:
+                r[in.target] = std::any_cast<double>(r[in.a]) > std::any_cast<double>(r[in.b]);
+                break;
+            case Op::GREATER_EQUAL:
+                r[in.target] = std::any_cast<double>(r[in.a]) >= std::any_cast<double>(r[in.b]);
+                break;
+            case Op::LESS:
+                r[in.target] = std::any_cast<double>(r[in.a]) < std::any_cast<double>(r[in.b]);
+                break;
+            case Op::LESS_EQUAL:
+                r[in.target] = std::any_cast<double>(r[in.a]) <= std::any_cast<double>(r[in.b]);
+                break;
+            case Op::GREATER_NUMBER:
+                r[in.target] = number(r[in.a]) > number(r[in.b]);
+                break;
+            case Op::GREATER_EQUAL_NUMBER:
+                r[in.target] = number(r[in.a]) >= number(r[in.b]);
+                break;
+            case Op::LESS_NUMBER:
+                r[in.target] = number(r[in.a]) < number(r[in.b]);
+                break;
+            case Op::LESS_EQUAL_NUMBER:
+                r[in.target] = number(r[in.a]) <= number(r[in.b]);
+                break;
+            case Op::CALL: {
+                std::vector<std::any> callArguments;
+                callArguments.reserve(in.b);
+                for (uint32_t i = 0; i < in.b; ++i) {
+                    callArguments.push_back(registers[arguments[in.index + i]]);
+                }
+                r[in.target] = compiled::call(interpreter, *in.token, r[in.a], callArguments);
+                break;
+            }
+            case Op::GET:
+                r[in.target] = compiled::get(*in.token, r[in.a]);
+                break;
+            case Op::FIELD_TARGET:
+                compiled::fieldTarget(*in.token, r[in.a]);
+                r[in.target] = r[in.a];
+                break;
+            case Op::SET:
+                std::any_cast<const std::shared_ptr<LoxInstance>&>(r[in.a])->set(*in.token, r[in.b]);
+                break;
+            case Op::SUPER:
+                r[in.target] = compiled::superMethod(*in.token, r[in.a], r[in.b]);
+                break;
+            case Op::PRINT:
+                compiled::print(interpreter, r[in.a]);
+                break;
+            case Op::JUMP:
+                pc = in.target;
+                break;
+            case Op::BRANCH:
+                pc = Interpreter::isTruthy(r[in.a]) ? in.target : in.b;
+                break;
+            case Op::RETURN:
+                return r[in.a];
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#include "../include/ReplSession.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include "../include/EscapeAnalysis.hpp"
+#include "../include/Inliner.hpp"
+#include "../include/LoopAnalysis.hpp"
+#include "../include/ModuleLoader.hpp"
+#include "../include/Parser.hpp"
+#include "../include/Scanner.hpp"
+#include "../include/TypeInference.hpp"
+
+namespace {
+/// @brief Checks whether any function declared in the given statements is referenced from outside the syntax tree,
+/// i.e. by a LoxFunction. Each node is otherwise owned only by its parent.
+bool isReferenced(const std::vector<std::shared_ptr<Stmt>>& statements);
+
+bool isReferenced(const std::shared_ptr<Stmt>& stmt) {
+    if (!stmt) {
+        return false;
+    }
+
+    // Raw casts, since casting shared pointers would add references of our own
+    if (auto function = dynamic_cast<Function*>(stmt.get())) {
+        return stmt.use_count() > 1 || isReferenced(function->body);
+    }
+    else if (auto loxClass = dynamic_cast<Class*>(stmt.get())) {
+        return std::any_of(loxClass->methods.begin(), loxClass->methods.end(), [](const auto& method) {
+            return method.use_count() > 1 || isReferenced(method->body);
+        });
+    }
+    else if (auto block = dynamic_cast<Block*>(stmt.get())) {
+        return isReferenced(block->statements);
+    }
+    else if (auto ifStmt = dynamic_cast<If*>(stmt.get())) {
+        return isReferenced(ifStmt->thenBranch) || isReferenced(ifStmt->elseBranch);
+    }
+    else if (auto whileStmt = dynamic_cast<While*>(stmt.get())) {
+        return isReferenced(whileStmt->body);
+    }
+    else if (auto forStmt = dynamic_cast<For*>(stmt.get())) {
+        return isReferenced(forStmt->body);
+    }
+    return false;
+}
+
+bool isReferenced(const std::vector<std::shared_ptr<Stmt>>& statements) {
+    return std::any_of(statements.begin(), statements.end(), [](const auto& stmt) { return isReferenced(stmt); });
+}
+}  // namespace
+
+bool ReplSession::feed(const std::string& line) {
+    if (!buffer.empty()) {
+        buffer += '\n';
+    }
+    buffer += line;
+
+    // Parse with errors held back, since they may only mean the input isn't finished yet
+    std::ostringstream trialErrors;
+    ErrorState trial;
+    trial.stream = &trialErrors;
+    std::vector<std::shared_ptr<Stmt>> statements;
+    bool incomplete;
+    {
+        ErrorScope scope(trial);
+        Scanner scanner(buffer);
+        std::vector<Token> tokens = scanner.scanTokens();
+        incomplete = scanner.isIncomplete();
+
+        if (!incomplete) {
+            Parser parser(tokens);
+            statements = parser.parse();
+            incomplete = parser.isIncomplete();
+        }
+    }
+
+    // A blank line gives up on completing the input, so a mistake can't leave the prompt waiting forever
+    bool blank = line.find_first_not_of(" \t\r") == std::string::npos;
+    if (incomplete && !blank) {
+        return false;
+    }
+    buffer.clear();
+
+    ErrorState& state = isolate.getErrorState();
+    if (trial.hadError) {
+        *state.stream << trialErrors.str() << std::flush;
+        state.hadError = true;
+        return true;
+    }
+
+    auto program = std::make_shared<Program>();
+    program->statements = std::move(statements);
+    {
+        ErrorScope scope(state);
+        bool hadErrorBefore = state.hadError;
+        state.hadError = false;
+
+        resolver.resolve(program->statements);
+        program->locals = std::move(resolved);
+        resolved.clear();
+        if (state.hadError) {
+            return true;
+        }
+        TypeInference(program->locals).infer(program->statements);
+        Inliner(program->locals).inlineCalls(program->statements);
+        EscapeAnalysis(program->locals).analyze(program->statements);
+        LoopAnalysis(program->locals).analyze(program->statements);
+        if (!ModuleLoader("").load(program)) {
+            return true;
+        }
+        state.hadError = hadErrorBefore;
+    }
+
+    isolate.run(program);
+    retained.push_back(program);
+    release();
+    return true;
+}
+
+void ReplSession::release() {
+    std::erase_if(retained, [this](const std::shared_ptr<const Program>& program) {
+        if (isReferenced(program->statements)) {
+            return false;
+        }
+        isolate.unload(program);
+        return true;
+    });
+}
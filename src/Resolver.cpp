@@ -1,79 +1,78 @@
 #include "../include/Resolver.hpp"
 
 #include "../include/Error.hpp"
+#include "../include/LoxClass.hpp"
 
-std::any Resolver::visitAssignExpr(std::shared_ptr<Assign> expr) {
+void Resolver::visitAssignExpr(std::shared_ptr<Assign> expr) {
     resolve(expr->value);
     resolveLocal(expr, expr->name);
-    return nullptr;
 }
-std::any Resolver::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+void Resolver::visitBinaryExpr(std::shared_ptr<Binary> expr) {
     resolve(expr->left);
     resolve(expr->right);
-    return nullptr;
 }
-std::any Resolver::visitCallExpr(std::shared_ptr<Call> expr) {
+void Resolver::visitCallExpr(std::shared_ptr<Call> expr) {
     resolve(expr->callee);
     for (const auto& arg : expr->arguments) {
         resolve(arg);
     }
-    return nullptr;
 }
-std::any Resolver::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
+void Resolver::visitGroupingExpr(std::shared_ptr<Grouping> expr) {
     resolve(expr->expression);
-    return nullptr;
 }
-std::any Resolver::visitGetExpr(std::shared_ptr<Get> expr) {
+void Resolver::visitGetExpr(std::shared_ptr<Get> expr) {
+    // Every property access gets an inline cache for the Interpreter to fill in
+    expr->cache = std::make_shared<PropertyCache>();
     resolve(expr->object);
-    return nullptr;
 }
-std::any Resolver::visitLiteralExpr(std::shared_ptr<Literal> expr) {
-    return nullptr;
-}
-std::any Resolver::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+void Resolver::visitLiteralExpr(std::shared_ptr<Literal> expr) {}
+void Resolver::visitLogicalExpr(std::shared_ptr<Logical> expr) {
     resolve(expr->left);
     resolve(expr->right);
-    return nullptr;
 }
-std::any Resolver::visitSetExpr(std::shared_ptr<Set> expr) {
+void Resolver::visitSetExpr(std::shared_ptr<Set> expr) {
+    expr->cache = std::make_shared<PropertyCache>();
     resolve(expr->object);
     resolve(expr->value);
-    return nullptr;
 }
-std::any Resolver::visitSuperExpr(std::shared_ptr<Super> expr) {
+void Resolver::visitSuperExpr(std::shared_ptr<Super> expr) {
+    if (currentSuperMethods == nullptr) {
+        error(expr->keyword, currentClass == ClassType::NONE ? "Can't use 'super' outside of a class."
+                                                             : "Can't use 'super' in a class with no superclass.");
+        return;
+    }
+
+    expr->site = std::make_shared<SuperSite>(SuperSite{currentSuperMethods->names.size()});
+    currentSuperMethods->names.push_back(expr->method.lexeme);
     resolveLocal(expr, expr->keyword);
-    return nullptr;
 }
-std::any Resolver::visitThisExpr(std::shared_ptr<This> expr) {
+void Resolver::visitThisExpr(std::shared_ptr<This> expr) {
     if (currentClass == ClassType::NONE) {
         error(expr->keyword, "Can't use 'this' outside of a class.");
-        return nullptr;
+        return;
     }
 
     resolveLocal(expr, expr->keyword);
-    return nullptr;
 }
-std::any Resolver::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+void Resolver::visitUnaryExpr(std::shared_ptr<Unary> expr) {
     resolve(expr->right);
-    return nullptr;
 }
-std::any Resolver::visitVariableExpr(std::shared_ptr<Variable> expr) {
+void Resolver::visitVariableExpr(std::shared_ptr<Variable> expr) {
     if (!scopes.empty() && scopes.top().contains(expr->name.lexeme) && scopes.top()[expr->name.lexeme] == false) {
         error(expr->name, "Can't read local variable name in its own initializer.");
     }
 
     resolveLocal(expr, expr->name);
-    return nullptr;
 }
 
-std::any Resolver::visitBlockStmt(std::shared_ptr<Block> stmt) {
+void Resolver::visitBlockStmt(std::shared_ptr<Block> stmt) {
     beginScope();
     resolve(stmt->statements);
     endScope();
-    return nullptr;
 }
-std::any Resolver::visitClassStmt(std::shared_ptr<Class> stmt) {
+void Resolver::visitClassStmt(std::shared_ptr<Class> stmt) {
     ClassType enclosingClass = currentClass;
+    SuperMethods* enclosingSuperMethods = currentSuperMethods;
     currentClass = ClassType::CLASS;
 
     declare(stmt->name);
@@ -89,6 +88,8 @@ std::any Resolver::visitClassStmt(std::shared_ptr<Class> stmt) {
         beginScope();
         scopes.top()["super"] = true;
         currentClass = ClassType::SUBCLASS;
+        stmt->superMethods = std::make_shared<SuperMethods>();
+        currentSuperMethods = stmt->superMethods.get();
     }
 
     beginScope();
@@ -109,33 +110,51 @@ std::any Resolver::visitClassStmt(std::shared_ptr<Class> stmt) {
     }
 
     currentClass = enclosingClass;
-
-    return nullptr;
+    currentSuperMethods = enclosingSuperMethods;
 }
-std::any Resolver::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+void Resolver::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
     resolve(stmt->expression);
-    return nullptr;
 }
-std::any Resolver::visitFunctionStmt(std::shared_ptr<Function> stmt) {
+void Resolver::visitForStmt(std::shared_ptr<For> stmt) {
+    // The initializer's variable is shared by every iteration, so its scope encloses the whole loop
+    if (stmt->initializer != nullptr) {
+        beginScope();
+        resolve(stmt->initializer);
+    }
+    if (stmt->condition != nullptr) {
+        resolve(stmt->condition);
+    }
+    resolve(stmt->body);
+    if (stmt->increment != nullptr) {
+        resolve(stmt->increment);
+    }
+    if (stmt->initializer != nullptr) {
+        endScope();
+    }
+}
+void Resolver::visitFunctionStmt(std::shared_ptr<Function> stmt) {
     declare(stmt->name);
     define(stmt->name);
 
     resolveFunction(stmt, FunctionType::FUNCTION);
-    return nullptr;
 }
-std::any Resolver::visitIfStmt(std::shared_ptr<If> stmt) {
+void Resolver::visitIfStmt(std::shared_ptr<If> stmt) {
     resolve(stmt->condition);
     resolve(stmt->thenBranch);
     if (stmt->elseBranch != nullptr) {
         resolve(stmt->elseBranch);
     }
-    return nullptr;
 }
-std::any Resolver::visitPrintStmt(std::shared_ptr<Print> stmt) {
+void Resolver::visitImportStmt(std::shared_ptr<Import> stmt) {
+    // Modules run in the global scope, so importing anywhere else would suggest a scoping that doesn't exist
+    if (!scopes.empty()) {
+        error(stmt->keyword, "Can only import at the top level.");
+    }
+}
+void Resolver::visitPrintStmt(std::shared_ptr<Print> stmt) {
     resolve(stmt->expression);
-    return nullptr;
 }
-std::any Resolver::visitReturnStmt(std::shared_ptr<Return> stmt) {
+void Resolver::visitReturnStmt(std::shared_ptr<Return> stmt) {
     if (currentFunction == FunctionType::NONE) {
         error(stmt->keyword, "Can't return from top-level code.");
     }
@@ -146,20 +165,17 @@ std::any Resolver::visitReturnStmt(std::shared_ptr<Return> stmt) {
         }
         resolve(stmt->value);
     }
-    return nullptr;
 }
-std::any Resolver::visitVarStmt(std::shared_ptr<Var> stmt) {
+void Resolver::visitVarStmt(std::shared_ptr<Var> stmt) {
     declare(stmt->name);
     if (stmt->initializer != nullptr) {
         resolve(stmt->initializer);
     }
     define(stmt->name);
-    return nullptr;
 }
-std::any Resolver::visitWhileStmt(std::shared_ptr<While> stmt) {
+void Resolver::visitWhileStmt(std::shared_ptr<While> stmt) {
     resolve(stmt->condition);
     resolve(stmt->body);
-    return nullptr;
 }
 
 void Resolver::beginScope() {
@@ -183,7 +199,7 @@ void Resolver::resolveLocal(std::shared_ptr<Expr> expr, const Token& name) {
     std::stack<std::map<std::string, bool>> tempScopes = scopes;
     for (int i = scopes.size() - 1; i >= 0; tempScopes.pop(), --i) {
         if (tempScopes.top().contains(name.lexeme)) {
-            interpreter.resolve(expr, scopes.size() - i - 1);
+            locals[expr] = scopes.size() - i - 1;
             return;
         }
     }
@@ -116,6 +116,7 @@ void Scanner::string() {
     // Handle unterminated string error
     if (isAtEnd()) {
         error(line, "Unterminated string.");
+        incomplete = true;
     }
 
     // Advance past closing "
@@ -180,6 +181,7 @@ void Scanner::blockComment() {
     // Handle unterminated block comment error
     if (isAtEnd()) {
         error(line, "Unterminated block comment.");
+        incomplete = true;
     }
 }
 
@@ -222,6 +224,7 @@ const std::map<std::string, TokenType> Scanner::keywords = {{"and", TokenType::A
                                                             {"fun", TokenType::FUN},
                                                             {"for", TokenType::FOR},
                                                             {"if", TokenType::IF},
+                                                            {"import", TokenType::IMPORT},
                                                             {"nil", TokenType::NIL},
                                                             {"or", TokenType::OR},
                                                             {"print", TokenType::PRINT},
@@ -0,0 +1,213 @@
+#include "../include/Scheduler.hpp"
+
+#include <algorithm>
+
+#include "../include/Error.hpp"
+#include "../include/Interpreter.hpp"
+#include "../include/LoxCallable.hpp"
+#include "../include/LoxTask.hpp"
+
+namespace {
+/// @brief Thrown inside a cancelled task when it resumes, to unwind its stack.
+struct TaskCancelled {};
+
+/// @brief Returns the error awaiting a cancelled task raises.
+std::exception_ptr cancelledError() {
+    return std::make_exception_ptr(NativeError("Task was cancelled."));
+}
+}  // namespace
+
+Scheduler::~Scheduler() {
+    abandon();
+    finishedTask.reset();
+    current.reset();
+}
+
+std::shared_ptr<LoxTask> Scheduler::spawn(std::shared_ptr<LoxCallable> function) {
+    running();
+
+    auto task = std::make_shared<LoxTask>(*this, function);
+    task->context = std::make_unique<Coroutine>(run, task.get());
+    task->environment = interpreter.globals;
+    runQueue.push_back(task);
+    return task;
+}
+
+void Scheduler::yield() {
+    // Let tasks whose I/O is ready join the queue, so a busy loop of yields can't starve them
+    if (events && events->pending()) {
+        events->poll(false);
+    }
+    if (runQueue.empty()) {
+        return;
+    }
+    runQueue.push_back(current);
+    switchFrom(*current);
+}
+
+std::any Scheduler::await(LoxTask& task) {
+    if (!task.finished) {
+        // The chain of tasks the awaited task is blocked on must not lead back to this one
+        for (LoxTask* blocker = &task; blocker; blocker = blocker->awaiting) {
+            if (blocker == current.get()) {
+                throw NativeError("Deadlock: tasks are awaiting each other.");
+            }
+        }
+
+        // Some unblocked task is now at the end of that chain, so there is a task to switch to, possibly once the
+        // event loop resumes it
+        current->awaiting = &task;
+        task.waiters.push_back(current);
+        switchFrom(*current);
+    }
+
+    if (task.error) {
+        std::erase_if(failed, [&](const auto& other) { return other.get() == &task; });
+        std::rethrow_exception(task.error);
+    }
+    return task.result;
+}
+
+std::shared_ptr<LoxTask> Scheduler::running() {
+    if (!current) {
+        current = std::make_shared<LoxTask>(*this, nullptr);
+        current->context = std::make_unique<Coroutine>();
+    }
+    return current;
+}
+
+void Scheduler::suspend() {
+    switchFrom(*running());
+}
+
+void Scheduler::resume(std::shared_ptr<LoxTask> task) {
+    runQueue.push_back(std::move(task));
+}
+
+EventLoop& Scheduler::getEvents() {
+    if (!events) {
+        events = std::make_unique<EventLoop>(*this);
+    }
+    return *events;
+}
+
+void Scheduler::finishAll() {
+    while (!runQueue.empty() || (events && events->pending())) {
+        if (runQueue.empty()) {
+            events->poll(true);
+        }
+        yield();
+    }
+
+    if (!failed.empty()) {
+        std::exception_ptr error = failed.front()->error;
+        failed.clear();
+        std::rethrow_exception(error);
+    }
+}
+
+void Scheduler::abandon() {
+    // Every unfinished task is queued, waiting on the event loop, or awaiting one of those
+    std::vector<std::shared_ptr<LoxTask>> pending(runQueue.begin(), runQueue.end());
+    runQueue.clear();
+    if (events) {
+        for (auto& task : events->clear()) {
+            pending.push_back(std::move(task));
+        }
+    }
+    for (size_t i = 0; i < pending.size(); ++i) {
+        std::vector<std::shared_ptr<LoxTask>> waiters = std::move(pending[i]->waiters);
+        pending[i]->waiters.clear();
+        pending.insert(pending.end(), waiters.begin(), waiters.end());
+    }
+    failed.clear();
+
+    for (auto& task : pending) {
+        if (task->finished || task == current) {
+            continue;
+        }
+        task->cancelled = true;
+        if (!task->started) {
+            task->finished = true;
+            task->error = cancelledError();
+            task->function.reset();
+            task->context.reset();
+            continue;
+        }
+
+        // Resume the task so it throws TaskCancelled where it was suspended, then comes back here once finished
+        runQueue.push_back(task);
+        runQueue.push_back(current);
+        switchFrom(*current);
+    }
+}
+
+void Scheduler::run(void* argument) {
+    LoxTask& task = *static_cast<LoxTask*>(argument);
+    Scheduler& scheduler = task.scheduler;
+    scheduler.releaseFinished();
+    task.started = true;
+
+    // Nothing may be left on this stack by the time it is released, so keep every owner inside this block
+    {
+        try {
+            task.result = task.function->call(scheduler.interpreter, {});
+        }
+        catch (...) {
+            task.error = task.cancelled ? cancelledError() : std::current_exception();
+        }
+    }
+    scheduler.finish(task);
+}
+
+void Scheduler::finish(LoxTask& task) {
+    task.finished = true;
+    task.function.reset();
+
+    if (task.error && task.waiters.empty() && !task.cancelled) {
+        failed.push_back(current);
+    }
+    for (auto& waiter : task.waiters) {
+        waiter->awaiting = nullptr;
+        runQueue.push_back(std::move(waiter));
+    }
+    task.waiters.clear();
+
+    // A finishing task can't be the only unblocked one while others are blocked without being one of their
+    // waiters, so there is always a task to switch to, possibly once the event loop resumes it
+    finishedTask = std::move(current);
+    switchFrom(task);
+}
+
+void Scheduler::switchFrom(LoxTask& task) {
+    task.environment = interpreter.environment;
+
+    while (runQueue.empty()) {
+        // With nothing runnable and nothing to wait for, no task could ever resume this one
+        if (!events || !events->pending()) {
+            throw NativeError("Deadlock: tasks are awaiting each other.");
+        }
+        events->poll(true);
+    }
+    current = std::move(runQueue.front());
+    runQueue.pop_front();
+    interpreter.environment = current->environment;
+
+    // A task blocked on the event loop may be the next to run when nothing else could
+    if (current.get() != &task) {
+        task.context->switchTo(*current->context);
+    }
+
+    releaseFinished();
+    if (task.cancelled) {
+        throw TaskCancelled();
+    }
+}
+
+void Scheduler::releaseFinished() {
+    if (finishedTask) {
+        finishedTask->context.reset();
+        finishedTask->environment.reset();
+        finishedTask.reset();
+    }
+}
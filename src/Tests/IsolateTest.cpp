@@ -0,0 +1,61 @@
+#include <fcntl.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../include/Isolate.hpp"
+
+// Runs one isolate per thread. Each script calls nil() (a runtime error) only if its results are wrong, so a
+// clean error stream means the isolates didn't interfere with each other.
+int main() {
+    constexpr int threadCount = 8;
+
+    std::vector<std::ostringstream> errors(threadCount);
+    bool passed[threadCount] = {};
+    std::vector<std::thread> threads;
+    int devNull = open("/dev/null", O_WRONLY);
+
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([i, devNull, &errors, &passed] {
+            Isolate isolate(errors[i]);
+            isolate.getOutput().setFd(devNull);
+
+            // Natives can carry state of their own isolate's embedder
+            int ticks = 0;
+            isolate.defineNative("tick", {}, [&ticks](Interpreter&, std::span<const std::any>) {
+                return std::any(static_cast<double>(++ticks));
+            });
+
+            std::string id = std::to_string(i);
+            isolate.run("var id = " + id + ";\n"
+                        "fun fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }\n"
+                        "class Box { init(v) { this.v = v; } get() { return this.v; } }\n"
+                        "var total = 0;\n"
+                        "for (var j = 0; j < 2000; j = j + 1) total = total + Box(id).get();\n"
+                        "for (var j = 0; j < 100 + id; j = j + 1) tick();\n"
+                        "print total;\n"
+                        "if (fib(18) != 2584 or total != 2000 * id) nil();\n");
+
+            // Error state belongs to the isolate that reported it
+            isolate.run("if (id == 3) undefinedVariable;");
+            passed[i] = !isolate.hadError() && isolate.hadRuntimeError() == (i == 3) && ticks == 100 + i;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool allPassed = true;
+    for (int i = 0; i < threadCount; ++i) {
+        if (!passed[i]) {
+            std::cout << "Isolate " << i << " failed:\n" << errors[i].str();
+            allPassed = false;
+        }
+    }
+
+    std::cout << (allPassed ? "All isolates passed" : "Some isolates failed") << "\n";
+    return allPassed ? 0 : 1;
+}
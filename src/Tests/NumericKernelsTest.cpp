@@ -0,0 +1,42 @@
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../../include/NumericKernels.hpp"
+
+// Checks that min() and max() return NaN wherever the NaN sits: in the first lane, in a lane in the middle of a
+// register, or in the scalar tail, for every size around the widest register.
+int main() {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    bool allPassed = true;
+    auto check = [&allPassed](bool ok, const std::string& what) {
+        if (!ok) {
+            std::cerr << "FAILED: " << what << std::endl;
+            allPassed = false;
+        }
+    };
+
+    for (size_t size = 1; size <= 11; ++size) {
+        std::vector<double> numbers;
+        for (size_t i = 0; i < size; ++i) {
+            numbers.push_back(static_cast<double>(size - i));
+        }
+        check(kernelMin(numbers) == 1, "min of " + std::to_string(size) + " numbers");
+        check(kernelMax(numbers) == static_cast<double>(size), "max of " + std::to_string(size) + " numbers");
+
+        for (size_t position : {size_t(0), size / 2, size - 1}) {
+            std::vector<double> withNan = numbers;
+            withNan[position] = nan;
+            std::string where = " with NaN at " + std::to_string(position) + " of " + std::to_string(size);
+            check(std::isnan(kernelMin(withNan)), "min" + where);
+            check(std::isnan(kernelMax(withNan)), "max" + where);
+        }
+    }
+
+    if (allPassed) {
+        std::cout << "All kernels passed" << std::endl;
+    }
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../include/Parser.hpp"
+#include "../../include/Scanner.hpp"
+
+// Times the Parser alone on generated sources, the way long machine-written expressions reach it. Each source is
+// scanned once, then parsed repeatedly from the same tokens.
+namespace {
+std::string longExpressions(int lines, int operands) {
+    static const char* operators[] = {" + ", " * ", " - ", " / ", " < ", " == ", " and ", " or "};
+    std::string source;
+    for (int i = 0; i < lines; ++i) {
+        source += "var v" + std::to_string(i) + " = ";
+        for (int j = 0; j < operands; ++j) {
+            if (j > 0) {
+                source += operators[(i + j) % 8];
+            }
+            source += j % 3 == 0 ? "f(a, " + std::to_string(j) + ")" : j % 3 == 1 ? "a.b.c" : "-" + std::to_string(j);
+        }
+        source += ";\n";
+    }
+    return source;
+}
+
+std::string nestedGroupings(int depth) {
+    return "print " + std::string(depth, '(') + "1" + std::string(depth, ')') + ";\n";
+}
+
+void run(const std::string& name, const std::string& source, int iterations) {
+    std::vector<Token> tokens = Scanner(source).scanTokens();
+
+    size_t statements = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        statements += Parser(tokens).parse().size();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << tokens.size() << " tokens, " << statements / iterations << " statements, "
+              << elapsed.count() * 1000 / iterations << " ms per parse, "
+              << tokens.size() * iterations / elapsed.count() / 1e6 << "M tokens/s\n";
+}
+}  // namespace
+
+int main() {
+    run("long expressions", longExpressions(2000, 64), 10);
+    run("nested groupings", nestedGroupings(2000), 100);
+}
@@ -0,0 +1,59 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../include/Pool.hpp"
+
+// Checks that SlabPool's memory stays bounded when threads come and go, and when one thread frees the blocks
+// another allocated, rather than growing with every round.
+int main() {
+    constexpr size_t blockSize = 64;
+    constexpr size_t blocksPerRound = 10000;
+    constexpr int rounds = 50;
+    // Each round needs about 10 slabs; leftovers may stay in the shared depot until enough accumulate to release
+    constexpr size_t slabBound = 32;
+
+    bool allPassed = true;
+    auto check = [&allPassed](bool ok, const std::string& what) {
+        if (!ok) {
+            std::cerr << "FAILED: " << what << " (" << SlabPool::liveSlabs() << " slabs live)" << std::endl;
+            allPassed = false;
+        }
+    };
+
+    // Thread churn: every thread's free lists must be reused or released after it exits
+    for (int round = 0; round < rounds; ++round) {
+        std::thread([] {
+            std::vector<void*> blocks;
+            for (size_t i = 0; i < blocksPerRound; ++i) {
+                blocks.push_back(SlabPool::allocate(blockSize));
+            }
+            for (void* block : blocks) {
+                SlabPool::deallocate(block, blockSize);
+            }
+        }).join();
+    }
+    check(SlabPool::liveSlabs() <= slabBound, "thread churn");
+
+    // Producer and consumer: blocks allocated on one thread and freed on another must flow back to the producer
+    std::vector<void*> blocks;
+    for (int round = 0; round < rounds; ++round) {
+        std::thread producer([&blocks] {
+            for (size_t i = 0; i < blocksPerRound; ++i) {
+                blocks.push_back(SlabPool::allocate(blockSize));
+            }
+        });
+        producer.join();
+        for (void* block : blocks) {
+            SlabPool::deallocate(block, blockSize);
+        }
+        blocks.clear();
+    }
+    check(SlabPool::liveSlabs() <= slabBound, "producer and consumer");
+
+    if (allPassed) {
+        std::cout << "All pool checks passed" << std::endl;
+    }
+    return allPassed ? 0 : 1;
+}
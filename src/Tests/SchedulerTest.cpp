@@ -0,0 +1,86 @@
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../../include/Isolate.hpp"
+#include "../../include/NativeObject.hpp"
+
+// Checks that tasks abandoned while suspended release what their frames own, both when the main program fails and
+// when the isolate is destroyed with tasks still pending.
+namespace {
+int live = 0;
+
+/// @brief Native object that counts how many of its kind are alive.
+class Tracked : public NativeObject {
+   public:
+    Tracked() { ++live; }
+    ~Tracked() override { --live; }
+
+    std::string toString(Interpreter&) override { return "<tracked>"; }
+
+   protected:
+    const NativeMethodTable& methods() const override {
+        static const NativeMethodTable table;
+        return table;
+    }
+};
+
+// Leaves a task suspended in each way a task can be: yielded, sleeping, awaiting another task, and not yet started
+const char* script =
+    "fun yielder() { var owned = track(); yield(); print owned; }\n"
+    "fun sleeper() { var owned = track(); sleep(100000); print owned; }\n"
+    "var sleeping = spawn(sleeper);\n"
+    "fun awaiter() { var owned = track(); await(sleeping); print owned; }\n"
+    "spawn(yielder);\n"
+    "spawn(awaiter);\n"
+    "yield();\n"
+    "spawn(yielder);\n";
+
+void defineTrack(Isolate& isolate) {
+    isolate.defineNative("track", {}, [](Interpreter&, std::span<const std::any>) {
+        return std::any(std::shared_ptr<NativeObject>(std::make_shared<Tracked>()));
+    });
+}
+}  // namespace
+
+int main() {
+    bool allPassed = true;
+    auto check = [&allPassed](bool ok, const std::string& what) {
+        if (!ok) {
+            std::cerr << "FAILED: " << what << " (" << live << " owners left)" << std::endl;
+            allPassed = false;
+        }
+    };
+
+    // The main program fails, so the interpreter abandons the pending tasks
+    {
+        std::ostringstream errors;
+        Isolate isolate(errors);
+        defineTrack(isolate);
+        isolate.run(std::string(script) + "nil();\n");
+        check(isolate.hadRuntimeError(), "runtime error reported");
+        check(live == 0, "tasks abandoned after a runtime error");
+    }
+
+    // An embedder's native throws past the interpreter, so the scheduler abandons the tasks on destruction
+    {
+        std::ostringstream errors;
+        Isolate isolate(errors);
+        defineTrack(isolate);
+        isolate.defineNative("explode", {}, [](Interpreter&, std::span<const std::any>) -> std::any {
+            throw std::runtime_error("explode");
+        });
+        try {
+            isolate.run(std::string(script) + "explode();\n");
+        }
+        catch (const std::runtime_error&) {
+        }
+    }
+    check(live == 0, "tasks abandoned when the isolate is destroyed");
+
+    if (allPassed) {
+        std::cout << "All scheduler checks passed" << std::endl;
+    }
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include "../include/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace {
+// The pool and index of the worker running on this thread, if any
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threadCount) {
+    threadCount = std::max<size_t>(threadCount, 1);
+
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    size_t index = currentPool == this ? currentWorker : nextWorker++ % workers.size();
+
+    ++pending;
+    {
+        std::lock_guard lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Increment under the lock so a worker about to sleep can't miss it
+        std::lock_guard lock(mutex);
+        ++queued;
+    }
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock(mutex);
+    allDone.wait(lock, [this] { return pending == 0; });
+}
+
+bool ThreadPool::tryRun(size_t self) {
+    Task task;
+
+    // Own deque first, newest task first
+    {
+        Worker& worker = *workers[self];
+        std::lock_guard lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+    }
+    // Otherwise steal the oldest task of another worker
+    for (size_t i = 1; !task && i < workers.size(); ++i) {
+        Worker& victim = *workers[(self + i) % workers.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if (!task) {
+        return false;
+    }
+
+    --queued;
+    task();
+
+    if (--pending == 0) {
+        std::lock_guard lock(mutex);
+        allDone.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::work(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        if (tryRun(index)) {
+            continue;
+        }
+
+        std::unique_lock lock(mutex);
+        workAvailable.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
@@ -42,6 +42,7 @@ std::string tokenTypeString(TokenType type) {
                                                                  {TokenType::FUN, "FUN"},
                                                                  {TokenType::FOR, "FOR"},
                                                                  {TokenType::IF, "IF"},
+                                                                 {TokenType::IMPORT, "IMPORT"},
                                                                  {TokenType::NIL, "NIL"},
                                                                  {TokenType::OR, "OR"},
                                                                  {TokenType::PRINT, "PRINT"},
@@ -0,0 +1,359 @@
+#include "../include/TypeInference.hpp"
+
+namespace {
+constexpr unsigned NUMBER = 1 << 0;
+constexpr unsigned STRING = 1 << 1;
+constexpr unsigned BOOL = 1 << 2;
+constexpr unsigned NIL = 1 << 3;
+constexpr unsigned OBJECT = 1 << 4;
+constexpr unsigned ANY = NUMBER | STRING | BOOL | NIL | OBJECT;
+}  // namespace
+
+void TypeInference::infer(const std::vector<std::shared_ptr<Stmt>>& statements) {
+    ClosureAnalysis(locals, closures).analyze(&statements, statements);
+
+    state = State();
+    execute(statements);
+
+    for (const auto& [expr, types] : seen) {
+        expr->type = toStaticType(types);
+    }
+}
+
+TypeInference::Types TypeInference::visitAssignExpr(std::shared_ptr<Assign> expr) {
+    Types types = infer(expr->value);
+    if (const Slot* slot = tracked(expr.get())) {
+        state.variables[slot] = types;
+    }
+    return types;
+}
+
+TypeInference::Types TypeInference::visitBinaryExpr(std::shared_ptr<Binary> expr) {
+    Types left = infer(expr->left);
+    Types right = infer(expr->right);
+
+    switch (expr->oper.type) {
+        case TokenType::GREATER:
+        case TokenType::GREATER_EQUAL:
+        case TokenType::LESS:
+        case TokenType::LESS_EQUAL:
+            // Only numbers get past the checks and casts of comparisons
+            refine(expr->left, expr->right);
+            refine(expr->right);
+            return BOOL;
+
+        case TokenType::EQUAL_EQUAL:
+        case TokenType::BANG_EQUAL:
+            return BOOL;
+
+        case TokenType::PLUS:
+            if (left == NUMBER && right == NUMBER) {
+                return NUMBER;
+            }
+            else if (left == STRING || right == STRING) {
+                return STRING;
+            }
+            return NUMBER | STRING;
+
+        case TokenType::MINUS:
+        case TokenType::STAR:
+        case TokenType::SLASH:
+            refine(expr->left, expr->right);
+            refine(expr->right);
+            return NUMBER;
+
+        default:
+            break;
+    }
+
+    return ANY;
+}
+
+TypeInference::Types TypeInference::visitCallExpr(std::shared_ptr<Call> expr) {
+    infer(expr->callee);
+    for (const auto& arg : expr->arguments) {
+        infer(arg);
+    }
+    return ANY;
+}
+
+TypeInference::Types TypeInference::visitGetExpr(std::shared_ptr<Get> expr) {
+    infer(expr->object);
+    return ANY;
+}
+
+TypeInference::Types TypeInference::visitGroupingExpr(std::shared_ptr<Grouping> expr) { return infer(expr->expression); }
+
+TypeInference::Types TypeInference::visitLiteralExpr(std::shared_ptr<Literal> expr) {
+    const std::type_info& type = expr->value.type();
+    if (type == typeid(double)) {
+        return NUMBER;
+    }
+    else if (type == typeid(std::string)) {
+        return STRING;
+    }
+    else if (type == typeid(bool)) {
+        return BOOL;
+    }
+    else if (type == typeid(nullptr)) {
+        return NIL;
+    }
+    return ANY;
+}
+
+TypeInference::Types TypeInference::visitLogicalExpr(std::shared_ptr<Logical> expr) {
+    Types left = infer(expr->left);
+
+    // The right operand is only evaluated on some paths
+    State shortCircuit = state;
+    Types right = infer(expr->right);
+    state = join(shortCircuit, state);
+
+    return left | right;
+}
+
+TypeInference::Types TypeInference::visitSetExpr(std::shared_ptr<Set> expr) {
+    infer(expr->object);
+    return infer(expr->value);
+}
+
+TypeInference::Types TypeInference::visitSuperExpr(std::shared_ptr<Super>) { return OBJECT; }
+
+TypeInference::Types TypeInference::visitThisExpr(std::shared_ptr<This>) { return OBJECT; }
+
+TypeInference::Types TypeInference::visitUnaryExpr(std::shared_ptr<Unary> expr) {
+    infer(expr->right);
+
+    switch (expr->oper.type) {
+        case TokenType::MINUS:
+            refine(expr->right);
+            return NUMBER;
+        case TokenType::BANG:
+            return BOOL;
+        default:
+            break;
+    }
+
+    return ANY;
+}
+
+TypeInference::Types TypeInference::visitVariableExpr(std::shared_ptr<Variable> expr) {
+    if (const Slot* slot = tracked(expr.get())) {
+        auto it = state.variables.find(slot);
+        if (it != state.variables.end()) {
+            return it->second;
+        }
+    }
+    return ANY;
+}
+
+void TypeInference::visitBlockStmt(std::shared_ptr<Block> stmt) {
+    execute(stmt->statements);
+}
+
+void TypeInference::visitClassStmt(std::shared_ptr<Class> stmt) {
+    if (stmt->superclass != nullptr) {
+        infer(stmt->superclass);
+    }
+    define(stmt.get(), OBJECT);
+
+    for (const auto& method : stmt->methods) {
+        inferFunction(method);
+    }
+}
+
+void TypeInference::visitExpressionStmt(std::shared_ptr<Expression> stmt) {
+    infer(stmt->expression);
+}
+
+void TypeInference::visitForStmt(std::shared_ptr<For> stmt) {
+    if (stmt->initializer != nullptr) {
+        execute(stmt->initializer);
+    }
+    inferLoop(stmt->condition, stmt->body, stmt->increment);
+}
+
+void TypeInference::visitFunctionStmt(std::shared_ptr<Function> stmt) {
+    define(stmt.get(), OBJECT);
+    inferFunction(stmt);
+}
+
+void TypeInference::visitIfStmt(std::shared_ptr<If> stmt) {
+    infer(stmt->condition);
+
+    State otherwise = state;
+    execute(stmt->thenBranch);
+    std::swap(state, otherwise);
+    if (stmt->elseBranch != nullptr) {
+        execute(stmt->elseBranch);
+    }
+    state = join(state, otherwise);
+}
+
+void TypeInference::visitImportStmt(std::shared_ptr<Import>) {}
+
+void TypeInference::visitPrintStmt(std::shared_ptr<Print> stmt) {
+    infer(stmt->expression);
+}
+
+void TypeInference::visitReturnStmt(std::shared_ptr<Return> stmt) {
+    if (stmt->value != nullptr) {
+        infer(stmt->value);
+    }
+    state.reachable = false;
+}
+
+void TypeInference::visitVarStmt(std::shared_ptr<Var> stmt) {
+    Types types = stmt->initializer != nullptr ? infer(stmt->initializer) : NIL;
+    define(stmt.get(), types);
+}
+
+void TypeInference::visitWhileStmt(std::shared_ptr<While> stmt) {
+    inferLoop(stmt->condition, stmt->body, nullptr);
+}
+
+TypeInference::Types TypeInference::infer(const std::shared_ptr<Expr>& expr) {
+    Types types = expr->accept(*this);
+    seen[expr.get()] |= types;
+    return types;
+}
+
+void TypeInference::execute(const std::vector<std::shared_ptr<Stmt>>& stmts) {
+    for (const auto& stmt : stmts) {
+        stmt->accept(*this);
+    }
+}
+
+void TypeInference::execute(const std::shared_ptr<Stmt>& stmt) { stmt->accept(*this); }
+
+void TypeInference::inferLoop(const std::shared_ptr<Expr>& condition, const std::shared_ptr<Stmt>& body,
+                              const std::shared_ptr<Expr>& increment) {
+    // Widen the state at the top of the loop until the body no longer changes it
+    State entry = state;
+    while (true) {
+        state = entry;
+        if (condition != nullptr) {
+            infer(condition);
+        }
+        State exit = state;
+
+        execute(body);
+        if (increment != nullptr) {
+            infer(increment);
+        }
+        State next = join(entry, state);
+        if (next == entry) {
+            state = std::move(exit);
+            break;
+        }
+        entry = std::move(next);
+    }
+}
+
+void TypeInference::inferFunction(const std::shared_ptr<Function>& function) {
+    State enclosing = std::move(state);
+
+    // Nothing is known about the arguments
+    state = State();
+    for (const auto& param : function->params) {
+        define(&param, ANY);
+    }
+    execute(function->body);
+
+    state = std::move(enclosing);
+}
+
+const TypeInference::Slot* TypeInference::tracked(const Expr* expr) const {
+    auto it = closures.references.find(expr);
+    if (it == closures.references.end() || it->second->captured) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void TypeInference::refine(const std::shared_ptr<Expr>& operand, const std::shared_ptr<Expr>& later) {
+    if (auto grouping = std::dynamic_pointer_cast<Grouping>(operand)) {
+        refine(grouping->expression, later);
+        return;
+    }
+
+    const Slot* slot = tracked(operand.get());
+    if (slot != nullptr && std::dynamic_pointer_cast<Variable>(operand) && (later == nullptr || !assigns(later, slot))) {
+        state.variables[slot] = NUMBER;
+    }
+}
+
+void TypeInference::define(const void* declaration, Types types) {
+    auto it = closures.declarations.find(declaration);
+    if (it != closures.declarations.end() && !it->second->captured) {
+        state.variables[it->second] = types;
+    }
+}
+
+TypeInference::State TypeInference::join(const State& a, const State& b) {
+    if (!a.reachable) {
+        return b;
+    }
+    if (!b.reachable) {
+        return a;
+    }
+
+    // Variables missing from either side went out of scope there
+    State result;
+    for (const auto& [slot, types] : a.variables) {
+        auto it = b.variables.find(slot);
+        if (it != b.variables.end()) {
+            result.variables[slot] = types | it->second;
+        }
+    }
+    return result;
+}
+
+bool TypeInference::assigns(const std::shared_ptr<Expr>& expr, const Slot* slot) const {
+    if (auto assign = std::dynamic_pointer_cast<Assign>(expr)) {
+        return tracked(assign.get()) == slot || assigns(assign->value, slot);
+    }
+    else if (auto binary = std::dynamic_pointer_cast<Binary>(expr)) {
+        return assigns(binary->left, slot) || assigns(binary->right, slot);
+    }
+    else if (auto call = std::dynamic_pointer_cast<Call>(expr)) {
+        if (assigns(call->callee, slot)) {
+            return true;
+        }
+        for (const auto& arg : call->arguments) {
+            if (assigns(arg, slot)) {
+                return true;
+            }
+        }
+    }
+    else if (auto get = std::dynamic_pointer_cast<Get>(expr)) {
+        return assigns(get->object, slot);
+    }
+    else if (auto grouping = std::dynamic_pointer_cast<Grouping>(expr)) {
+        return assigns(grouping->expression, slot);
+    }
+    else if (auto logical = std::dynamic_pointer_cast<Logical>(expr)) {
+        return assigns(logical->left, slot) || assigns(logical->right, slot);
+    }
+    else if (auto set = std::dynamic_pointer_cast<Set>(expr)) {
+        return assigns(set->object, slot) || assigns(set->value, slot);
+    }
+    else if (auto unary = std::dynamic_pointer_cast<Unary>(expr)) {
+        return assigns(unary->right, slot);
+    }
+    return false;
+}
+
+StaticType TypeInference::toStaticType(Types types) {
+    switch (types) {
+        case NUMBER:
+            return StaticType::NUMBER;
+        case STRING:
+            return StaticType::STRING;
+        case BOOL:
+            return StaticType::BOOL;
+        case NIL:
+            return StaticType::NIL;
+    }
+    return StaticType::UNKNOWN;
+}
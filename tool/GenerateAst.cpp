@@ -1,5 +1,6 @@
 #include <fstream>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -14,13 +15,18 @@ void defineAst(const std::string&, const std::string&, const std::vector<std::st
 /**
  * @brief Writes a class of a given type.
  */
-void defineType(std::ofstream&, std::string_view, std::string_view, std::string_view);
+void defineType(std::ofstream&, std::string_view, std::string_view, std::string_view, std::string_view);
 
 /**
- * @brief Write the visitor class.
+ * @brief Write the node kinds and the visitor class.
  */
 void defineVisitor(std::ofstream&, std::string_view, const std::vector<std::string_view>&);
 
+/**
+ * @brief Write accept, which dispatches on the kind of node.
+ */
+void defineAccept(std::ofstream&, std::string_view, const std::vector<std::string_view>&);
+
 int main(int argc, char* argv[]) {
     if (argc != 2) {
         std::cerr << "Usage: generate_ast <output_directory>" << std::endl;
@@ -33,13 +39,13 @@ int main(int argc, char* argv[]) {
     std::vector<std::string_view> exprTypes{
         "Assign   : Token name, Expr* value",
         "Binary   : Expr* left, Token oper, Expr* right",
-        "Call     : Expr* callee, Token paren, vector<Expr*> arguments",
-        "Get      : Expr* object, Token name",
+        "Call     : Expr* callee, Token paren, vector<Expr*> arguments : InlineSite* inlined",
+        "Get      : Expr* object, Token name : ScalarAccess* scalar, PropertyCache* cache",
         "Grouping : Expr* expression",
         "Literal  : Object value",
         "Logical  : Expr* left, Token oper, Expr* right",
-        "Set      : Expr* object, Token name, Expr* value",
-        "Super    : Token keyword, Token method",
+        "Set      : Expr* object, Token name, Expr* value : ScalarAccess* scalar, PropertyCache* cache",
+        "Super    : Token keyword, Token method : SuperSite* site",
         "This     : Token keyword",
         "Unary    : Token oper, Expr* right",
         "Variable : Token name",
@@ -49,13 +55,15 @@ int main(int argc, char* argv[]) {
     // Generate statement code
     std::vector<std::string_view> stmtTypes{
         "Block      : vector<Stmt*> statements",
-        "Class      : Token name, Variable* superclass, vector<Function*> methods",
+        "Class      : Token name, Variable* superclass, vector<Function*> methods : SuperMethods* superMethods",
         "Expression : Expr* expression",
+        "For        : Stmt* initializer, Expr* condition, Expr* increment, Stmt* body : LoopPlan* plan",
         "Function   : Token name, vector<Token> params, vector<Stmt*> body",
         "If         : Expr* condition, Stmt* thenBranch, Stmt* elseBranch",
+        "Import     : Token keyword, Token path",
         "Print      : Expr* expression",
         "Return     : Token keyword, Expr* value",
-        "Var        : Token name, Expr* initializer",
+        "Var        : Token name, Expr* initializer : ScalarSite* scalar",
         "While      : Expr* condition, Stmt* body",
     };
     std::vector<std::string_view> stmtIncludes{
@@ -135,6 +143,7 @@ void defineAst(const std::string& outputDir, const std::string& baseName, const
     // Includes
     writer << "#include <any>\n"
               "#include <memory>\n"
+              "#include <utility>\n"
               "#include <vector>\n"
               "#include \"../include/Token.hpp\"\n";
     for (std::string_view incl : extraIncludes) {
@@ -147,42 +156,100 @@ void defineAst(const std::string& outputDir, const std::string& baseName, const
         std::string_view className = trim(split(type, ":")[0]);
         writer << "class " << className << ";\n";
     }
+    // Types of annotations, which are declared elsewhere
+    std::set<std::string_view> annotationTypes;
+    for (std::string_view type : types) {
+        auto parts = split(type, ":");
+        if (parts.size() > 2) {
+            for (auto field : split(trim(parts[2]), ", ")) {
+                std::string_view typeName = split(field, " ")[0];
+                typeName = typeName.substr(0, typeName.find('*'));
+                if (annotationTypes.insert(typeName).second) {
+                    writer << "struct " << typeName << ";\n";
+                }
+            }
+        }
+    }
     writer << '\n';
 
-    // Visitor class
+    // Node kinds and visitor class
     defineVisitor(writer, baseName, types);
 
+    // Static types inferred for expressions
+    if (baseName == "Expr") {
+        writer << "/// @brief The type every value of an expression is proven to have, or UNKNOWN.\n";
+        writer << "enum class StaticType { UNKNOWN, NUMBER, STRING, BOOL, NIL };\n\n";
+    }
+
     // Base class
     writer << "class " << baseName << " {\n";
     writer << "\tpublic:\n";
-    writer << "\t virtual std::any accept(" << baseName << "Visitor& visitor) = 0;\n};\n\n";
+    writer << "\tvirtual ~" << baseName << "() = default;\n\n";
+    writer << "\t/// @brief Calls the visit method of the given visitor for this node's kind, returning its result.\n";
+    writer << "\ttemplate <typename Visitor>\n";
+    writer << "\ttypename Visitor::" << baseName << "Result accept(Visitor& visitor);\n\n";
+    writer << "\tconst " << baseName << "Kind kind;\n";
+    if (baseName == "Expr") {
+        writer << "\n\t// Set by TypeInference before the expression is first evaluated\n";
+        writer << "\tStaticType type = StaticType::UNKNOWN;\n";
+    }
+    writer << "\n\tprotected:\n";
+    writer << "\texplicit " << baseName << "(" << baseName << "Kind kind) : kind(kind) {}\n";
+    writer << "};\n\n";
 
     // Derived classes
     for (auto type : types) {
         std::string_view className = trim(split(type, ":")[0]);
-        std::string_view fields = trim(split(type, ":")[1]);
-        defineType(writer, baseName, className, fields);
+        auto parts = split(type, ":");
+        std::string_view fields = trim(parts[1]);
+        std::string_view annotations = parts.size() > 2 ? trim(parts[2]) : std::string_view();
+        defineType(writer, baseName, className, fields, annotations);
     }
 
+    // Dispatch, once every derived class is complete
+    defineAccept(writer, baseName, types);
+
     writer << "#endif" << std::endl;
 }
 
 void defineVisitor(std::ofstream& writer, std::string_view baseName, const std::vector<std::string_view>& types) {
+    // Node kinds
+    writer << "/// @brief The class of a node, which visits dispatch on.\n";
+    writer << "enum class " << baseName << "Kind {";
+    for (size_t i = 0; i < types.size(); ++i) {
+        writer << (i == 0 ? " " : ", ") << toUpper(trim(split(types[i], ":")[0]));
+    }
+    writer << " };\n\n";
+
+    // Visitor base class
+    writer << "/**\n";
+    writer << " * @brief Base of visitors whose visit methods, visit<Kind>" << baseName << " for each kind of node, all return R.\n";
+    writer << " *\n";
+    writer << " * Nodes dispatch on their kind rather than through virtual calls, and return the result without boxing it.\n";
+    writer << " */\n";
+    writer << "template <typename R>\n";
     writer << "struct " << baseName << "Visitor {\n";
+    writer << "\tusing " << baseName << "Result = R;\n";
+    writer << "};\n\n";
+}
 
+void defineAccept(std::ofstream& writer, std::string_view baseName, const std::vector<std::string_view>& types) {
+    writer << "template <typename Visitor>\n";
+    writer << "typename Visitor::" << baseName << "Result " << baseName << "::accept(Visitor& visitor) {\n";
+    writer << "\tswitch (kind) {\n";
     for (auto type : types) {
-        auto typeName = trim(split(type, ":")[0]);
-        writer << "\tvirtual std::any visit" << typeName << baseName << "(std::shared_ptr<" << typeName << "> "
-               << toLower(baseName) << ") = 0;\n";
+        std::string_view className = trim(split(type, ":")[0]);
+        writer << "\t\tcase " << baseName << "Kind::" << toUpper(className) << ":\n";
+        writer << "\t\t\treturn visitor.visit" << className << baseName << "(static_cast<" << className
+               << "*>(this)->shared_from_this());\n";
     }
-
-    // Virtual destructor
-    writer << "\tvirtual ~" << baseName << "Visitor() = default;\n";
-
-    writer << "};\n\n";
+    writer << "\t}\n";
+    writer << "\tstd::unreachable();\n";
+    writer << "}\n\n";
 }
 
-void defineType(std::ofstream& writer, std::string_view baseName, std::string_view className, std::string_view fieldList) {
+void defineType(std::ofstream& writer, std::string_view baseName, std::string_view className, std::string_view fieldList,
+                std::string_view annotationList) {
     writer << "class " << className << " : public " << baseName << ", public std::enable_shared_from_this<" << className << "> {\n";
 
     writer << "\tpublic:\n";
@@ -198,20 +265,14 @@ void defineType(std::ofstream& writer, std::string_view baseName, std::string_vi
     }
     writer << ") : ";
 
-    // Member initializer list
-    std::string_view name = split(fields[0], " ")[1];
-    writer << name << "(" << name << ")";
-    for (size_t i = 1; i < fields.size(); ++i) {
-        name = split(fields[i], " ")[1];
+    // Member initializer list, after the base class with the node's kind
+    writer << baseName << "(" << baseName << "Kind::" << toUpper(className) << ")";
+    for (size_t i = 0; i < fields.size(); ++i) {
+        std::string_view name = split(fields[i], " ")[1];
         writer << ", " << name << "(" << name << ")";
     }
     writer << "{}" << "\n\n";
 
-    // Visitor pattern implementation
-    writer << "\tstd::any accept(" << baseName << "Visitor& visitor) override {\n";
-    writer << "\t\treturn visitor.visit" << className << baseName << "(shared_from_this());\n";
-    writer << "\t}\n\n";
-
     // writer << "\tprivate:\n";
 
     // Fields
@@ -219,5 +280,13 @@ void defineType(std::ofstream& writer, std::string_view baseName, std::string_vi
         writer << "\tconst " << fixType(field) << ";\n";
     }
 
+    // Annotations, which aren't constructor parameters and stay mutable
+    if (!annotationList.empty()) {
+        writer << "\n\t// Filled in by optimization passes\n";
+        for (auto annotation : split(annotationList, ", ")) {
+            writer << "\t" << fixType(annotation) << ";\n";
+        }
+    }
+
     writer << "};\n\n";
 }